@@ -36,6 +36,7 @@ namespace {
 // Load account information from a data file (saved game or starting conditions).
 void Account::Load(const DataNode &node, bool clearFirst)
 {
+	epoch.Bump();
 	if(clearFirst)
 	{
 		credits = 0;
@@ -127,6 +128,7 @@ int64_t Account::Credits() const
 // the calling function needs to check that this will not result in negative credits.
 void Account::AddCredits(int64_t value)
 {
+	epoch.Bump();
 	credits += value;
 }
 
@@ -135,6 +137,7 @@ void Account::AddCredits(int64_t value)
 // Pay down extra principal on a mortgage.
 void Account::PayExtra(int mortgage, int64_t amount)
 {
+	epoch.Bump();
 	if(static_cast<unsigned>(mortgage) >= mortgages.size() || amount > credits
 			|| amount > mortgages[mortgage].Principal())
 		return;
@@ -153,6 +156,7 @@ void Account::PayExtra(int mortgage, int64_t amount)
 // Step forward one day, and return a string summarizing payments made.
 string Account::Step(int64_t assets, int64_t salaries, int64_t maintenance)
 {
+	epoch.Bump();
 	ostringstream out;
 
 	// Keep track of what payments were made and whether any could not be made.
@@ -329,6 +333,7 @@ int64_t Account::SalariesIncomeTotal() const
 
 void Account::SetSalaryIncome(const string &name, int64_t amount)
 {
+	epoch.Bump();
 	if(amount == 0)
 		salariesIncome.erase(name);
 	else
@@ -346,6 +351,7 @@ int64_t Account::CrewSalariesOwed() const
 
 void Account::PaySalaries(int64_t amount)
 {
+	epoch.Bump();
 	amount = min(min(amount, crewSalariesOwed), credits);
 	credits -= amount;
 	crewSalariesOwed -= amount;
@@ -362,6 +368,7 @@ int64_t Account::MaintenanceDue() const
 
 void Account::PayMaintenance(int64_t amount)
 {
+	epoch.Bump();
 	amount = min(min(amount, maintenanceDue), credits);
 	credits -= amount;
 	maintenanceDue -= amount;
@@ -381,6 +388,7 @@ const vector<Mortgage> &Account::Mortgages() const
 // your credit score.
 void Account::AddMortgage(int64_t principal)
 {
+	epoch.Bump();
 	mortgages.emplace_back("Mortgage", principal, creditScore);
 	credits += principal;
 }
@@ -390,6 +398,7 @@ void Account::AddMortgage(int64_t principal)
 // Add a "fine" with a high, fixed interest rate and a short term.
 void Account::AddFine(int64_t amount)
 {
+	epoch.Bump();
 	mortgages.emplace_back("Fine", amount, 0, 60);
 }
 
@@ -399,6 +408,7 @@ void Account::AddFine(int64_t amount)
 // given then the player's credit score is used to determine the interest rate.
 void Account::AddDebt(int64_t amount, optional<double> interest, int term)
 {
+	epoch.Bump();
 	if(interest)
 		mortgages.emplace_back("Debt", amount, *interest, term);
 	else
@@ -428,6 +438,14 @@ int64_t Account::Prequalify() const
 
 
 
+// Get a number that changes whenever anything in this account does.
+uint64_t Account::Epoch() const
+{
+	return epoch.Value();
+}
+
+
+
 // Get the player's total net worth (counting all ships and all debts).
 int64_t Account::NetWorth() const
 {
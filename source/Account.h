@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef ACCOUNT_H_
 #define ACCOUNT_H_
 
+#include "EpochCounter.h"
 #include "Mortgage.h"
 
 #include <cstdint>
@@ -72,6 +73,10 @@ public:
 	// mortgages if a blank string is provided.
 	int64_t TotalDebt(const std::string &type = "") const;
 
+	// Get a number that changes whenever anything in this account does, for
+	// caching values computed from it.
+	uint64_t Epoch() const;
+
 
 private:
 	int64_t YearlyRevenue() const;
@@ -93,6 +98,8 @@ private:
 	// History of the player's net worth. This is used to calculate your average
 	// daily income, which is used to calculate how big a mortgage you can afford.
 	std::vector<int64_t> history;
+
+	EpochCounter epoch;
 };
 
 
@@ -0,0 +1,179 @@
+/* AllocationCounter.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+using namespace std;
+
+namespace {
+	thread_local uint64_t count = 0;
+	// The index of the tag the calling thread's allocations are given.
+	thread_local int current = 0;
+
+	// The tags are kept in fixed arrays, because nothing here may allocate.
+	// Once the arrays are full, any new tags are counted as untagged.
+	const int MAX_TAGS = 64;
+	const char *names[MAX_TAGS] = {"untagged"};
+	atomic<uint64_t> counts[MAX_TAGS];
+	atomic<uint64_t> bytes[MAX_TAGS];
+	// Names are only added while holding the mutex, and each one is written
+	// before the number of tags in use is increased to include it.
+	atomic<int> used = 1;
+	mutex namesMutex;
+
+	// Find the index of the given tag, or -1 if it has not been used.
+	int Find(const char *tag)
+	{
+		const int size = used.load(memory_order_acquire);
+		for(int i = 0; i < size; ++i)
+			if(names[i] == tag || !strcmp(names[i], tag))
+				return i;
+		return -1;
+	}
+
+	// Find the index of the given tag, adding it if it has not been used.
+	int Add(const char *tag)
+	{
+		int index = Find(tag);
+		if(index >= 0)
+			return index;
+
+		lock_guard<mutex> lock(namesMutex);
+		// Another thread may have added the tag before this one got the lock.
+		index = Find(tag);
+		if(index >= 0)
+			return index;
+
+		index = used.load(memory_order_relaxed);
+		if(index == MAX_TAGS)
+			return 0;
+		names[index] = tag;
+		used.store(index + 1, memory_order_release);
+		return index;
+	}
+
+	AllocationCounter::Tally MakeTally(int index)
+	{
+		AllocationCounter::Tally tally;
+		tally.tag = names[index];
+		tally.count = counts[index].load(memory_order_relaxed);
+		tally.bytes = bytes[index].load(memory_order_relaxed);
+		return tally;
+	}
+}
+
+
+
+AllocationCounter::Scope::Scope(const char *tag)
+	: previous(current)
+{
+	Set(tag);
+}
+
+
+
+AllocationCounter::Scope::~Scope()
+{
+	current = previous;
+}
+
+
+
+// Attribute the following allocations to a different tag, for marking
+// out the phases of a single function.
+void AllocationCounter::Scope::Set(const char *tag)
+{
+	if(IsEnabled())
+		current = Add(tag);
+}
+
+
+
+// Check whether allocations are being counted in this build.
+bool AllocationCounter::IsEnabled()
+{
+#ifdef NDEBUG
+	return false;
+#else
+	return true;
+#endif
+}
+
+
+
+// Get the number of allocations the calling thread has made so far.
+uint64_t AllocationCounter::Count()
+{
+	return count;
+}
+
+
+
+// Get the totals for the given tag.
+AllocationCounter::Tally AllocationCounter::Get(const char *tag)
+{
+	const int index = Find(tag);
+	if(index >= 0)
+		return MakeTally(index);
+
+	Tally tally;
+	tally.tag = tag;
+	return tally;
+}
+
+
+
+// Get the totals for every tag that has been used so far, in the order they
+// were first used.
+vector<AllocationCounter::Tally> AllocationCounter::Tallies()
+{
+	const int size = used.load(memory_order_acquire);
+	vector<Tally> result;
+	result.reserve(size);
+	for(int i = 0; i < size; ++i)
+		result.push_back(MakeTally(i));
+	return result;
+}
+
+
+
+#ifndef NDEBUG
+// Replace the global allocation functions. The array and non-throwing forms of
+// operator new and delete are implemented by the standard library in terms of
+// these. Over-aligned allocations are rare enough that they are not counted.
+void *operator new(size_t size)
+{
+	++count;
+	counts[current].fetch_add(1, memory_order_relaxed);
+	bytes[current].fetch_add(size, memory_order_relaxed);
+	// Allocating zero bytes must still return a unique pointer.
+	if(void *result = malloc(size ? size : 1))
+		return result;
+	throw bad_alloc();
+}
+
+
+
+void operator delete(void *pointer) noexcept
+{
+	free(pointer);
+}
+#endif
@@ -0,0 +1,78 @@
+/* AllocationCounter.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ALLOCATION_COUNTER_H_
+#define ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+#include <vector>
+
+
+
+// Counts heap allocations, so that code that is meant to reuse its memory from
+// one frame to the next can be checked to really do so. Counting requires
+// replacing the global operator new, so it is only done in debug builds. In
+// release builds, the count is always zero.
+//
+// Allocations are also tallied by tag, so the ones made in each part of a frame
+// or of loading can be told apart. A thread's allocations are given the tag of
+// the innermost Scope it is in, or "untagged" outside of any scope; threads do
+// not inherit the tags of the thread that gave them their work.
+class AllocationCounter {
+public:
+	// The number of allocations made with a tag, and how many bytes were
+	// requested in them, across all threads. Memory that is freed again is not
+	// subtracted, since it is the churn that is being measured.
+	class Tally {
+	public:
+		const char *tag = nullptr;
+		uint64_t count = 0;
+		uint64_t bytes = 0;
+	};
+
+	// Attributes the allocations the thread that creates it makes to the given
+	// tag until it is destroyed. The tag must be a string literal or otherwise
+	// outlive the program, because it is kept rather than copied.
+	class Scope {
+	public:
+		explicit Scope(const char *tag);
+		~Scope();
+		Scope(const Scope &) = delete;
+		Scope &operator=(const Scope &) = delete;
+
+		// Attribute the following allocations to a different tag, for marking
+		// out the phases of a single function.
+		void Set(const char *tag);
+
+
+	private:
+		int previous;
+	};
+
+
+public:
+	// Check whether allocations are being counted in this build.
+	static bool IsEnabled();
+	// Get the number of allocations the calling thread has made so far.
+	static uint64_t Count();
+	// Get the totals for the given tag, or for every tag that has been used so
+	// far, in the order they were first used.
+	static Tally Get(const char *tag);
+	static std::vector<Tally> Tallies();
+};
+
+
+
+#endif
@@ -0,0 +1,95 @@
+/* AssetHandle.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AssetHandle.h"
+
+#include "Audio.h"
+#include "Effect.h"
+#include "GameData.h"
+#include "Sound.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+template <class Type>
+AssetHandle<Type>::AssetHandle(const char *name)
+	: name(name)
+{
+	Handles().push_back(this);
+}
+
+
+
+template <class Type>
+AssetHandle<Type>::~AssetHandle()
+{
+	vector<const AssetHandle *> &handles = Handles();
+	handles.erase(find(handles.begin(), handles.end(), this));
+}
+
+
+
+// Look up the asset of every handle of this type. This must be done after
+// the game data has finished loading, and before any handle is used.
+template <class Type>
+void AssetHandle<Type>::BindAll()
+{
+	for(const AssetHandle *handle : Handles())
+		handle->asset = Find(handle->name);
+}
+
+
+
+template <class Type>
+const string &AssetHandle<Type>::Name() const
+{
+	return name;
+}
+
+
+
+// Get every handle of this type that has been constructed.
+template <class Type>
+vector<const AssetHandle<Type> *> &AssetHandle<Type>::Handles()
+{
+	// Handles are constructed during static initialization, so this list must
+	// be created the first time it is needed rather than along with them.
+	static vector<const AssetHandle *> handles;
+	return handles;
+}
+
+
+
+template <>
+const Effect *AssetHandle<Effect>::Find(const string &name)
+{
+	return GameData::Effects().Get(name);
+}
+
+
+
+template <>
+const Sound *AssetHandle<Sound>::Find(const string &name)
+{
+	return Audio::Get(name);
+}
+
+
+
+template class AssetHandle<Effect>;
+template class AssetHandle<Sound>;
@@ -0,0 +1,72 @@
+/* AssetHandle.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ASSET_HANDLE_H_
+#define ASSET_HANDLE_H_
+
+#include <string>
+#include <vector>
+
+
+
+// A handle to one of the assets (effects, sounds, etc.) that the engine refers
+// to by name in code that runs every frame. Looking an asset up by name means
+// searching a map (and, for sounds, taking a lock) every time, so instead each
+// such asset gets a handle, declared once as a constant next to the code that
+// uses it. Every handle is bound to its asset once the game data has finished
+// loading, and after that, using a handle is just following a pointer.
+//
+// Handles must only be declared at namespace scope. Each one registers itself
+// in a list of every handle when it is constructed, so they cannot be copied
+// or moved.
+template <class Type>
+class AssetHandle {
+public:
+	explicit AssetHandle(const char *name);
+	~AssetHandle();
+	AssetHandle(const AssetHandle &) = delete;
+	AssetHandle &operator=(const AssetHandle &) = delete;
+
+	// Look up the asset of every handle of this type. This must be done after
+	// the game data has finished loading, and before any handle is used.
+	static void BindAll();
+
+	const Type *Get() const;
+	const std::string &Name() const;
+
+
+private:
+	// Get every handle of this type that has been constructed.
+	static std::vector<const AssetHandle *> &Handles();
+	// Look up the asset with the given name.
+	static const Type *Find(const std::string &name);
+
+
+private:
+	std::string name;
+	mutable const Type *asset = nullptr;
+};
+
+
+
+template <class Type>
+inline const Type *AssetHandle<Type>::Get() const
+{
+	return asset;
+}
+
+
+
+#endif
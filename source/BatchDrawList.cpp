@@ -15,24 +15,27 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "BatchDrawList.h"
 
+#include "Angle.h"
 #include "BatchShader.h"
 #include "Body.h"
 #include "Screen.h"
 #include "Sprite.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 
 using namespace std;
 
 namespace {
-	void Push(vector<float> &v, const Point &pos, float s, float t, float frame, float alpha)
+	// The smallest size of the sprite hash table. It is always a power of two.
+	const size_t MIN_TABLE_SIZE = 256;
+
+	size_t Hash(const Sprite *sprite)
 	{
-		v.push_back(pos.X());
-		v.push_back(pos.Y());
-		v.push_back(s);
-		v.push_back(t);
-		v.push_back(frame);
-		v.push_back(alpha);
+		uint64_t key = reinterpret_cast<uintptr_t>(sprite);
+		key *= 0x9E3779B97F4A7C15ull;
+		return key ^ (key >> 32);
 	}
 }
 
@@ -41,7 +44,11 @@ namespace {
 // Clear the list, also setting the global time step for animation.
 void BatchDrawList::Clear(int step, double zoom)
 {
-	data.clear();
+	instances.clear();
+	buckets.clear();
+	sprites.clear();
+	counts.clear();
+	fill(table.begin(), table.end(), make_pair(nullptr, 0));
 	this->step = step;
 	this->zoom = zoom;
 	isHighDPI = (Screen::IsHighResolution() ? zoom > .5 : zoom > 1.);
@@ -69,7 +76,7 @@ bool BatchDrawList::Add(const Body &body, float clip)
 	// we want it to be drawn with its center halfway to the target. For longer-lived projectiles, we
 	// expect the position to be the actual location of the projectile at that point in time.
 	Point position = (body.Position() + .5 * body.Velocity() - center) * zoom;
-	return Add(body, position, clip);
+	return Add(body, position, body.Unit(), [&body, this] { return body.GetFrame(step); }, clip);
 }
 
 
@@ -77,7 +84,17 @@ bool BatchDrawList::Add(const Body &body, float clip)
 // TODO: Once we have sprite reference positions, this method will not be needed.
 bool BatchDrawList::AddVisual(const Body &visual)
 {
-	return Add(visual, (visual.Position() - center) * zoom, 1.f);
+	return Add(visual, (visual.Position() - center) * zoom, visual.Unit(),
+		[&visual, this] { return visual.GetFrame(step); }, 1.f);
+}
+
+
+
+// Add a particle, which is drawn with the sprite of the given body but has
+// its own position, facing, and animation frame.
+bool BatchDrawList::AddParticle(const Body &body, const Point &position, const Angle &facing, float frame)
+{
+	return Add(body, (position - center) * zoom, facing.Unit() * (.5 * body.Zoom()), [frame] { return frame; }, 1.f);
 }
 
 
@@ -85,22 +102,42 @@ bool BatchDrawList::AddVisual(const Body &visual)
 // Draw all the items in this list.
 void BatchDrawList::Draw() const
 {
+	if(instances.empty())
+		return;
+
+	// Find where each sprite's instances begin in the sorted array, then
+	// place each instance after the ones before it that use the same sprite.
+	offsets.resize(counts.size());
+	uint32_t total = 0;
+	for(size_t i = 0; i < counts.size(); ++i)
+	{
+		offsets[i] = total;
+		total += counts[i];
+	}
+	sorted.resize(instances.size());
+	for(size_t i = 0; i < instances.size(); ++i)
+		sorted[offsets[buckets[i]]++] = instances[i];
+
 	BatchShader::Bind();
+	BatchShader::Upload(sorted);
 
-	for(const pair<const Sprite * const, vector<float>> &it : data)
-		BatchShader::Add(it.first, isHighDPI, it.second);
+	size_t first = 0;
+	for(size_t i = 0; i < sprites.size(); ++i)
+	{
+		BatchShader::Add(sprites[i], isHighDPI, first, counts[i]);
+		first += counts[i];
+	}
 
 	BatchShader::Unbind();
 }
 
 
 
-bool BatchDrawList::Cull(const Body &body, const Point &position) const
+bool BatchDrawList::Cull(const Body &body, const Point &position, const Point &unit) const
 {
 	if(!body.HasSprite() || !body.Zoom())
 		return true;
 
-	Point unit = body.Unit();
 	// Cull sprites that are completely off screen, to reduce the number of draw
 	// calls that we issue (which may be the bottleneck on some systems).
 	Point size(
@@ -118,42 +155,57 @@ bool BatchDrawList::Cull(const Body &body, const Point &position) const
 
 
 
-bool BatchDrawList::Add(const Body &body, Point position, float clip)
+template <class GetFrame>
+bool BatchDrawList::Add(const Body &body, const Point &position, Point unit, GetFrame frame, float clip)
 {
-	if(Cull(body, position))
+	if(Cull(body, position, unit))
 		return false;
 
-	// Get the data vector for this particular sprite.
-	vector<float> &v = data[body.GetSprite()];
-	// The sprite frame is the same for every vertex.
-	float frame = body.GetFrame(step);
-
-	// Get unit vectors in the direction of the object's width and height.
-	Point unit = body.Unit() * zoom;
-	Point uw = Point(-unit.Y(), unit.X()) * body.Width();
-	Point uh = unit * body.Height();
-
-	// Get the "bottom" corner, the one that won't be clipped.
-	Point topLeft = position - (uw + uh);
-	// Scale the vectors and apply clipping to the "height" of the sprite.
-	uw *= 2.;
-	uh *= 2.f * clip;
-
-	// Calculate the other three corners.
-	Point topRight = topLeft + uw;
-	Point bottomLeft = topLeft + uh;
-	Point bottomRight = bottomLeft + uw;
-
-	float alpha = body.Alpha();
-
-	// Push two copies of the first and last vertices to mark the break between
-	// the sprites.
-	Push(v, topLeft, 0.f, 1.f, frame, alpha);
-	Push(v, topLeft, 0.f, 1.f, frame, alpha);
-	Push(v, topRight, 1.f, 1.f, frame, alpha);
-	Push(v, bottomLeft, 0.f, 1.f - clip, frame, alpha);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha);
-	Push(v, bottomRight, 1.f, 1.f - clip, frame, alpha);
+	// Scale the unit vector in the direction the object is facing to the
+	// zoom. The shader finds the corners of the sprite from this.
+	unit *= zoom;
+
+	instances.push_back({
+		{static_cast<float>(position.X()), static_cast<float>(position.Y())},
+		{static_cast<float>(unit.X()), static_cast<float>(unit.Y())},
+		{static_cast<float>(body.Width()), static_cast<float>(body.Height())},
+		frame(), clip, static_cast<float>(body.Alpha())});
+	const uint32_t bucket = Bucket(body.GetSprite());
+	buckets.push_back(bucket);
+	++counts[bucket];
 
 	return true;
 }
+
+
+
+// Get the index of the given sprite in the list of sprites, adding it if this
+// is the first instance of it.
+uint32_t BatchDrawList::Bucket(const Sprite *sprite)
+{
+	// Keep the table at most half full so that probe sequences stay short.
+	if(2 * (sprites.size() + 1) > table.size())
+	{
+		table.assign(max(MIN_TABLE_SIZE, 2 * table.size()), make_pair(nullptr, 0));
+		const size_t mask = table.size() - 1;
+		for(uint32_t i = 0; i < sprites.size(); ++i)
+		{
+			size_t slot = Hash(sprites[i]) & mask;
+			while(table[slot].first)
+				slot = (slot + 1) & mask;
+			table[slot] = make_pair(sprites[i], i);
+		}
+	}
+
+	const size_t mask = table.size() - 1;
+	size_t slot = Hash(sprite) & mask;
+	for( ; table[slot].first; slot = (slot + 1) & mask)
+		if(table[slot].first == sprite)
+			return table[slot].second;
+
+	const uint32_t bucket = sprites.size();
+	table[slot] = make_pair(sprite, bucket);
+	sprites.push_back(sprite);
+	counts.push_back(0);
+	return bucket;
+}
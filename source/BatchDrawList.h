@@ -16,11 +16,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef BATCH_DRAW_LIST_H_
 #define BATCH_DRAW_LIST_H_
 
+#include "BatchShader.h"
 #include "Point.h"
 
-#include <map>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
+class Angle;
 class Body;
 class Sprite;
 
@@ -28,6 +31,9 @@ class Sprite;
 
 // This class collects a set of OpenGL draw commands to issue and groups them by
 // sprite, so all instances of each sprite can be drawn with a single command.
+// Everything is kept in flat arrays that are reused from one frame to the next,
+// so once they have grown large enough, filling and drawing the list does not
+// allocate any memory.
 class BatchDrawList {
 public:
 	// Clear the list, also setting the global time step for animation.
@@ -37,6 +43,9 @@ public:
 	// Add an unswizzled object based on the Body class.
 	bool Add(const Body &body, float clip = 1.f);
 	bool AddVisual(const Body &visual);
+	// Add a particle, which is drawn with the sprite of the given body but has
+	// its own position, facing, and animation frame.
+	bool AddParticle(const Body &body, const Point &position, const Angle &facing, float frame);
 
 	// Draw all the items in this list.
 	void Draw() const;
@@ -44,10 +53,15 @@ public:
 
 private:
 	// Determine if the given body should be drawn at all.
-	bool Cull(const Body &body, const Point &position) const;
+	bool Cull(const Body &body, const Point &position, const Point &unit) const;
 
-	// Add the given body at the given position.
-	bool Add(const Body &body, Point position, float clip);
+	// Add the given body at the given position, facing, and frame, if it is
+	// not culled. The frame is only looked up once it is known to be drawn.
+	template <class GetFrame>
+	bool Add(const Body &body, const Point &position, Point unit, GetFrame frame, float clip);
+	// Get the index of the given sprite in the list of sprites, adding it if
+	// this is the first instance of it.
+	uint32_t Bucket(const Sprite *sprite);
 
 
 private:
@@ -56,11 +70,21 @@ private:
 	bool isHighDPI = false;
 	Point center;
 
-	// Each sprite consists of six vertices (four vertices to form a quad and
-	// two dummy vertices to mark the break in between them). Each of those
-	// vertices has six attributes: (x, y) position in pixels, (s, t) texture
-	// coordinates, the index of the sprite frame, and the alpha value.
-	std::map<const Sprite *, std::vector<float>> data;
+	// Every instance, in the order they were added, and the index of the
+	// sprite each one uses.
+	std::vector<BatchShader::Instance> instances;
+	std::vector<uint32_t> buckets;
+	// The sprites, in the order they were first added, and how many instances
+	// of each one there are.
+	std::vector<const Sprite *> sprites;
+	std::vector<uint32_t> counts;
+	// A hash table (with linear probing) from each sprite to its index.
+	std::vector<std::pair<const Sprite *, uint32_t>> table;
+
+	// When drawing, the instances are sorted by sprite (using a counting sort,
+	// which keeps the order they were added in) into this array.
+	mutable std::vector<BatchShader::Instance> sorted;
+	mutable std::vector<uint32_t> offsets;
 };
 
 
@@ -19,6 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Shader.h"
 #include "Sprite.h"
 
+#include <cstddef>
+
 using namespace std;
 
 namespace {
@@ -27,12 +29,30 @@ namespace {
 	GLint scaleI;
 	GLint frameCountI;
 	// Vertex data:
-	GLint vertI;
-	GLint texCoordI;
-	GLint alphaI;
+	GLint cornerI;
+	// Instance data:
+	GLint positionI;
+	GLint unitI;
+	GLint sizeI;
+	GLint paramsI;
 
 	GLuint vao;
+	GLuint cornerVbo;
 	GLuint vbo;
+
+	// Point the instance attributes at the instance with the given index in
+	// the instance buffer, which must be bound.
+	void SetInstanceOffset(size_t first)
+	{
+		constexpr auto stride = sizeof(BatchShader::Instance);
+		const size_t base = first * stride;
+		auto offset = [base](size_t member) { return reinterpret_cast<const GLvoid *>(base + member); };
+		glVertexAttribPointer(positionI, 2, GL_FLOAT, GL_FALSE, stride, offset(offsetof(BatchShader::Instance, position)));
+		glVertexAttribPointer(unitI, 2, GL_FLOAT, GL_FALSE, stride, offset(offsetof(BatchShader::Instance, unit)));
+		glVertexAttribPointer(sizeI, 2, GL_FLOAT, GL_FALSE, stride, offset(offsetof(BatchShader::Instance, size)));
+		// The frame, clip, and alpha are consecutive, so they are read as one vector.
+		glVertexAttribPointer(paramsI, 3, GL_FLOAT, GL_FALSE, stride, offset(offsetof(BatchShader::Instance, frame)));
+	}
 }
 
 
@@ -43,17 +63,24 @@ void BatchShader::Init()
 	static const char *vertexCode =
 		"// vertex batch shader\n"
 		"uniform vec2 scale;\n"
-		"in vec2 vert;\n"
-		"in vec3 texCoord;\n"
-		"in float alpha;\n"
+		"in vec2 corner;\n"
+		"in vec2 position;\n"
+		"in vec2 unit;\n"
+		"in vec2 size;\n"
+		"in vec3 params;\n"
 
 		"out vec3 fragTexCoord;\n"
 		"out float fragAlpha;\n"
 
 		"void main() {\n"
+		// The "top left" corner is the one that is never clipped.
+		"  float clip = params.y;\n"
+		"  vec2 across = vec2(-unit.y, unit.x) * size.x;\n"
+		"  vec2 along = unit * size.y;\n"
+		"  vec2 vert = position + across * (2. * corner.x - 1.) + along * (2. * corner.y * clip - 1.);\n"
 		"  gl_Position = vec4(vert * scale, 0, 1);\n"
-		"  fragTexCoord = texCoord;\n"
-		"  fragAlpha = alpha;\n"
+		"  fragTexCoord = vec3(corner.x, 1. - corner.y * clip, params.x);\n"
+		"  fragAlpha = params.z;\n"
 		"}\n";
 
 	static const char *fragmentCode =
@@ -85,34 +112,38 @@ void BatchShader::Init()
 	// Get the indices of the uniforms and attributes.
 	scaleI = shader.Uniform("scale");
 	frameCountI = shader.Uniform("frameCount");
-	vertI = shader.Attrib("vert");
-	texCoordI = shader.Attrib("texCoord");
-	alphaI = shader.Attrib("alpha");
+	cornerI = shader.Attrib("corner");
+	positionI = shader.Attrib("position");
+	unitI = shader.Attrib("unit");
+	sizeI = shader.Attrib("size");
+	paramsI = shader.Attrib("params");
 
 	// Make sure we're using texture 0.
 	glUseProgram(shader.Object());
 	glUniform1i(shader.Uniform("tex"), 0);
 	glUseProgram(0);
 
-	// Generate the buffer for uploading the batch vertex data.
+	// Generate the buffers: one with the corners of a quad, drawn as a
+	// triangle strip, and one for uploading the instance data to.
 	glGenVertexArrays(1, &vao);
 	glBindVertexArray(vao);
 
+	glGenBuffers(1, &cornerVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, cornerVbo);
+	static const GLfloat corners[] = {0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 1.f};
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(cornerI);
+	glVertexAttribPointer(cornerI, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+	// Every other attribute advances once per instance instead of per vertex.
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-	// In this VAO, enable the two vertex arrays and specify their byte offsets.
-	constexpr auto stride = 6 * sizeof(float);
-	glEnableVertexAttribArray(vertI);
-	glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, stride, nullptr);
-	// The 3 texture fields (s, t, frame) come after the x,y pixel fields.
-	auto textureOffset = reinterpret_cast<const GLvoid *>(2 * sizeof(float));
-	glEnableVertexAttribArray(texCoordI);
-	glVertexAttribPointer(texCoordI, 3, GL_FLOAT, GL_FALSE, stride, textureOffset);
-	// The alpha value.
-	auto alphaOffset = reinterpret_cast<const GLvoid *>(5 * sizeof(float));
-	glEnableVertexAttribArray(alphaI);
-	glVertexAttribPointer(alphaI, 1, GL_FLOAT, GL_FALSE, stride, alphaOffset);
+	for(GLint attrib : {positionI, unitI, sizeI, paramsI})
+	{
+		glEnableVertexAttribArray(attrib);
+		glVertexAttribDivisor(attrib, 1);
+	}
+	SetInstanceOffset(0);
 
 	// Unbind the buffer and the VAO, but leave the vertex attrib arrays enabled
 	// in the VAO so they will be used when it is bound.
@@ -126,7 +157,7 @@ void BatchShader::Bind()
 {
 	glUseProgram(shader.Object());
 	glBindVertexArray(vao);
-	// Bind the vertex buffer so we can upload data to it.
+	// Bind the instance buffer so we can upload data to it.
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
 	// Set up the screen scale.
@@ -136,10 +167,19 @@ void BatchShader::Bind()
 
 
 
-void BatchShader::Add(const Sprite *sprite, bool isHighDPI, const vector<float> &data)
+// Upload the instances of every sprite that will be drawn.
+void BatchShader::Upload(const vector<Instance> &instances)
+{
+	glBufferData(GL_ARRAY_BUFFER, sizeof(Instance) * instances.size(), instances.data(), GL_STREAM_DRAW);
+}
+
+
+
+// Draw the given range of the uploaded instances, which must all use the given sprite.
+void BatchShader::Add(const Sprite *sprite, bool isHighDPI, size_t first, size_t count)
 {
 	// Do nothing if there are no sprites to draw.
-	if(data.empty())
+	if(!count)
 		return;
 
 	// First, bind the proper texture.
@@ -147,11 +187,9 @@ void BatchShader::Add(const Sprite *sprite, bool isHighDPI, const vector<float>
 	// The shader also needs to know how many frames the texture has.
 	glUniform1f(frameCountI, sprite->Frames());
 
-	// Upload the vertex data.
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
-
-	// Draw all the vertices.
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, data.size() / 6);
+	// Draw a quad for each instance in the range.
+	SetInstanceOffset(first);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count);
 }
 
 
@@ -18,19 +18,38 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 class Sprite;
 
+#include <cstddef>
 #include <vector>
 
 
 
-// Class for drawing sprites in a batch. The input to each draw command is a
-// sprite, whether it should be drawn high DPI, and the vertex data.
+// Class for drawing sprites in a batch. The instances of every sprite to be
+// drawn are uploaded at once, and then each draw command is a sprite, whether
+// it should be drawn high DPI, and the range of instances that use it.
 class BatchShader {
+public:
+	// One copy of a sprite: the position of its center in pixels, the unit
+	// vector it is facing (scaled by the zoom), its half width and height, the
+	// animation frame, how much of its height to draw, and its alpha. The
+	// shader expands each instance into the four corners of a quad.
+	class Instance {
+	public:
+		float position[2];
+		float unit[2];
+		float size[2];
+		float frame;
+		float clip;
+		float alpha;
+	};
+
+
 public:
 	// Initialize the shaders.
 	static void Init();
 
 	static void Bind();
-	static void Add(const Sprite *sprite, bool isHighDPI, const std::vector<float> &data);
+	static void Upload(const std::vector<Instance> &instances);
+	static void Add(const Sprite *sprite, bool isHighDPI, size_t first, size_t count);
 	static void Unbind();
 };
 
@@ -420,7 +420,22 @@ void Body::SetStep(int step) const
 
 	// Figure out what fraction of the way in between frames we are. Avoid any
 	// possible floating-point glitches that might result in a negative frame.
-	frame = max(0.f, frameRate * step + frameOffset);
+	frame = WrapFrame(max(0.f, frameRate * step + frameOffset));
+}
+
+
+
+// Get the frame to show once this body's animation has advanced by the
+// given number of frames, taking repeating and rewinding into account.
+// This must only be called if the sprite has more than one frame.
+float Body::WrapFrame(float frame) const
+{
+	float frames = sprite->Frames();
+	float lastFrame = frames - 1.f;
+	// This is the number of frames per full cycle. If rewinding, a full cycle
+	// includes the first and last frames once and every other frame twice.
+	float cycle = (rewind ? 2.f * lastFrame : frames) + delay;
+
 	// If repeating, wrap the frame index by the total cycle time.
 	if(repeat)
 		frame = fmod(frame, cycle);
@@ -444,4 +459,6 @@ void Body::SetStep(int step) const
 		// be less than 0, clamp it to 0.
 		frame = max(0.f, lastFrame * 2.f - frame);
 	}
+
+	return frame;
 }
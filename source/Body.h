@@ -116,6 +116,10 @@ private:
 	// Set what animation step we're on. This affects future calls to GetMask()
 	// and GetFrame().
 	void SetStep(int step) const;
+	// Get the frame to show once this body's animation has advanced by the
+	// given number of frames, taking repeating and rewinding into account.
+	// This must only be called if the sprite has more than one frame.
+	float WrapFrame(float frame) const;
 
 
 private:
@@ -141,6 +145,10 @@ private:
 	// the same step over and over again.
 	mutable int currentStep = -1;
 	mutable float frame = 0.f;
+
+	// Particles are drawn using the sprite and animation of the Body they were
+	// created from, but keep track of their own frame rates and offsets.
+	friend class ParticleSystem;
 };
 
 
@@ -54,6 +54,7 @@ namespace {
 // Remove any items in this cargo hold.
 void CargoHold::Clear()
 {
+	epoch.Bump();
 	size = 0;
 	bunks = 0;
 	commodities.clear();
@@ -68,6 +69,7 @@ void CargoHold::Clear()
 // GameData is loaded, so that the sizes of any outfits are known.
 void CargoHold::Load(const DataNode &node)
 {
+	epoch.Bump();
 	// Cargo is stored as name / amount pairs in two lists: commodities and outfits.
 	for(const DataNode &child : node)
 	{
@@ -157,6 +159,7 @@ void CargoHold::Save(DataWriter &out) const
 // Set the capacity of this cargo hold.
 void CargoHold::SetSize(int tons)
 {
+	epoch.Bump();
 	size = tons;
 }
 
@@ -278,6 +281,7 @@ bool CargoHold::IsEmpty() const
 // Set the number of free bunks for passengers.
 void CargoHold::SetBunks(int count)
 {
+	epoch.Bump();
 	bunks = count;
 }
 
@@ -373,6 +377,7 @@ const map<const Mission *, int> &CargoHold::PassengerList() const
 // Transfer ordinary commodities from one cargo hold to another.
 int CargoHold::Transfer(const string &commodity, int amount, CargoHold &to)
 {
+	epoch.Bump();
 	if(!amount)
 		return 0;
 
@@ -392,6 +397,7 @@ int CargoHold::Transfer(const string &commodity, int amount, CargoHold &to)
 // Transfer outfits from one cargo hold to another.
 int CargoHold::Transfer(const Outfit *outfit, int amount, CargoHold &to)
 {
+	epoch.Bump();
 	if(!amount)
 		return 0;
 
@@ -429,6 +435,8 @@ int CargoHold::Transfer(const Mission *mission, int amount, CargoHold &to)
 
 	missionCargo[mission] -= amount;
 	to.missionCargo[mission] += amount;
+	epoch.Bump();
+	to.epoch.Bump();
 
 	return amount;
 }
@@ -451,6 +459,8 @@ int CargoHold::TransferPassengers(const Mission *mission, int amount, CargoHold
 	{
 		passengers[mission] -= amount;
 		to.passengers[mission] += amount;
+		epoch.Bump();
+		to.epoch.Bump();
 	}
 	return amount;
 }
@@ -461,6 +471,7 @@ int CargoHold::TransferPassengers(const Mission *mission, int amount, CargoHold
 // first mission cargo, then spare outfits, then ordinary commodities.
 void CargoHold::TransferAll(CargoHold &to, bool transferPassengers)
 {
+	epoch.Bump();
 	if(transferPassengers)
 		for(const auto &it : passengers)
 			TransferPassengers(it.first, it.second, to);
@@ -488,6 +499,7 @@ void CargoHold::TransferAll(CargoHold &to, bool transferPassengers)
 // Add the given amount of the given commodity.
 int CargoHold::Add(const string &commodity, int amount)
 {
+	epoch.Bump();
 	if(amount < 0)
 		return -Remove(commodity, -amount);
 
@@ -503,6 +515,7 @@ int CargoHold::Add(const string &commodity, int amount)
 // Add the given number of copies of the given outfit.
 int CargoHold::Add(const Outfit *outfit, int amount)
 {
+	epoch.Bump();
 	if(amount < 0)
 		return -Remove(outfit, -amount);
 
@@ -519,6 +532,7 @@ int CargoHold::Add(const Outfit *outfit, int amount)
 // Remove the given amount of the given commodity.
 int CargoHold::Remove(const string &commodity, int amount)
 {
+	epoch.Bump();
 	if(amount < 0)
 		return Add(commodity, -amount);
 
@@ -532,6 +546,7 @@ int CargoHold::Remove(const string &commodity, int amount)
 // Remove the given number of copies of the given outfit.
 int CargoHold::Remove(const Outfit *outfit, int amount)
 {
+	epoch.Bump();
 	if(amount < 0)
 		return Add(outfit, -amount);
 
@@ -545,6 +560,7 @@ int CargoHold::Remove(const Outfit *outfit, int amount)
 // Add all the cargo and passengers associated with the given mission.
 void CargoHold::AddMissionCargo(const Mission *mission)
 {
+	epoch.Bump();
 	// If the mission defines a cargo string, create an entry for it even if the
 	// cargo size is zero. This is so that, for example, your cargo listing can
 	// show "important documents" even if the documents take up no cargo space.
@@ -559,6 +575,7 @@ void CargoHold::AddMissionCargo(const Mission *mission)
 // Remove all the cargo and passengers (if any) associated with the given mission.
 void CargoHold::RemoveMissionCargo(const Mission *mission)
 {
+	epoch.Bump();
 	missionCargo.erase(mission);
 	passengers.erase(mission);
 }
@@ -656,3 +673,19 @@ int CargoHold::IllegalCargoAmount() const
 
 	return count;
 }
+
+
+
+// Get a number that changes whenever anything in this cargo hold does.
+uint64_t CargoHold::Epoch() const
+{
+	return epoch.Value();
+}
+
+
+
+// Bump the given epoch too whenever anything in this cargo hold changes.
+void CargoHold::SetPartOf(const shared_ptr<EpochCounter> &whole)
+{
+	epoch.SetPartOf(whole);
+}
@@ -16,8 +16,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef CARGO_HOLD_H_
 #define CARGO_HOLD_H_
 
+#include "EpochCounter.h"
+
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 
 class DataNode;
@@ -116,6 +119,12 @@ public:
 	// Returns the amount tons of illegal cargo.
 	int IllegalCargoAmount() const;
 
+	// Get a number that changes whenever anything in this cargo hold does, for
+	// caching values computed from it.
+	uint64_t Epoch() const;
+	// Bump the given epoch too whenever anything in this cargo hold changes.
+	void SetPartOf(const std::shared_ptr<EpochCounter> &whole);
+
 
 private:
 	// Use -1 to indicate unlimited capacity.
@@ -127,6 +136,8 @@ private:
 	std::map<const Outfit *, int> outfits;
 	std::map<const Mission *, int> missionCargo;
 	std::map<const Mission *, int> passengers;
+
+	EpochCounter epoch;
 };
 
 
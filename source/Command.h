@@ -180,6 +180,9 @@ public:
 	static void DebugDumpGestures();
 
 private:
+	// Recordings store the raw bits of each command.
+	friend class Replay;
+
 	explicit Command(uint64_t state);
 	Command(uint64_t state, const std::string &text, const std::string &icon = "");
 
@@ -0,0 +1,77 @@
+/* ConditionCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ConditionCache.h"
+
+#include "ConditionSet.h"
+#include "ConditionsStore.h"
+
+using namespace std;
+
+
+
+void ConditionCache::Update(ConditionsStore &conditions)
+{
+	// If the store was not tracking its changes, anything may have changed.
+	if(!conditions.IsTrackingChanges())
+	{
+		Clear();
+		conditions.TrackChanges(true);
+		return;
+	}
+
+	for(const string &name : conditions.Changes())
+	{
+		auto it = dependents.find(name);
+		if(it != dependents.end())
+			for(const ConditionSet *set : it->second)
+				entries[set].isStale = true;
+	}
+	conditions.ClearChanges();
+}
+
+
+
+bool ConditionCache::Test(const ConditionSet &set, const ConditionsStore &conditions)
+{
+	auto it = entries.find(&set);
+	if(it == entries.end())
+	{
+		it = entries.emplace(&set, Entry()).first;
+		Entry &entry = it->second;
+		for(const string &name : set.ReferencedConditions())
+		{
+			// "random" is handled by the ConditionSet itself, not the store.
+			entry.isVolatile |= (name == "random" || conditions.IsDerived(name));
+			dependents[name].push_back(&set);
+		}
+	}
+
+	Entry &entry = it->second;
+	if(entry.isStale || entry.isVolatile)
+	{
+		entry.result = set.Test(conditions);
+		entry.isStale = false;
+	}
+	return entry.result;
+}
+
+
+
+void ConditionCache::Clear()
+{
+	entries.clear();
+	dependents.clear();
+}
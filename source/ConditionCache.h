@@ -0,0 +1,62 @@
+/* ConditionCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONDITION_CACHE_H_
+#define CONDITION_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+class ConditionSet;
+class ConditionsStore;
+
+
+
+// Remembers the result of testing each of a number of ConditionSets against
+// one ConditionsStore, so that a set is only tested again once a condition it
+// refers to has been written. Sets that use derived conditions or "random" are
+// tested every time, because their values can change without any writes. The
+// ConditionSets must outlive the cache (e.g. those in GameData).
+class ConditionCache {
+public:
+	// Mark every result that depends on a condition that has changed since the
+	// last update as needing to be tested again. This must be called before
+	// any calls to Test() with the given store.
+	void Update(ConditionsStore &conditions);
+	// Get the same result as set.Test(conditions), testing it again only if
+	// anything it depends on has changed.
+	bool Test(const ConditionSet &set, const ConditionsStore &conditions);
+
+	void Clear();
+
+
+private:
+	struct Entry {
+		bool result = false;
+		bool isStale = true;
+		bool isVolatile = false;
+	};
+
+
+private:
+	std::map<const ConditionSet *, Entry> entries;
+	// The sets that need testing again whenever the named condition changes.
+	std::map<std::string, std::vector<const ConditionSet *>> dependents;
+};
+
+
+
+#endif
@@ -23,12 +23,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include <limits>
 #include <set>
 
 using namespace std;
 
 namespace {
+	// The deepest stack that a compiled SubExpression may use. Deeper ones (which
+	// would need very long expressions) are interpreted instead.
+	const size_t MAX_STACK = 32;
+
 	typedef int64_t (*BinFun)(int64_t, int64_t);
 	BinFun Op(const string &op)
 	{
@@ -460,6 +465,19 @@ set<string> ConditionSet::RelevantConditions() const
 
 
 
+set<string> ConditionSet::ReferencedConditions() const
+{
+	set<string> result;
+	for(const Expression &expression : expressions)
+		expression.AddConditions(result);
+	for(const ConditionSet &child : children)
+		for(const string &name : child.ReferencedConditions())
+			result.insert(name);
+	return result;
+}
+
+
+
 // Check if this set is satisfied by either the created, temporary conditions, or the given conditions.
 bool ConditionSet::TestSet(const ConditionsStore &conditions, const ConditionsStore &created) const
 {
@@ -554,6 +572,14 @@ string ConditionSet::Expression::Name() const
 
 
 
+void ConditionSet::Expression::AddConditions(set<string> &names) const
+{
+	left.AddConditions(names);
+	right.AddConditions(names);
+}
+
+
+
 // Returns true if the operator is a comparison and false otherwise.
 bool ConditionSet::Expression::IsTestable() const
 {
@@ -600,6 +626,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 
 	ParseSide(side);
 	GenerateSequence();
+	Compile();
 }
 
 
@@ -609,6 +636,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 ConditionSet::Expression::SubExpression::SubExpression(const string &side)
 {
 	tokens.emplace_back(side.empty() ? "'" : side);
+	Compile();
 }
 
 
@@ -668,6 +696,15 @@ bool ConditionSet::Expression::SubExpression::IsEmpty() const
 
 
 
+void ConditionSet::Expression::SubExpression::AddConditions(set<string> &names) const
+{
+	for(const string &token : tokens)
+		if(!token.empty() && !DataNode::IsNumber(token))
+			names.insert(token);
+}
+
+
+
 // Evaluate the SubExpression using the given condition maps.
 int64_t ConditionSet::Expression::SubExpression::Evaluate(const ConditionsStore &conditions,
 	const ConditionsStore &created) const
@@ -675,7 +712,58 @@ int64_t ConditionSet::Expression::SubExpression::Evaluate(const ConditionsStore
 	// Sanity check.
 	if(tokens.empty())
 		return 0;
+	if(code.empty())
+		return Interpret(conditions, created);
+
+	int64_t stack[MAX_STACK];
+	size_t top = 0;
+	for(const Instruction &instruction : code)
+	{
+		if(instruction.code == Instruction::Code::CONSTANT)
+			stack[top++] = instruction.value;
+		else if(instruction.code == Instruction::Code::CONDITION)
+		{
+			// Temporary conditions take precedence over the given ones, unless they are 0.
+			const auto slot = static_cast<ConditionsStore::Slot>(instruction.value);
+			const int64_t value = created.Get(slot);
+			stack[top++] = value ? value : conditions.Get(slot);
+		}
+		else if(instruction.code == Instruction::Code::RANDOM)
+			stack[top++] = Random::Int(100);
+		else
+		{
+			const int64_t b = stack[--top];
+			int64_t &a = stack[top - 1];
+			switch(instruction.code)
+			{
+				case Instruction::Code::ADD:
+					a = a + b;
+					break;
+				case Instruction::Code::SUBTRACT:
+					a = a - b;
+					break;
+				case Instruction::Code::MULTIPLY:
+					a = a * b;
+					break;
+				case Instruction::Code::DIVIDE:
+					a = b ? a / b : numeric_limits<int64_t>::max();
+					break;
+				default:
+					a = a % b;
+					break;
+			}
+		}
+	}
+	return stack[top - 1];
+}
+
+
 
+// Evaluate the SubExpression by substituting every token and then performing
+// each Operation in turn.
+int64_t ConditionSet::Expression::SubExpression::Interpret(const ConditionsStore &conditions,
+	const ConditionsStore &created) const
+{
 	// For SubExpressions with no Operations (i.e. simple conditions), tokens will consist
 	// of only the condition or numeric value to be returned as-is after substitution.
 	auto data = SubstituteValues(tokens, conditions, created);
@@ -810,6 +898,92 @@ void ConditionSet::Expression::SubExpression::GenerateSequence()
 
 
 
+// Compile the tokens and sequence into stack code. The code reads the tokens
+// in the same order as the interpreter, so "random" tokens are drawn in the
+// same order too. If the sequence does not form a single tree of operations
+// over every token, the SubExpression is left to be interpreted instead.
+void ConditionSet::Expression::SubExpression::Compile()
+{
+	code.clear();
+	if(tokens.empty())
+		return;
+
+	vector<Instruction> compiled;
+	size_t depth = 0;
+	size_t maxDepth = 0;
+	auto push = [&compiled, &depth, &maxDepth](Instruction::Code code, int64_t value)
+	{
+		compiled.push_back(Instruction{code, value});
+		maxDepth = max(maxDepth, ++depth);
+	};
+	auto pushToken = [&push](const string &token)
+	{
+		if(token == "random")
+			push(Instruction::Code::RANDOM, 0);
+		else if(DataNode::IsNumber(token))
+			push(Instruction::Code::CONSTANT, static_cast<int64_t>(DataNode::Value(token)));
+		else
+			push(Instruction::Code::CONDITION, ConditionsStore::GetSlot(token));
+	};
+
+	// The tokens that are read, in the order they are read.
+	vector<size_t> read;
+	if(sequence.empty())
+	{
+		// Every token is read, and the last one is the result.
+		for(size_t i = 0; i < tokens.size(); ++i)
+		{
+			read.push_back(i);
+			pushToken(tokens[i]);
+		}
+	}
+	else
+	{
+		// Walk the tree of operations from the last one, which gives the result.
+		size_t operations = 0;
+		function<void(size_t)> emit = [&](size_t index)
+		{
+			if(index < tokens.size())
+			{
+				read.push_back(index);
+				pushToken(tokens[index]);
+				return;
+			}
+			const Operation &operation = sequence[index - tokens.size()];
+			emit(operation.a);
+			emit(operation.b);
+			++operations;
+			--depth;
+			static const map<char, Instruction::Code> CODES = {
+				{'+', Instruction::Code::ADD},
+				{'-', Instruction::Code::SUBTRACT},
+				{'*', Instruction::Code::MULTIPLY},
+				{'/', Instruction::Code::DIVIDE},
+				{'%', Instruction::Code::MODULO}
+			};
+			compiled.push_back(Instruction{CODES.at(operation.symbol), 0});
+		};
+		emit(tokens.size() + sequence.size() - 1);
+		if(operations != sequence.size())
+			return;
+	}
+
+	// The interpreter reads every token that is not an empty parenthesis placeholder.
+	vector<size_t> expected;
+	for(size_t i = 0; i < tokens.size(); ++i)
+		if(!tokens[i].empty())
+			expected.push_back(i);
+	if(read != expected || maxDepth > MAX_STACK)
+		return;
+
+	code = std::move(compiled);
+	code.shrink_to_fit();
+	sequence.clear();
+	sequence.shrink_to_fit();
+}
+
+
+
 // Use a valid working index and data pointer vector to create an evaluable Operation.
 bool ConditionSet::Expression::SubExpression::AddOperation(vector<int> &data, size_t &index, const size_t &opIndex)
 {
@@ -846,6 +1020,6 @@ bool ConditionSet::Expression::SubExpression::AddOperation(vector<int> &data, si
 // Constructor for an Operation, indicating the binary function and the
 // indices of its operands within the evaluation-time data vector.
 ConditionSet::Expression::SubExpression::Operation::Operation(const string &op, size_t &a, size_t &b)
-	: fun(Op(op)), a(a), b(b)
+	: fun(Op(op)), symbol(op.front()), a(a), b(b)
 {
 }
@@ -66,6 +66,9 @@ public:
 
 	// Get the names of the conditions that are modified by this ConditionSet.
 	std::set<std::string> RelevantConditions() const;
+	// Get the names of all conditions that this ConditionSet reads or modifies,
+	// on either side of any of its expressions.
+	std::set<std::string> ReferencedConditions() const;
 
 
 private:
@@ -92,6 +95,8 @@ private:
 
 		// Returns the left side of this Expression.
 		std::string Name() const;
+		// Add the names of all conditions used on either side of this Expression.
+		void AddConditions(std::set<std::string> &names) const;
 		// True if this Expression performs a comparison and false if it performs an assignment.
 		bool IsTestable() const;
 
@@ -117,6 +122,8 @@ private:
 			const std::vector<std::string> ToStrings() const;
 
 			bool IsEmpty() const;
+			// Add the names of all conditions used in this SubExpression.
+			void AddConditions(std::set<std::string> &names) const;
 
 			// Substitute numbers for any string values and then compute the result.
 			int64_t Evaluate(const ConditionsStore &conditions, const ConditionsStore &created) const;
@@ -126,6 +133,10 @@ private:
 			void ParseSide(const std::vector<std::string> &side);
 			void GenerateSequence();
 			bool AddOperation(std::vector<int> &data, size_t &index, const size_t &opIndex);
+			// Turn the tokens and sequence into stack code.
+			void Compile();
+			// Evaluate the sequence directly, if it could not be compiled.
+			int64_t Interpret(const ConditionsStore &conditions, const ConditionsStore &created) const;
 
 
 		private:
@@ -136,14 +147,31 @@ private:
 				explicit Operation(const std::string &op, size_t &a, size_t &b);
 
 				int64_t (*fun)(int64_t, int64_t);
+				char symbol;
 				size_t a;
 				size_t b;
 			};
 
+			// A single step of the compiled form of a SubExpression, which runs on a
+			// stack: values are pushed onto it, and each operator replaces the top
+			// two values with its result. Conditions are read by their slot, so no
+			// names need to be looked up or compared while evaluating.
+			class Instruction {
+			public:
+				enum class Code : uint8_t {CONSTANT, CONDITION, RANDOM, ADD, SUBTRACT, MULTIPLY, DIVIDE, MODULO};
+
+				Code code;
+				// The number to push, or the slot of the condition to push.
+				int64_t value;
+			};
+
 
 		private:
-			// Iteration of the sequence vector yields the result.
+			// Iteration of the sequence vector yields the result. Once the SubExpression
+			// has been compiled, this is no longer needed.
 			std::vector<Operation> sequence;
+			// The compiled code. If this is empty, the sequence is interpreted instead.
+			std::vector<Instruction> code;
 			// The tokens vector converts into a data vector of numeric values during evaluation.
 			std::vector<std::string> tokens;
 			std::vector<std::string> operators;
@@ -19,10 +19,28 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataWriter.h"
 #include "Logger.h"
 
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 #include <utility>
 
 using namespace std;
 
+namespace {
+	// Derived conditions may be read from more than one thread, so every
+	// provider's cache is guarded by this.
+	mutex cacheMutex;
+
+	// Every condition name that has been given a slot, indexed by that slot.
+	// Names are never removed, and a deque never moves its elements when more
+	// are added, so references to them stay valid.
+	mutex slotMutex;
+	deque<string> slotNames;
+	unordered_map<string, ConditionsStore::Slot> slotIndex;
+}
+
 
 
 // Default constructor
@@ -36,6 +54,11 @@ ConditionsStore::DerivedProvider::DerivedProvider(const string &name, bool isPre
 void ConditionsStore::DerivedProvider::SetGetFunction(function<int64_t(const string &)> newGetFun)
 {
 	getFunction = std::move(newGetFun);
+	if(epochFunction)
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		cache.clear();
+	}
 }
 
 
@@ -54,13 +77,92 @@ void ConditionsStore::DerivedProvider::SetEraseFunction(function<bool(const stri
 
 
 
+void ConditionsStore::DerivedProvider::SetCacheEpoch(function<uint64_t()> newEpochFun)
+{
+	lock_guard<mutex> lock(cacheMutex);
+	epochFunction = std::move(newEpochFun);
+	cache.clear();
+	cacheEpoch = 0;
+}
+
+
+
+ConditionsStore::CacheStats ConditionsStore::DerivedProvider::GetCacheStats() const
+{
+	lock_guard<mutex> lock(cacheMutex);
+	return stats;
+}
+
+
+
+int64_t ConditionsStore::DerivedProvider::Get(const string &key)
+{
+	const uint64_t epoch = epochFunction ? epochFunction() : 0;
+	if(!epoch)
+		return getFunction(key);
+
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		if(epoch != cacheEpoch)
+		{
+			cache.clear();
+			cacheEpoch = epoch;
+		}
+		auto it = cache.find(key);
+		if(it != cache.end())
+		{
+			++stats.hits;
+			return it->second;
+		}
+		++stats.misses;
+	}
+
+	// The lock is not held while the value is computed, because the get
+	// function may read other derived conditions.
+	int64_t value = getFunction(key);
+	lock_guard<mutex> lock(cacheMutex);
+	if(epoch == cacheEpoch)
+		cache[key] = value;
+	return value;
+}
+
+
+
+bool ConditionsStore::DerivedProvider::Set(const string &key, int64_t value)
+{
+	bool result = setFunction(key, value);
+	// Writing to a condition should also change its epoch, but make sure that
+	// it is read again even if it didn't.
+	if(epochFunction)
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		cache.clear();
+	}
+	return result;
+}
+
+
+
+bool ConditionsStore::DerivedProvider::Erase(const string &key)
+{
+	bool result = eraseFunction(key);
+	if(epochFunction)
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		cache.clear();
+	}
+	return result;
+}
+
+
+
 ConditionsStore::ConditionEntry::operator int64_t() const
 {
 	if(!provider)
 		return value;
 
 	const string &key = fullKey.empty() ? provider->name : fullKey;
-	return provider->getFunction(key);
+	return provider->Get(key);
 }
 
 
@@ -72,7 +174,7 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator=(int6
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
-		provider->setFunction(key, val);
+		provider->Set(key, val);
 	}
 	return *this;
 }
@@ -86,7 +188,7 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator++()
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
-		provider->setFunction(key, provider->getFunction(key) + 1);
+		provider->Set(key, provider->Get(key) + 1);
 	}
 	return *this;
 }
@@ -100,7 +202,7 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator--()
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
-		provider->setFunction(key, provider->getFunction(key) - 1);
+		provider->Set(key, provider->Get(key) - 1);
 	}
 	return *this;
 }
@@ -114,7 +216,7 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator+=(int
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
-		provider->setFunction(key, provider->getFunction(key) + val);
+		provider->Set(key, provider->Get(key) + val);
 	}
 	return *this;
 }
@@ -128,13 +230,29 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator-=(int
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
-		provider->setFunction(key, provider->getFunction(key) - val);
+		provider->Set(key, provider->Get(key) - val);
 	}
 	return *this;
 }
 
 
 
+ConditionsStore::SlotCache &ConditionsStore::SlotCache::operator=(const SlotCache &)
+{
+	Invalidate();
+	return *this;
+}
+
+
+
+void ConditionsStore::SlotCache::Invalidate()
+{
+	lock_guard<mutex> lock(entriesMutex);
+	++generation;
+}
+
+
+
 // Constructor with loading primary conditions from datanode.
 ConditionsStore::ConditionsStore(const DataNode &node)
 {
@@ -204,7 +322,47 @@ int64_t ConditionsStore::Get(const string &name) const
 	if(!ce->provider)
 		return ce->value;
 
-	return ce->provider->getFunction(name);
+	return ce->provider->Get(name);
+}
+
+
+
+// Retrieve a condition by its slot.
+int64_t ConditionsStore::Get(Slot slot) const
+{
+	// A store with nothing in it, like the temporary conditions used to test
+	// most ConditionSets, doesn't need to resolve any slots.
+	if(storage.empty())
+		return 0;
+
+	const SlotCache::Entry found = ResolveSlot(slot);
+	if(!found.entry)
+		return 0;
+
+	if(!found.entry->provider)
+		return found.entry->value;
+
+	return found.entry->provider->Get(*found.name);
+}
+
+
+
+// Get the slot for the given condition name, giving it one if it has none yet.
+ConditionsStore::Slot ConditionsStore::GetSlot(const string &name)
+{
+	lock_guard<mutex> lock(slotMutex);
+	auto it = slotIndex.emplace(name, static_cast<Slot>(slotNames.size()));
+	if(it.second)
+		slotNames.push_back(name);
+	return it.first->second;
+}
+
+
+
+const string &ConditionsStore::SlotName(Slot slot)
+{
+	lock_guard<mutex> lock(slotMutex);
+	return slotNames.at(slot);
 }
 
 
@@ -228,14 +386,19 @@ bool ConditionsStore::Set(const string &name, int64_t value)
 	if(!ce)
 	{
 		(storage[name]).value = value;
+		slots.Invalidate();
+		if(isTrackingChanges)
+			changes.insert(name);
 		return true;
 	}
 	if(!ce->provider)
 	{
+		if(isTrackingChanges && ce->value != value)
+			changes.insert(name);
 		ce->value = value;
 		return true;
 	}
-	return ce->provider->setFunction(name, value);
+	return ce->provider->Set(name, value);
 }
 
 
@@ -251,20 +414,30 @@ bool ConditionsStore::Erase(const string &name)
 	if(!(ce->provider))
 	{
 		storage.erase(name);
+		slots.Invalidate();
+		if(isTrackingChanges)
+			changes.insert(name);
 		return true;
 	}
-	return ce->provider->eraseFunction(name);
+	return ce->provider->Erase(name);
 }
 
 
 
 ConditionsStore::ConditionEntry &ConditionsStore::operator[](const string &name)
 {
+	// The caller may write to the entry, so assume that it changes.
+	if(isTrackingChanges)
+		changes.insert(name);
+
 	// Search for an exact match and return it if it exists.
 	auto it = storage.find(name);
 	if(it != storage.end())
 		return it->second;
 
+	// Either way, a new entry is created.
+	slots.Invalidate();
+
 	// Check for a prefix provider.
 	ConditionEntry *ceprov = GetEntry(name);
 	// If no prefix provider is found, then just create a new value entry.
@@ -295,7 +468,14 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderPrefixed(const str
 	}
 	if(VerifyProviderLocation(prefix, provider))
 	{
-		storage[prefix].provider = provider;
+		ConditionEntry &entry = storage[prefix];
+		// Any number of conditions may now get their values from somewhere else.
+		if(entry.provider != provider)
+		{
+			TrackChanges(false);
+			slots.Invalidate();
+		}
+		entry.provider = provider;
 		// Check if any matching later entries within the prefixed range use the same provider.
 		auto checkIt = storage.find(prefix);
 		while(checkIt != storage.end() && (0 == checkIt->first.compare(0, prefix.length(), prefix)))
@@ -326,17 +506,79 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderNamed(const string
 	if(provider->isPrefixProvider)
 		Logger::LogError("Error: Retrieving prefixed provider \"" + name + "\" as named provider.");
 	else if(VerifyProviderLocation(name, provider))
-		storage[name].provider = provider;
+	{
+		ConditionEntry &entry = storage[name];
+		if(entry.provider != provider)
+		{
+			TrackChanges(false);
+			slots.Invalidate();
+		}
+		entry.provider = provider;
+	}
 	return *provider;
 }
 
 
 
+bool ConditionsStore::IsDerived(const string &name) const
+{
+	const ConditionEntry *ce = GetEntry(name);
+	return ce && ce->provider;
+}
+
+
+
+void ConditionsStore::TrackChanges(bool track)
+{
+	isTrackingChanges = track;
+	changes.clear();
+}
+
+
+
+bool ConditionsStore::IsTrackingChanges() const
+{
+	return isTrackingChanges;
+}
+
+
+
+const set<string> &ConditionsStore::Changes() const
+{
+	return changes;
+}
+
+
+
+void ConditionsStore::ClearChanges()
+{
+	changes.clear();
+}
+
+
+
+// Get the combined cache statistics of all providers.
+ConditionsStore::CacheStats ConditionsStore::GetCacheStats() const
+{
+	lock_guard<mutex> lock(cacheMutex);
+	CacheStats total;
+	for(const auto &it : providers)
+	{
+		total.hits += it.second.stats.hits;
+		total.misses += it.second.stats.misses;
+	}
+	return total;
+}
+
+
+
 // Helper to completely remove all data and linked condition-providers from the store.
 void ConditionsStore::Clear()
 {
 	storage.clear();
 	providers.clear();
+	slots.Invalidate();
+	TrackChanges(false);
 }
 
 
@@ -417,3 +659,23 @@ bool ConditionsStore::VerifyProviderLocation(const string &name, DerivedProvider
 				", because it is within range of prefixed derived provider \"" + ce.provider->name + "\".");
 	return true;
 }
+
+
+
+// Find the entry for a slot. The result is remembered until entries are added
+// to or removed from this store.
+ConditionsStore::SlotCache::Entry ConditionsStore::ResolveSlot(Slot slot) const
+{
+	lock_guard<mutex> lock(slots.entriesMutex);
+	if(slot >= slots.entries.size())
+		slots.entries.resize(max<size_t>(slot + 1, 2 * slots.entries.size()));
+
+	SlotCache::Entry &cached = slots.entries[slot];
+	if(cached.generation != slots.generation)
+	{
+		cached.name = &SlotName(slot);
+		cached.entry = GetEntry(*cached.name);
+		cached.generation = slots.generation;
+	}
+	return cached;
+}
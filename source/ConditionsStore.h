@@ -20,7 +20,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <functional>
 #include <initializer_list>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -43,6 +46,19 @@ public:
 	// DerivedProvider.
 	class ConditionEntry;
 
+	// A handle for a condition name. The same name always has the same slot, in
+	// every store, so a slot can be looked up once (e.g. when loading a
+	// ConditionSet) and then used to read that condition from any store.
+	using Slot = uint32_t;
+
+	// How many reads of cached derived conditions were answered from a cache,
+	// and how many had to be computed.
+	class CacheStats {
+	public:
+		int64_t hits = 0;
+		int64_t misses = 0;
+	};
+
 	// Class for DerivedProviders, the (lambda) functions that provide access
 	// to the derived conditions are registered in this class.
 	class DerivedProvider {
@@ -54,6 +70,13 @@ public:
 		void SetGetFunction(std::function<int64_t(const std::string &)> newGetFun);
 		void SetSetFunction(std::function<bool(const std::string &, int64_t)> newSetFun);
 		void SetEraseFunction(std::function<bool(const std::string &)> newEraseFun);
+		// Remember the values returned by the get function until the given
+		// function returns a different epoch. Only conditions that cannot change
+		// without that epoch changing should be cached. An epoch of 0 means the
+		// values cannot be cached at the moment.
+		void SetCacheEpoch(std::function<uint64_t()> newEpochFun);
+
+		CacheStats GetCacheStats() const;
 
 	public:
 		// This is intended as a private constructor, only to be called from within
@@ -61,6 +84,12 @@ public:
 		// DerivedProviders are emplaced in the providers-map-variable.
 		DerivedProvider(const std::string &name, bool isPrefixProvider);
 
+	private:
+		// Access the derived conditions through the cache, if there is one.
+		int64_t Get(const std::string &key);
+		bool Set(const std::string &key, int64_t value);
+		bool Erase(const std::string &key);
+
 	private:
 		std::string name;
 		bool isPrefixProvider;
@@ -71,6 +100,12 @@ public:
 		std::function<bool(const std::string &, int64_t)> setFunction = [](const std::string &name, int64_t value) {
 			return false; };
 		std::function<bool(const std::string &)> eraseFunction = [](const std::string &name) { return false; };
+
+		// Values computed while the epoch function returned cacheEpoch.
+		std::function<uint64_t()> epochFunction;
+		uint64_t cacheEpoch = 0;
+		std::map<std::string, int64_t> cache;
+		CacheStats stats;
 	};
 
 
@@ -99,6 +134,32 @@ public:
 	};
 
 
+	// Where to find the condition that each slot refers to in this store. The
+	// entries point into the store that built them, so copying a store does not
+	// copy its slot cache. Conditions may be read from more than one thread, so
+	// the cache is only used while holding its mutex.
+	class SlotCache {
+	public:
+		SlotCache() = default;
+		SlotCache(const SlotCache &) {}
+		SlotCache &operator=(const SlotCache &);
+
+		// Forget where every slot was found, because entries were added or removed.
+		void Invalidate();
+
+	public:
+		class Entry {
+		public:
+			const ConditionEntry *entry = nullptr;
+			const std::string *name = nullptr;
+			uint64_t generation = 0;
+		};
+		std::vector<Entry> entries;
+		uint64_t generation = 1;
+		std::mutex entriesMutex;
+	};
+
+
 
 public:
 	// Constructors to initialize this class.
@@ -114,6 +175,13 @@ public:
 	// Retrieve a "condition" flag from this store (directly or from the
 	// connected provider).
 	int64_t Get(const std::string &name) const;
+	// Retrieve a condition by its slot, which is faster than looking it up by
+	// name because where it is stored is only looked up the first time.
+	int64_t Get(Slot slot) const;
+
+	// Get the slot for the given condition name, or the name of a slot.
+	static Slot GetSlot(const std::string &name);
+	static const std::string &SlotName(Slot slot);
 
 	// Add a value to a condition, set a value for a condition or erase a
 	// condition completely. Returns true on success, false on failure.
@@ -128,6 +196,21 @@ public:
 	DerivedProvider &GetProviderPrefixed(const std::string &prefix);
 	DerivedProvider &GetProviderNamed(const std::string &name);
 
+	// Check if the given condition is provided from outside of this store, in
+	// which case its value may change without anything being written here.
+	bool IsDerived(const std::string &name) const;
+
+	// Start (or stop) keeping a list of the primary conditions that are written
+	// to, for use by anything that caches results computed from them. Nothing
+	// is recorded for derived conditions. Clearing the store stops tracking.
+	void TrackChanges(bool track);
+	bool IsTrackingChanges() const;
+	const std::set<std::string> &Changes() const;
+	void ClearChanges();
+
+	// Get the combined cache statistics of all providers.
+	CacheStats GetCacheStats() const;
+
 	// Helper to completely remove all data and linked condition-providers from the store.
 	void Clear();
 
@@ -142,6 +225,8 @@ private:
 	ConditionEntry *GetEntry(const std::string &name);
 	const ConditionEntry *GetEntry(const std::string &name) const;
 	bool VerifyProviderLocation(const std::string &name, DerivedProvider *provider) const;
+	// Find the entry for a slot, using the slot cache when possible.
+	SlotCache::Entry ResolveSlot(Slot slot) const;
 
 
 
@@ -149,6 +234,10 @@ private:
 	// Storage for both the primary conditions as well as the providers.
 	std::map<std::string, ConditionEntry> storage;
 	std::map<std::string, DerivedProvider> providers;
+	mutable SlotCache slots;
+
+	bool isTrackingChanges = false;
+	std::set<std::string> changes;
 };
 
 
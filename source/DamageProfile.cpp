@@ -17,7 +17,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DamageDealt.h"
 #include "Mask.h"
-#include "Outfit.h"
 #include "Ship.h"
 #include "Weapon.h"
 
@@ -57,6 +56,21 @@ DamageDealt DamageProfile::CalculateDamage(const Ship &ship, bool ignoreBlast) c
 
 
 
+// Calculate the damage dealt to each of the given ships, in the same order.
+// The body that was hit directly, if any, does not take blast damage.
+void DamageProfile::CalculateDamage(const vector<Ship *> &ships, const Body *hit, vector<DamageDealt> &damage) const
+{
+	damage.clear();
+	damage.reserve(ships.size());
+	for(const Ship *ship : ships)
+	{
+		damage.emplace_back(weapon, Scale(inputScaling, *ship, isBlast && ship != hit));
+		PopulateDamage(damage.back(), *ship);
+	}
+}
+
+
+
 // Calculate the value of certain variables necessary for determining
 // the impact of an explosion that are shared across all ships that
 // this hazard could impact.
@@ -106,7 +120,8 @@ double DamageProfile::Scale(double scale, const Ship &ship, bool blast) const
 // Populate the given DamageDealt object with values.
 void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 {
-	const Outfit &attributes = ship.Attributes();
+	const ShipDerivedStats &stats = ship.DerivedStats();
+	const ShipDerivedStats::Protection &protection = stats.protection;
 	const Weapon &weapon = damage.GetWeapon();
 	double shieldFraction = 0.;
 
@@ -124,16 +139,16 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	double shields = ship.ShieldLevel();
 	if(shields > 0.)
 	{
-		double piercing = max(0., min(1., weapon.Piercing() / (1. + attributes.Get("piercing protection"))
-			- attributes.Get("piercing resistance")));
-		double highPermeability = attributes.Get("high shield permeability");
-		double lowPermeability = attributes.Get("low shield permeability");
+		double piercing = max(0., min(1., weapon.Piercing() / (1. + protection.piercingProtection)
+			- protection.piercingResistance));
+		double highPermeability = protection.highShieldPermeability;
+		double lowPermeability = protection.lowShieldPermeability;
 		double permeability = 0.;
 		if(highPermeability || lowPermeability)
 		{
 			// Determine what portion of its maximum shields the ship is currently at.
 			// Only do this if there is nonzero permeability involved, otherwise don't.
-			double shieldPortion = shields / ship.MaxShields();
+			double shieldPortion = shields / stats.maxShields;
 			permeability = max((highPermeability * shieldPortion) +
 				(lowPermeability * (1. - shieldPortion)), 0.);
 		}
@@ -141,9 +156,9 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 			(1. + ship.DisruptionLevel() * .01);
 
 		damage.shieldDamage = (weapon.ShieldDamage()
-			+ weapon.RelativeShieldDamage() * ship.MaxShields())
-			* ScaleType(0., 0., attributes.Get("shield protection")
-			+ (ship.IsCloaked() ? attributes.Get("cloak shield protection") : 0.));
+			+ weapon.RelativeShieldDamage() * stats.maxShields)
+			* ScaleType(0., 0., protection.shields
+			+ (ship.IsCloaked() ? protection.cloakShields : 0.));
 		if(damage.shieldDamage > shields)
 			shieldFraction = min(shieldFraction, shields / damage.shieldDamage);
 	}
@@ -153,10 +168,10 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	// Hull damage is blocked 100%.
 	// Shield damage is blocked 0%.
 	damage.shieldDamage *= shieldFraction;
-	double totalHullProtection = (ScaleType(1., 0., attributes.Get("hull protection") +
-		(ship.IsCloaked() ? attributes.Get("cloak hull protection") : 0.)));
+	double totalHullProtection = (ScaleType(1., 0., protection.hull +
+		(ship.IsCloaked() ? protection.cloakHull : 0.)));
 	damage.hullDamage = (weapon.HullDamage()
-		+ weapon.RelativeHullDamage() * ship.MaxHull())
+		+ weapon.RelativeHullDamage() * stats.maxHull)
 		* totalHullProtection;
 	double hull = ship.HullUntilDisabled();
 	if(damage.hullDamage > hull)
@@ -164,39 +179,39 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 		double hullFraction = hull / damage.hullDamage;
 		damage.hullDamage *= hullFraction;
 		damage.hullDamage += (weapon.DisabledDamage()
-			+ weapon.RelativeDisabledDamage() * ship.MaxHull())
+			+ weapon.RelativeDisabledDamage() * stats.maxHull)
 			* totalHullProtection
 			* (1. - hullFraction);
 	}
 	damage.energyDamage = (weapon.EnergyDamage()
-		+ weapon.RelativeEnergyDamage() * attributes.Get("energy capacity"))
-		* ScaleType(.5, 0., attributes.Get("energy protection"));
+		+ weapon.RelativeEnergyDamage() * stats.energyCapacity)
+		* ScaleType(.5, 0., protection.energy);
 	damage.heatDamage = (weapon.HeatDamage()
 		+ weapon.RelativeHeatDamage() * ship.MaximumHeat())
-		* ScaleType(.5, 0., attributes.Get("heat protection"));
+		* ScaleType(.5, 0., protection.heat);
 	damage.fuelDamage = (weapon.FuelDamage()
-		+ weapon.RelativeFuelDamage() * attributes.Get("fuel capacity"))
-		* ScaleType(.5, 0., attributes.Get("fuel protection"));
+		+ weapon.RelativeFuelDamage() * stats.fuelCapacity)
+		* ScaleType(.5, 0., protection.fuel);
 
 	// DoT damage types with an instantaneous analog.
 	// Ion and burn damage are blocked 50% by shields.
 	// Corrosion and leak damage are blocked 100%.
 	// Discharge damage is blocked 50% by the absence of shields.
-	damage.dischargeDamage = weapon.DischargeDamage() * ScaleType(0., .5, attributes.Get("discharge protection"));
-	damage.corrosionDamage = weapon.CorrosionDamage() * ScaleType(1., 0., attributes.Get("corrosion protection"));
-	damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., attributes.Get("ion protection"));
-	damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., attributes.Get("burn protection"));
-	damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., attributes.Get("leak protection"));
+	damage.dischargeDamage = weapon.DischargeDamage() * ScaleType(0., .5, protection.discharge);
+	damage.corrosionDamage = weapon.CorrosionDamage() * ScaleType(1., 0., protection.corrosion);
+	damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., protection.ion);
+	damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., protection.burn);
+	damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., protection.leak);
 
 	// Unique special damage types.
 	// Slowing and scrambling are blocked 50% by shields.
 	// Disruption is blocked 50% by the absence of shields.
-	damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., attributes.Get("slowing protection"));
-	damage.scramblingDamage = weapon.ScramblingDamage() * ScaleType(.5, 0., attributes.Get("scramble protection"));
-	damage.disruptionDamage = weapon.DisruptionDamage() * ScaleType(0., .5, attributes.Get("disruption protection"));
+	damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., protection.slowing);
+	damage.scramblingDamage = weapon.ScramblingDamage() * ScaleType(.5, 0., protection.scramble);
+	damage.disruptionDamage = weapon.DisruptionDamage() * ScaleType(0., .5, protection.disruption);
 
 	// Hit force is unaffected by shields.
-	double hitForce = weapon.HitForce() * ScaleType(0., 0., attributes.Get("force protection"));
+	double hitForce = weapon.HitForce() * ScaleType(0., 0., protection.force);
 	if(hitForce)
 	{
 		Point d = ship.Position() - position;
@@ -20,6 +20,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Projectile.h"
 #include "Weather.h"
 
+#include <vector>
+
+class Body;
 class DamageDealt;
 class Ship;
 class Weapon;
@@ -38,6 +41,9 @@ public:
 
 	// Calculate the damage dealt to the given ship.
 	DamageDealt CalculateDamage(const Ship &ship, bool ignoreBlast = false) const;
+	// Calculate the damage dealt to each of the given ships, in the same order.
+	// The body that was hit directly, if any, does not take blast damage.
+	void CalculateDamage(const std::vector<Ship *> &ships, const Body *hit, std::vector<DamageDealt> &damage) const;
 
 
 private:
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DataFile.h"
 
+#include "AllocationCounter.h"
 #include "Files.h"
 #include "text/Utf8.h"
 
@@ -41,6 +42,7 @@ DataFile::DataFile(istream &in)
 // Load from a file path (in UTF-8).
 void DataFile::Load(const string &path)
 {
+	AllocationCounter::Scope allocationScope("loading: data files");
 	string data = Files::Read(path);
 	if(data.empty())
 		return;
@@ -61,6 +63,7 @@ void DataFile::Load(const string &path)
 // Constructor, taking an istream. This can be cin or a file.
 void DataFile::Load(istream &in)
 {
+	AllocationCounter::Scope allocationScope("loading: data files");
 	string data;
 
 	static const size_t BLOCK = 4096;
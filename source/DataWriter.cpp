@@ -18,9 +18,42 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "Files.h"
 
+#include <cctype>
+#include <cstdio>
+#include <string_view>
+
 using namespace std;
 
+namespace {
+	// Floating point numbers are written with this many significant digits.
+	constexpr int PRECISION = 8;
+	// Most files written by the game are small, but reserving a little space up
+	// front avoids repeated reallocation for the first few lines.
+	constexpr size_t INITIAL_CAPACITY = 4096;
 
+	// Append the given text to the output, enclosed in the correct quotation marks.
+	void AppendQuoted(string &out, string_view text)
+	{
+		// Figure out what kind of quotation marks need to be used for this string.
+		// If the token is an empty string, it needs to be wrapped in quotes as if it had a space.
+		bool hasSpace = text.empty();
+		bool hasQuote = false;
+		bool hasBacktick = false;
+		for(unsigned char c : text)
+		{
+			hasSpace |= (isspace(c) != 0);
+			hasQuote |= (c == '"');
+			hasBacktick |= (c == '`');
+		}
+
+		char quote = hasQuote ? '`' : (hasSpace || hasBacktick) ? '"' : '\0';
+		if(quote)
+			out += quote;
+		out += text;
+		if(quote)
+			out += quote;
+	}
+}
 
 // This string constant is just used for remembering what string needs to be
 // written before the next token - either the full indentation or this, a space:
@@ -29,10 +62,13 @@ const string DataWriter::space = " ";
 
 
 // Constructor, specifying the file to save.
-DataWriter::DataWriter(const string &path)
+DataWriter::DataWriter(const string &path, size_t flushThreshold)
 	: DataWriter()
 {
 	this->path = path;
+	this->flushThreshold = flushThreshold;
+	if(flushThreshold)
+		out.reserve(flushThreshold + INITIAL_CAPACITY);
 }
 
 
@@ -41,24 +77,29 @@ DataWriter::DataWriter(const string &path)
 DataWriter::DataWriter()
 	: before(&indent)
 {
-	out.precision(8);
+	out.reserve(INITIAL_CAPACITY);
 }
 
 
 
-// Destructor, which saves the file all in one block.
+// Destructor, which saves the file all in one block, or writes whatever was
+// not yet flushed to it.
 DataWriter::~DataWriter()
 {
-	if(!path.empty())
+	if(path.empty())
+		return;
+	if(file)
+		Files::Write(file, out);
+	else
 		SaveToPath(path);
 }
 
 
 
-// Save the contents to a file.
+// Save the buffered contents to a file.
 void DataWriter::SaveToPath(const std::string &filepath)
 {
-	Files::Write(filepath, out.str());
+	Files::Write(filepath, out);
 }
 
 
@@ -66,7 +107,7 @@ void DataWriter::SaveToPath(const std::string &filepath)
 // Get the contents as a string.
 string DataWriter::SaveToString()
 {
-	return out.str();
+	return out;
 }
 
 
@@ -76,7 +117,7 @@ void DataWriter::Write(const DataNode &node)
 {
 	// Write all this node's tokens.
 	for(int i = 0; i < node.Size(); ++i)
-		WriteToken(node.Token(i).c_str());
+		WriteToken(node.Token(i));
 	Write();
 
 	// If this node has any children, call this function recursively on them.
@@ -96,8 +137,9 @@ void DataWriter::Write(const DataNode &node)
 // Begin a new line of the file.
 void DataWriter::Write()
 {
-	out << '\n';
+	out += '\n';
 	before = &indent;
+	FlushIfNeeded();
 }
 
 
@@ -121,7 +163,9 @@ void DataWriter::EndChild()
 // Write a comment line, at the current indentation level.
 void DataWriter::WriteComment(const string &str)
 {
-	out << *before << "# " << str;
+	out += *before;
+	out += "# ";
+	out += str;
 	Write();
 }
 
@@ -130,7 +174,9 @@ void DataWriter::WriteComment(const string &str)
 // Write a token, given as a character string.
 void DataWriter::WriteToken(const char *a)
 {
-	WriteToken(string(a));
+	out += *before;
+	AppendQuoted(out, a);
+	before = &space;
 }
 
 
@@ -138,8 +184,8 @@ void DataWriter::WriteToken(const char *a)
 // Write a token, given as a string object.
 void DataWriter::WriteToken(const string &a)
 {
-	out << *before;
-	out << Quote(a);
+	out += *before;
+	AppendQuoted(out, a);
 
 	// The next token written will not be the first one on this line, so it only
 	// needs to have a single space before it.
@@ -150,17 +196,36 @@ void DataWriter::WriteToken(const string &a)
 
 string DataWriter::Quote(const std::string &a)
 {
-	// Figure out what kind of quotation marks need to be used for this string.
-	bool hasSpace = any_of(a.begin(), a.end(), [](unsigned char c) { return isspace(c); });
-	bool hasQuote = any_of(a.begin(), a.end(), [](char c) { return (c == '"'); });
-	bool hasBacktick = any_of(a.begin(), a.end(), [](char c) { return (c == '`'); });
-	// If the token is an empty string, it needs to be wrapped in quotes as if it had a space.
-	hasSpace |= a.empty();
-
-	if(hasQuote)
-		return '`' + a + '`';
-	else if(hasSpace || hasBacktick)
-		return '"' + a + '"';
-	else
-		return a;
+	string result;
+	result.reserve(a.length() + 2);
+	AppendQuoted(result, a);
+	return result;
+}
+
+
+
+void DataWriter::WriteNumber(double value)
+{
+	char buffer[32];
+#ifdef __cpp_lib_to_chars
+	out.append(buffer, to_chars(buffer, buffer + sizeof(buffer), value, chars_format::general, PRECISION).ptr);
+#else
+	// Some standard libraries do not support formatting floating point numbers
+	// with to_chars yet, but printf produces the same output.
+	int length = snprintf(buffer, sizeof(buffer), "%.*g", PRECISION, value);
+	out.append(buffer, max(0, min<int>(length, sizeof(buffer) - 1)));
+#endif
+}
+
+
+
+void DataWriter::FlushIfNeeded()
+{
+	if(!flushThreshold || out.size() < flushThreshold)
+		return;
+
+	if(!file)
+		file = File(path, true);
+	Files::Write(file, out);
+	out.clear();
 }
@@ -16,10 +16,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef DATA_WRITER_H_
 #define DATA_WRITER_H_
 
+#include "File.h"
+
 #include <algorithm>
+#include <charconv>
+#include <cstddef>
 #include <map>
-#include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class DataNode;
@@ -33,19 +37,22 @@ class DataNode;
 // automatically adds quotation marks around strings if they contain whitespace.
 class DataWriter {
 public:
-	// Constructor, specifying the file to write.
-	explicit DataWriter(const std::string &path);
+	// Constructor, specifying the file to write. If a flush threshold is given,
+	// the output is appended to the file whenever more than that many bytes
+	// are buffered, instead of being held in memory until the destructor.
+	explicit DataWriter(const std::string &path, size_t flushThreshold = 0);
 	// Constructor for a DataWriter that will not save its contents automatically
 	DataWriter();
 	DataWriter(const DataWriter &) = delete;
 	DataWriter(DataWriter &&) = delete;
 	DataWriter &operator=(const DataWriter &) = delete;
 	DataWriter operator=(DataWriter &&) = delete;
-	// The file is not actually saved until the destructor is called. This makes
-	// it possible to write the whole file in a single chunk.
+	// Unless a flush threshold was given, the file is not actually saved until
+	// the destructor is called. This makes it possible to write the whole file
+	// in a single chunk.
 	~DataWriter();
 
-	// Save the contents to a file.
+	// Save the buffered contents to a file.
 	void SaveToPath(const std::string &path);
 	// Get the contents as a string.
 	std::string SaveToString();
@@ -81,6 +88,14 @@ public:
 	static std::string Quote(const std::string &text);
 
 
+private:
+	// Append a floating point number, formatted the same way as an ostream
+	// with a precision of 8 would.
+	void WriteNumber(double value);
+	// Write out the buffer if it has grown past the flush threshold.
+	void FlushIfNeeded();
+
+
 private:
 	// Save path (in UTF-8). Empty string for in-memory DataWriter.
 	std::string path;
@@ -93,7 +108,11 @@ private:
 	// "indent" for the first token in a line and "space" for subsequent tokens.
 	const std::string *before;
 	// Compose the output in memory before writing it to file.
-	std::ostringstream out;
+	std::string out;
+	// If nonzero, the buffered output is written to the file once it is this large.
+	size_t flushThreshold = 0;
+	// The file being written to, once the output has been flushed at least once.
+	File file;
 };
 
 
@@ -116,7 +135,20 @@ void DataWriter::WriteToken(const A &a)
 	static_assert(std::is_arithmetic_v<A>,
 		"DataWriter cannot output anything but strings and arithmetic types.");
 
-	out << *before << a;
+	out += *before;
+	// Match what an ostream would write for each type: bools and character
+	// types are written as is, and everything else as a number.
+	if constexpr(std::is_same_v<A, bool>)
+		out += a ? '1' : '0';
+	else if constexpr(std::is_integral_v<A> && sizeof(A) == 1)
+		out += static_cast<char>(a);
+	else if constexpr(std::is_integral_v<A>)
+	{
+		char buffer[24];
+		out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), a).ptr);
+	}
+	else
+		WriteNumber(a);
 	before = &space;
 }
 
@@ -51,6 +51,14 @@ namespace {
 
 	// Names for the two kinds of depreciation records.
 	string NAME[2] = {"fleet depreciation", "stock depreciation"};
+
+	// Get the model whose records a ship is valued by. A ship whose model is
+	// not in the game data at all is its own model.
+	const Ship *Model(const Ship &ship)
+	{
+		const Ship *model = GameData::Ships().Find(ship.TrueModelName());
+		return model ? model : &ship;
+	}
 }
 
 
@@ -153,7 +161,7 @@ void Depreciation::Init(const vector<shared_ptr<Ship>> &fleet, int day)
 	// Every ship and outfit in the given fleet starts out with no depreciation.
 	for(const shared_ptr<Ship> &ship : fleet)
 	{
-		const Ship *base = GameData::Ships().Get(ship->TrueModelName());
+		const Ship *base = Model(*ship);
 		++ships[base][day];
 
 		for(const auto &it : ship->Outfits())
@@ -173,7 +181,7 @@ void Depreciation::Buy(const Ship &ship, int day, Depreciation *source, bool cha
 				Buy(it.first, day, source);
 
 	// Then, check the base day for the ship chassis itself.
-	const Ship *base = GameData::Ships().Get(ship.TrueModelName());
+	const Ship *base = Model(ship);
 	if(source)
 	{
 		// Check if the source has any instances of this ship.
@@ -231,25 +239,29 @@ void Depreciation::Buy(const Outfit *outfit, int day, Depreciation *source)
 // Get the value of an entire fleet.
 int64_t Depreciation::Value(const vector<shared_ptr<Ship>> &fleet, int day, bool chassisOnly) const
 {
-	map<const Ship *, int> shipCount;
-	map<const Outfit *, int> outfitCount;
+	map<const Ship *, int> fleetShips;
+	map<const Outfit *, int> fleetOutfits;
 
 	for(const shared_ptr<Ship> &ship : fleet)
 	{
-		const Ship *base = GameData::Ships().Get(ship->TrueModelName());
-		++shipCount[base];
+		++fleetShips[Model(*ship)];
 
 		if(!chassisOnly)
 			for(const auto &it : ship->Outfits())
-				outfitCount[it.first] += it.second;
+				fleetOutfits[it.first] += it.second;
 	}
 
-	int64_t value = 0;
-	for(const auto &it : shipCount)
-		value += Value(it.first, day, it.second);
-	for(const auto &it : outfitCount)
-		value += Value(it.first, day, it.second);
-	return value;
+	return Value(fleetShips, fleetOutfits, day);
+}
+
+
+
+// Get the value of the fleet that these records belong to, recounting only the
+// ships that changed since it was last valued.
+int64_t Depreciation::FleetValue(const vector<shared_ptr<Ship>> &fleet, int day) const
+{
+	CountFleet(fleet);
+	return Value(shipCount, outfitCount, day);
 }
 
 
@@ -270,7 +282,7 @@ int64_t Depreciation::Value(const Ship *ship, int day, int count) const
 {
 	// Check whether a record exists for this ship. If not, its value is full
 	// if this is  planet's stock, or fully depreciated if this is the player.
-	ship = GameData::Ships().Get(ship->TrueModelName());
+	ship = Model(*ship);
 	auto recordIt = ships.find(ship);
 	if(recordIt == ships.end() || recordIt->second.empty())
 		return DefaultDepreciation() * count * ship->ChassisCost();
@@ -297,6 +309,74 @@ int64_t Depreciation::Value(const Outfit *outfit, int day, int count) const
 
 
 
+// Bring the number of each ship model and outfit in the fleet up to date,
+// recounting only the ships that were added or changed since last time.
+void Depreciation::CountFleet(const vector<shared_ptr<Ship>> &fleet) const
+{
+	++countGeneration;
+	for(const shared_ptr<Ship> &ship : fleet)
+	{
+		CountedShip &counted = countedShips[ship.get()];
+		counted.generation = countGeneration;
+		if(counted.model && counted.epoch == ship->OutfitEpoch())
+			continue;
+
+		if(counted.model)
+			Count(counted, -1);
+		counted.epoch = ship->OutfitEpoch();
+		counted.model = Model(*ship);
+		counted.outfits = ship->Outfits();
+		Count(counted, 1);
+	}
+
+	// Every ship in the fleet has now been counted, so if more ships are
+	// counted than are in the fleet, some of them must have left it.
+	if(countedShips.size() > fleet.size())
+		for(auto it = countedShips.begin(); it != countedShips.end(); )
+		{
+			if(it->second.generation == countGeneration)
+				++it;
+			else
+			{
+				Count(it->second, -1);
+				it = countedShips.erase(it);
+			}
+		}
+}
+
+
+
+// Get the value of the given number of each ship model and outfit.
+int64_t Depreciation::Value(const map<const Ship *, int> &fleetShips, const map<const Outfit *, int> &fleetOutfits,
+	int day) const
+{
+	int64_t value = 0;
+	for(const auto &it : fleetShips)
+		value += Value(it.first, day, it.second);
+	for(const auto &it : fleetOutfits)
+		value += Value(it.first, day, it.second);
+	return value;
+}
+
+
+
+// Add (or, with a negative sign, remove) a ship to the fleet counts.
+void Depreciation::Count(const CountedShip &ship, int sign) const
+{
+	auto add = [sign](auto &counts, auto key, int count)
+	{
+		auto it = counts.emplace(key, 0).first;
+		it->second += sign * count;
+		if(!it->second)
+			counts.erase(it);
+	};
+	add(shipCount, ship.model, 1);
+	for(const auto &it : ship.outfits)
+		add(outfitCount, it.first, it.second);
+}
+
+
+
 // "Sell" an item, removing it from the given record and returning the base
 // day for its depreciation.
 int Depreciation::Sell(map<int, int> &record) const
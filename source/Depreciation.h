@@ -55,6 +55,10 @@ public:
 
 	// Get the value of an entire fleet.
 	int64_t Value(const std::vector<std::shared_ptr<Ship>> &fleet, int day, bool chassisOnly = false) const;
+	// Get the value of the fleet these records belong to. It is valued every
+	// day and changes little, so the counts of its ships and outfits are kept
+	// between calls. Any other selection of ships should use Value() instead.
+	int64_t FleetValue(const std::vector<std::shared_ptr<Ship>> &fleet, int day) const;
 	// Get the value of a ship, along with all its outfits.
 	int64_t Value(const Ship &ship, int day) const;
 	// Get the value just of the chassis of a ship.
@@ -64,6 +68,26 @@ public:
 
 
 private:
+	// The model and outfits of a ship, as they were when the fleet was counted.
+	class CountedShip {
+	public:
+		uint64_t epoch = 0;
+		// The last count in which this ship was part of the fleet.
+		uint64_t generation = 0;
+		const Ship *model = nullptr;
+		std::map<const Outfit *, int> outfits;
+	};
+
+
+private:
+	// Bring the number of each ship model and outfit in the fleet up to date,
+	// recounting only the ships that were added or changed since last time.
+	void CountFleet(const std::vector<std::shared_ptr<Ship>> &fleet) const;
+	// Get the value of the given number of each ship model and outfit.
+	int64_t Value(const std::map<const Ship *, int> &fleetShips, const std::map<const Outfit *, int> &fleetOutfits,
+		int day) const;
+	// Add (or, with a negative sign, remove) a ship to the fleet counts.
+	void Count(const CountedShip &ship, int sign) const;
 	// "Sell" an item, removing it from the given record and returning the base
 	// day for its depreciation.
 	int Sell(std::map<int, int> &record) const;
@@ -86,6 +110,14 @@ private:
 
 	std::map<const Ship *, std::map<int, int>> ships;
 	std::map<const Outfit *, std::map<int, int>> outfits;
+
+	// The ships in the fleet that was most recently valued by FleetValue(), and
+	// how many of each ship model and outfit they have in total. Fleets change little from
+	// one day to the next, so this saves recounting every outfit of every ship.
+	mutable std::map<const Ship *, CountedShip> countedShips;
+	mutable std::map<const Ship *, int> shipCount;
+	mutable std::map<const Outfit *, int> outfitCount;
+	mutable uint64_t countGeneration = 0;
 };
 
 
@@ -0,0 +1,187 @@
+/* Economy.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Economy.h"
+
+#include "Random.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// Dynamic economy parameters: how much of its production each system keeps
+	// and exports each day:
+	const double KEEP = .89;
+	const double EXPORT = .10;
+	// Standard deviation of the daily production of each commodity:
+	const double VOLUME = 2000.;
+	// Above this supply amount, price differences taper off:
+	const double LIMIT = 20000.;
+}
+
+
+
+// Get how much the price of a commodity differs from its base price when
+// the given amount of it is available.
+int Economy::PriceChange(double supply)
+{
+	return static_cast<int>(-100. * erf(supply / LIMIT));
+}
+
+
+
+// Lay out the matrices for the given systems and commodities. Any supply
+// already recorded for a system and commodity that are still present is kept.
+void Economy::Update(const Set<System> &systems, const vector<Trade::Commodity> &commodities)
+{
+	Economy old = std::move(*this);
+	*this = Economy();
+
+	width = commodities.size();
+	for(size_t column = 0; column < width; ++column)
+		columns.emplace(commodities[column].name, column);
+	// Random production is generated in the order of the commodity names.
+	vector<size_t> byName;
+	for(const auto &it : columns)
+		byName.push_back(it.second);
+
+	for(const auto &it : systems)
+		rows.emplace(&it.second, rows.size());
+	supply.resize(rows.size() * width);
+	exports.resize(rows.size() * width);
+	isTraded.resize(rows.size() * width);
+
+	linkStart.reserve(rows.size() + 1);
+	for(const auto &it : systems)
+	{
+		const System &system = it.second;
+		const size_t row = linkStart.size();
+		linkStart.push_back(linkRow.size());
+		for(const System *link : system.Links())
+		{
+			// A system whose own links have been removed has nothing to export.
+			auto lit = rows.find(link);
+			if(lit != rows.end() && !link->Links().empty())
+			{
+				linkRow.push_back(lit->second);
+				linkScale.push_back(link->Links().size());
+			}
+		}
+
+		for(size_t column : byName)
+		{
+			if(!system.HasTrade(commodities[column].name))
+				continue;
+
+			const size_t index = row * width + column;
+			isTraded[index] = 1.;
+			tradedCells.push_back(index);
+			size_t oldIndex = old.Index(&system, commodities[column].name);
+			if(oldIndex != npos)
+			{
+				supply[index] = old.supply[oldIndex];
+				exports[index] = old.exports[oldIndex];
+			}
+		}
+	}
+	linkStart.push_back(linkRow.size());
+}
+
+
+
+// Set the supply of every commodity in every system back to zero.
+void Economy::Reset()
+{
+	fill(supply.begin(), supply.end(), 0.);
+	fill(exports.begin(), exports.end(), 0.);
+}
+
+
+
+// Advance the economy by the given number of days.
+void Economy::Step(int days)
+{
+	const size_t size = supply.size();
+	for(int day = 0; day < days; ++day)
+	{
+		// First, have each system generate new goods for local use and trade.
+		// Cells that are not traded have no supply, so they stay at zero.
+		for(size_t i = 0; i < size; ++i)
+		{
+			exports[i] = EXPORT * supply[i];
+			supply[i] *= KEEP;
+		}
+		for(size_t i : tradedCells)
+			supply[i] += Random::Normal() * VOLUME;
+
+		// Then, send out the trade goods. Exports are all calculated before any
+		// of them are received, so the order the systems trade in doesn't matter.
+		for(size_t row = 0; row + 1 < linkStart.size(); ++row)
+		{
+			double *out = supply.data() + row * width;
+			const double *traded = isTraded.data() + row * width;
+			for(size_t link = linkStart[row]; link < linkStart[row + 1]; ++link)
+			{
+				const double *in = exports.data() + linkRow[link] * width;
+				const double scale = linkScale[link];
+				for(size_t column = 0; column < width; ++column)
+					out[column] += traded[column] * (in[column] / scale);
+			}
+		}
+	}
+}
+
+
+
+double Economy::Supply(const System *system, const string &commodity) const
+{
+	size_t index = Index(system, commodity);
+	return (index == npos) ? 0. : supply[index];
+}
+
+
+
+double Economy::Exports(const System *system, const string &commodity) const
+{
+	size_t index = Index(system, commodity);
+	return (index == npos) ? 0. : exports[index];
+}
+
+
+
+void Economy::SetSupply(const System *system, const string &commodity, double tons)
+{
+	size_t index = Index(system, commodity);
+	if(index != npos)
+		supply[index] = tons;
+}
+
+
+
+// Get the index of the given system and commodity in the matrices, or
+// npos if the system does not trade in that commodity.
+size_t Economy::Index(const System *system, const string &commodity) const
+{
+	auto rit = rows.find(system);
+	auto cit = columns.find(commodity);
+	if(rit == rows.end() || cit == columns.end())
+		return npos;
+
+	size_t index = rit->second * width + cit->second;
+	return isTraded[index] ? index : npos;
+}
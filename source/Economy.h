@@ -0,0 +1,95 @@
+/* Economy.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ECONOMY_H_
+#define ECONOMY_H_
+
+#include "Set.h"
+#include "Trade.h"
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class System;
+
+
+
+// The dynamic economy: how much of each commodity every system has on hand,
+// and how much of it flows out along each hyperspace link every day. Rather
+// than each system keeping its own map of commodities, the supply and exports
+// of every system are stored together as dense (systems x commodities)
+// matrices, and the links are stored in compressed sparse row form, so a day
+// of trade is a few passes over contiguous arrays that the compiler can
+// vectorize. The layout must be rebuilt whenever links or trade goods change.
+class Economy {
+public:
+	// Get how much the price of a commodity differs from its base price when
+	// the given amount of it is available.
+	static int PriceChange(double supply);
+
+
+public:
+	// Lay out the matrices for the given systems and commodities. Any supply
+	// already recorded for a system and commodity that are still present is kept.
+	void Update(const Set<System> &systems, const std::vector<Trade::Commodity> &commodities);
+	// Set the supply of every commodity in every system back to zero.
+	void Reset();
+
+	// Advance the economy by the given number of days.
+	void Step(int days = 1);
+
+	// Access the supply and exports of a single commodity in a system. Systems
+	// that do not trade in a commodity always have none of it.
+	double Supply(const System *system, const std::string &commodity) const;
+	double Exports(const System *system, const std::string &commodity) const;
+	void SetSupply(const System *system, const std::string &commodity, double tons);
+
+
+private:
+	// Get the index of the given system and commodity in the matrices, or
+	// npos if the system does not trade in that commodity.
+	size_t Index(const System *system, const std::string &commodity) const;
+
+
+private:
+	static const size_t npos = static_cast<size_t>(-1);
+
+	// Rows are systems, in the order of their names, and columns are commodities.
+	std::unordered_map<const System *, size_t> rows;
+	std::map<std::string, size_t> columns;
+	size_t width = 0;
+
+	std::vector<double> supply;
+	std::vector<double> exports;
+	// 1 in each cell where a system trades in that commodity, and 0 elsewhere.
+	std::vector<double> isTraded;
+	// Every traded cell, in the order random production is generated for them:
+	// by system name, then by commodity name.
+	std::vector<size_t> tradedCells;
+
+	// The links of the system in row i are entries linkStart[i] through
+	// linkStart[i + 1] - 1 of linkRow, which holds the linked system's row,
+	// and of linkScale, which holds how many links its exports are split among.
+	std::vector<size_t> linkStart;
+	std::vector<size_t> linkRow;
+	std::vector<double> linkScale;
+};
+
+
+
+#endif
@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Engine.h"
 
 #include "AlertLabel.h"
+#include "AssetHandle.h"
+#include "AllocationCounter.h"
 #include "Audio.h"
 #include "CategoryList.h"
 #include "CategoryTypes.h"
@@ -33,6 +35,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "text/Font.h"
 #include "text/FontSet.h"
 #include "text/Format.h"
+#include "Files.h"
 #include "FrameTimer.h"
 #include "GameData.h"
 #include "GamePad.h"
@@ -68,6 +71,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "StellarObject.h"
 #include "System.h"
 #include "SystemEntry.h"
+#include "Telemetry.h"
 #include "Test.h"
 #include "Visual.h"
 #include "Weather.h"
@@ -77,11 +81,28 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <iterator>
 #include <string>
+#include <thread>
 
 using namespace std;
 
 namespace {
+	// The fewest ships each task moves when ships are moved in parallel, so
+	// that the work outweighs the cost of handing it to another thread.
+	const size_t SHIPS_PER_TASK = 16;
+
+	const AssetHandle<Sound> JUMP_DRIVE_SOUND("jump drive");
+	const AssetHandle<Sound> HYPERDRIVE_SOUND("hyperdrive");
+	const AssetHandle<Sound> JUMP_IN_SOUND("jump in");
+	const AssetHandle<Sound> JUMP_OUT_SOUND("jump out");
+	const AssetHandle<Sound> HYPERDRIVE_IN_SOUND("hyperdrive in");
+	const AssetHandle<Sound> HYPERDRIVE_OUT_SOUND("hyperdrive out");
+	const AssetHandle<Sound> ALARM_SOUND("alarm");
+
+	// Built once, so checking the preference every step does not allocate.
+	const string SHOW_LOAD = "Show CPU / GPU load";
+
 	int RadarType(const Ship &ship, int step)
 	{
 		if(ship.GetPersonality().IsTarget() && !ship.IsDestroyed())
@@ -330,12 +351,20 @@ Engine::~Engine()
 	// Wait for any outstanding task to finish to avoid race conditions when
 	// destroying the engine.
 	queue.Wait();
+
+	// If the game is closed while a recording is being made, keep what was
+	// recorded so far.
+	if(replay && replayStart >= 0)
+		EndReplay();
 }
 
 
 
 void Engine::Place()
 {
+	if(replay)
+		BeginReplay();
+
 	ships.clear();
 	ai.ClearOrders();
 
@@ -520,6 +549,31 @@ void Engine::Wait()
 // Begin the next step of calculations.
 void Engine::Step(bool isActive)
 {
+	// Updating the allocation rates is not counted as part of the step.
+	if(AllocationCounter::IsEnabled() && Preferences::Has(SHOW_LOAD) && ++allocationFrames == 60)
+	{
+		// Tags are never removed, and new ones are added at the end.
+		allocationFrames = 0;
+		vector<AllocationCounter::Tally> totals = AllocationCounter::Tallies();
+		allocationRates.resize(totals.size());
+		for(size_t i = 0; i < totals.size(); ++i)
+		{
+			AllocationCounter::Tally &rate = allocationRates[i];
+			rate.tag = totals[i].tag;
+			rate.count = totals[i].count;
+			rate.bytes = totals[i].bytes;
+			if(i < allocationTotals.size())
+			{
+				rate.count -= allocationTotals[i].count;
+				rate.bytes -= allocationTotals[i].bytes;
+			}
+			rate.count /= 60;
+			rate.bytes /= 60;
+		}
+		allocationTotals.swap(totals);
+	}
+
+	AllocationCounter::Scope allocationScope("engine: step");
 	events.swap(eventQueue);
 	eventQueue.clear();
 
@@ -578,12 +632,15 @@ void Engine::Step(bool isActive)
 	ai.UpdateEvents(events);
 	if(isActive)
 	{
-		HandleKeyboardInputs();
+		if(!isReplaying)
+			HandleKeyboardInputs();
 		// Ignore any inputs given when first becoming active, since those inputs
 		// were issued when some other panel (e.g. planet, hail) was displayed.
 		if(!wasActive)
 			activeCommands.Clear();
-		else
+		if(replay && replayStart >= 0)
+			StepReplay();
+		if(wasActive)
 			ai.UpdateKeys(player, activeCommands);
 	}
 
@@ -1030,6 +1087,11 @@ void Engine::Step(bool isActive)
 			GetMinablePointerColor(true),
 			3
 		});
+
+	// Any clicks have now been handled, so if the pointer state is any
+	// different in the next step, it is because the player gave a new input.
+	if(replay && replayStart >= 0)
+		replayPointer = GetPointer();
 }
 
 
@@ -1052,6 +1114,62 @@ void Engine::GiveCommand(const Command &command)
 
 
 
+// Record the player's inputs from the next take-off until they land again,
+// and then save the recording to the given file. This does nothing if a
+// recording has already been requested or begun.
+void Engine::Record(const string &path)
+{
+	if(replay && !isReplaying)
+		return;
+
+	replay = make_shared<Replay>();
+	recordingPath = path;
+	isReplaying = false;
+	replayStart = -1;
+}
+
+
+
+// Check if the player's inputs are being recorded in this flight.
+bool Engine::IsRecording() const
+{
+	return replay && !isReplaying && replayStart >= 0;
+}
+
+
+
+// Play the given recording back instead of reading the player's inputs,
+// beginning with the next take-off.
+void Engine::Play(const shared_ptr<Replay> &replay)
+{
+	this->replay = replay;
+	recordingPath.clear();
+	isReplaying = true;
+	replayStart = -1;
+}
+
+
+
+// Check if every step of the recording being played back has been run.
+bool Engine::IsReplayDone() const
+{
+	if(!isReplaying)
+		return false;
+	return !replay || (replayStart >= 0 && step - replayStart >= replay->Steps());
+}
+
+
+
+// Stop recording or playing back the player's inputs because they have
+// landed, saving any recording to its file.
+void Engine::EndFlight()
+{
+	if(replay && replayStart >= 0)
+		EndReplay();
+}
+
+
+
 // Pass the list of game events to MainPanel for handling by the player, and any
 // UI element generation.
 list<ShipEvent> &Engine::Events()
@@ -1064,6 +1182,7 @@ list<ShipEvent> &Engine::Events()
 // Draw a frame.
 void Engine::Draw() const
 {
+	AllocationCounter::Scope allocationScope("engine: draw");
 	Point motionBlur = Preferences::Has("Render motion blur") ? centerVelocity : Point();
 
 	Preferences::ExtendedJumpEffects jumpEffectState = Preferences::GetExtendedJumpEffects();
@@ -1241,12 +1360,42 @@ void Engine::Draw() const
 		}
 	}
 
-	if(Preferences::Has("Show CPU / GPU load"))
+	if(Preferences::Has(SHOW_LOAD))
 	{
 		string loadString = to_string(lround(load * 100.)) + "% CPU";
+		if(AllocationCounter::IsEnabled())
+			loadString = to_string(lround(allocations)) + " allocations per step, " + loadString;
 		Color color = *colors.Get("medium");
 		font.Draw(loadString,
 			Point(-10 - font.Width(loadString), Screen::Height() * -.5 + 5.), color);
+
+		// Below that, show the 50th, 95th, and 99th percentile of how long each
+		// part of a frame has taken in this session.
+		const string lines[] = {
+			Telemetry::Describe(Telemetry::Phase::CALCULATION),
+			Telemetry::Describe(Telemetry::Phase::DRAW),
+			Telemetry::Describe(Telemetry::Phase::SWAP),
+			Telemetry::Describe(Telemetry::Phase::FRAME),
+			to_string(Telemetry::DroppedFrames()) + " dropped frames"
+		};
+		double y = Screen::Height() * -.5 + 5.;
+		for(const string &line : lines)
+		{
+			y += 20.;
+			font.Draw(line, Point(-10 - font.Width(line), y), color);
+		}
+
+		// In debug builds, also show the five tags with the most allocations.
+		vector<AllocationCounter::Tally> rates = allocationRates;
+		sort(rates.begin(), rates.end(), [](const AllocationCounter::Tally &a, const AllocationCounter::Tally &b)
+			{ return a.count > b.count; });
+		for(size_t i = 0; i < rates.size() && i < 5 && rates[i].count; ++i)
+		{
+			const string line = string(rates[i].tag) + ": " + to_string(rates[i].count) + " allocations, "
+				+ to_string(rates[i].bytes) + " bytes per frame";
+			y += 20.;
+			font.Draw(line, Point(-10 - font.Width(line), y), color);
+		}
 	}
 }
 
@@ -1532,6 +1681,7 @@ void Engine::EnterSystem()
 	grudge.clear();
 
 	projectiles.clear();
+	particles.Clear();
 	visuals.clear();
 	flotsam.clear();
 	// Cancel any projectiles, visuals, or flotsam created by ships this step.
@@ -1556,6 +1706,14 @@ void Engine::EnterSystem()
 void Engine::CalculateStep()
 {
 	FrameTimer loadTimer;
+	const uint64_t allocationsBefore = AllocationCounter::Count();
+	AllocationCounter::Scope allocationScope("engine: commands");
+
+	// Each step of a recording draws its random numbers from its own seed, so
+	// that playing it back does not depend on what the other threads did.
+	const bool isInReplay = (replay && replayStart >= 0);
+	if(isInReplay)
+		Random::Seed(replay->Seed() ^ (static_cast<uint64_t>(step - replayStart) * 0x9E3779B97F4A7C15ull));
 
 	// If there is a pending zoom update then use it
 	// because the zoom will get updated in the main thread
@@ -1570,12 +1728,36 @@ void Engine::CalculateStep()
 	if(!player.GetSystem())
 		return;
 
-	// Handle the mouse input of the mouse navigation
-	HandleMouseInput(activeCommands);
-	// Handle gamepad input
-	HandleGamepadInput(activeCommands);
+	if(isInReplay && isReplaying)
+	{
+		// Act on the recorded commands instead of reading the mouse and gamepad.
+		replayFrame = replay->Get(step - replayStart);
+		activeCommands = replayFrame.command;
+		isMouseTurningEnabled = replayFrame.isMouseTurning;
+		if(isMouseTurningEnabled)
+			ai.SetMousePosition(replayFrame.mouse);
+	}
+	else
+	{
+		// Handle the mouse input of the mouse navigation
+		HandleMouseInput(activeCommands);
+		// Handle gamepad input
+		HandleGamepadInput(activeCommands);
+	}
+	if(isInReplay && !isReplaying)
+	{
+		replayFrame.step = step - replayStart;
+		replayFrame.command = activeCommands;
+		replayFrame.isMouseTurning = isMouseTurningEnabled;
+		if(!replayFrame.IsEmpty())
+			replay->Add(replayFrame);
+		replay->SetSteps(replayFrame.step);
+		replayFrame = Replay::Frame();
+	}
 	// Now, all the ships must decide what they are doing next.
+	allocationScope.Set("engine: ai");
 	ai.Step(activeCommands);
+	allocationScope.Set("engine: ships");
 
 	// Clear the active players commands, they are all processed at this point.
 	activeCommands.Clear();
@@ -1600,16 +1782,23 @@ void Engine::CalculateStep()
 	const System *flagshipSystem = (flagship ? flagship->GetSystem() : nullptr);
 	bool flagshipIsTargetable = (flagship && flagship->IsTargetable());
 	bool flagshipBecameTargetable = flagshipWasUntargetable && flagshipIsTargetable;
-	// Then, move the other ships.
+	// Then, move the other ships. The part of their movement that involves no
+	// other ships is done first, in parallel, and the rest one ship at a time.
+	moving.clear();
 	for(const shared_ptr<Ship> &it : ships)
-	{
-		if(it == player.FlagshipPtr())
-			continue;
-		bool wasUntargetable = !it->IsTargetable();
-		MoveShip(it);
+		if(it != player.FlagshipPtr())
+			moving.push_back(it);
+	MoveShips();
+	for(size_t i = 0; i < moving.size(); ++i)
+	{
+		const shared_ptr<Ship> &it = moving[i];
+		const ShipMove &state = moveStates[i];
+		if(!state.isMoved)
+			StepShip(*it, moveStates[i], newVisuals, newFlotsam);
+		FinishMoveShip(it, state);
 		bool isTargetable = it->IsTargetable();
 		if(flagshipSystem == it->GetSystem()
-			&& ((wasUntargetable && isTargetable) || flagshipBecameTargetable)
+			&& ((state.wasUntargetable && isTargetable) || flagshipBecameTargetable)
 			&& isTargetable && flagshipIsTargetable)
 				eventQueue.emplace_back(player.FlagshipPtr(), it, ShipEvent::ENCOUNTER);
 	}
@@ -1620,7 +1809,7 @@ void Engine::CalculateStep()
 		const map<const Sound *, int> &jumpSounds = isJumping
 			? flagship->Attributes().JumpSounds() : flagship->Attributes().HyperSounds();
 		if(jumpSounds.empty())
-			Audio::Play(Audio::Get(isJumping ? "jump drive" : "hyperdrive"));
+			Audio::Play((isJumping ? JUMP_DRIVE_SOUND : HYPERDRIVE_SOUND).Get());
 		else
 			for(const auto &sound : jumpSounds)
 				Audio::Play(sound.first);
@@ -1649,6 +1838,7 @@ void Engine::CalculateStep()
 	}
 	Prune(ships);
 
+	allocationScope.Set("engine: objects");
 	// Move the asteroids. This must be done before collision detection. Minables
 	// may create visuals or flotsam.
 	asteroids.Step(newVisuals, newFlotsam, step);
@@ -1670,9 +1860,7 @@ void Engine::CalculateStep()
 	Prune(activeWeather);
 
 	// Move the visuals.
-	for(Visual &visual : visuals)
-		visual.Move();
-	Prune(visuals);
+	particles.Step();
 
 	// Perform various minor actions.
 	SpawnFleets();
@@ -1690,12 +1878,14 @@ void Engine::CalculateStep()
 	ships.splice(ships.end(), newShips);
 	Append(projectiles, newProjectiles);
 	flotsam.splice(flotsam.end(), newFlotsam);
-	Append(visuals, newVisuals);
+	particles.Add(newVisuals, step);
+	newVisuals.clear();
 
 	// Decrement the count of how long it's been since a ship last asked for help.
 	if(grudgeTime)
 		--grudgeTime;
 
+	allocationScope.Set("engine: collisions");
 	// Populate the collision detection lookup sets.
 	FillCollisionSets();
 
@@ -1722,6 +1912,7 @@ void Engine::CalculateStep()
 	for(const shared_ptr<Ship> &it : ships)
 		DoScanning(it);
 
+	allocationScope.Set("engine: draw lists");
 	// Draw the objects. Start by figuring out where the view should be centered:
 	Point newCenter = center;
 	Point newCenterVelocity;
@@ -1809,15 +2000,23 @@ void Engine::CalculateStep()
 	for(const Projectile &projectile : projectiles)
 		batchDraw[currentCalcBuffer].Add(projectile, projectile.Clip());
 	// Draw the visuals.
-	for(const Visual &visual : visuals)
-		batchDraw[currentCalcBuffer].AddVisual(visual);
+	particles.Add(visuals, step);
+	visuals.clear();
+	particles.Draw(batchDraw[currentCalcBuffer], step);
 
 	// Keep track of how much of the CPU time we are using.
-	loadSum += loadTimer.Time();
+	const double time = loadTimer.Time();
+	if(isInReplay && isReplaying)
+		replay->AddStepTime(time);
+	Telemetry::Add(Telemetry::Phase::CALCULATION, time);
+	loadSum += time;
+	allocationSum += AllocationCounter::Count() - allocationsBefore;
 	if(++loadCount == 60)
 	{
 		load = loadSum;
 		loadSum = 0.;
+		allocations = allocationSum / 60.;
+		allocationSum = 0;
 		loadCount = 0;
 	}
 }
@@ -1827,21 +2026,124 @@ void Engine::CalculateStep()
 // Move a ship. Also determine if the ship should generate hyperspace sounds or
 // boarding events, fire weapons, and launch fighters.
 void Engine::MoveShip(const shared_ptr<Ship> &ship)
+{
+	ShipMove state;
+	StepShip(*ship, state, newVisuals, newFlotsam);
+	FinishMoveShip(ship, state);
+}
+
+
+
+// Do the part of moving each ship (other than the flagship) that only involves
+// that ship and the ships it carries. The ships are split into contiguous runs
+// that are moved in parallel, each with its own buffers for the visuals and
+// flotsam it creates, and those are merged in ship order afterward. Each ship
+// reseeds the random number generator with a seed drawn in ship order, so the
+// results do not depend on which thread moved it.
+void Engine::MoveShips()
+{
+	const size_t count = moving.size();
+	moveStates.assign(count, ShipMove());
+
+	// Every ship moves with numbers from a seed of its own, drawn in the same
+	// order however many tasks there are, so that the outcome is the same on
+	// every platform and number of cores. Afterward, this thread continues from
+	// a seed of its own too.
+	for(ShipMove &state : moveStates)
+		state.seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	const uint64_t seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+
+	size_t tasks = 1;
+	if(Random::IsPerThread())
+		tasks = max<size_t>(1, min<size_t>(thread::hardware_concurrency(), count / SHIPS_PER_TASK));
+
+	if(moveOutputs.size() < tasks)
+		moveOutputs.resize(tasks);
+	auto moveRun = [this, count, tasks](size_t task)
+	{
+		MoveOutput &output = moveOutputs[task];
+		for(size_t i = task * count / tasks; i < (task + 1) * count / tasks; ++i)
+			// A ship that is docked in a carrier is moved along with the carrier,
+			// so it is left for the serial pass rather than touched by two threads.
+			if(moving[i]->GetSystem())
+			{
+				Random::Seed(moveStates[i].seed);
+				StepShip(*moving[i], moveStates[i], output.visuals, output.flotsam);
+			}
+	};
+	moveTasks.clear();
+	for(size_t task = 1; task < tasks; ++task)
+		moveTasks.push_back(queue.Run([moveRun, task] { moveRun(task); }));
+	// This function is itself running as a task, so rather than waiting for
+	// the queue to empty, do one run here and then wait for the others. They
+	// use this engine's state, so they must finish even if this run fails. No
+	// task is started while the queue is shutting down, and any ships it would
+	// have moved are left for the serial pass.
+	auto wait = [this]()
+	{
+		for(const shared_future<void> &task : moveTasks)
+			if(task.valid())
+				task.wait();
+	};
+	try {
+		moveRun(0);
+	}
+	catch(...)
+	{
+		wait();
+		throw;
+	}
+	wait();
+	Random::Seed(seed);
+
+	for(size_t task = 0; task < tasks; ++task)
+	{
+		MoveOutput &output = moveOutputs[task];
+		newVisuals.insert(newVisuals.end(),
+			make_move_iterator(output.visuals.begin()), make_move_iterator(output.visuals.end()));
+		output.visuals.clear();
+		newFlotsam.splice(newFlotsam.end(), output.flotsam);
+	}
+}
+
+
+
+// Do the part of moving a ship that only involves the ship itself, recording
+// what it was doing beforehand. This may be done for many ships at once, so it
+// must not change anything else in the engine.
+void Engine::StepShip(Ship &ship, ShipMove &state, vector<Visual> &visuals,
+	list<shared_ptr<Flotsam>> &flotsam) const
 {
 	// Various actions a ship could have taken last frame may have impacted the accuracy of cached values.
 	// Therefore, determine with any information needs recalculated and cache it.
-	ship->UpdateCaches();
+	ship.UpdateCaches();
 
 	const Ship *flagship = player.Flagship();
 
-	bool isJump = ship->IsUsingJumpDrive();
-	bool wasHere = (flagship && ship->GetSystem() == flagship->GetSystem());
-	bool wasHyperspacing = ship->IsHyperspacing();
-	bool wasDisabled = ship->IsDisabled();
+	state.isMoved = true;
+	state.isJump = ship.IsUsingJumpDrive();
+	state.wasHere = (flagship && ship.GetSystem() == flagship->GetSystem());
+	state.wasHyperspacing = ship.IsHyperspacing();
+	state.wasDisabled = ship.IsDisabled();
+	state.wasUntargetable = !ship.IsTargetable();
 	// Give the ship the list of visuals so that it can draw explosions,
 	// ion sparks, jump drive flashes, etc.
-	ship->Move(newVisuals, newFlotsam);
-	if(ship->IsDisabled() && !wasDisabled)
+	ship.MoveSelf(visuals, flotsam);
+}
+
+
+
+// Finish moving a ship, doing everything that involves other ships or the
+// rest of the engine.
+void Engine::FinishMoveShip(const shared_ptr<Ship> &ship, const ShipMove &state)
+{
+	ship->FinishMove(newVisuals);
+
+	const Ship *flagship = player.Flagship();
+	const bool isJump = state.isJump;
+	const bool wasHere = state.wasHere;
+	const bool wasHyperspacing = state.wasHyperspacing;
+	if(ship->IsDisabled() && !state.wasDisabled)
 		eventQueue.emplace_back(nullptr, ship, ShipEvent::DISABLE);
 	// Bail out if the ship just died.
 	if(ship->ShouldBeRemoved())
@@ -1871,7 +2173,7 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 			const map<const Sound *, int> &jumpSounds = isJump
 				? ship->Attributes().JumpOutSounds() : ship->Attributes().HyperOutSounds();
 			if(jumpSounds.empty())
-				Audio::Play(Audio::Get(isJump ? "jump out" : "hyperdrive out"), position);
+				Audio::Play((isJump ? JUMP_OUT_SOUND : HYPERDRIVE_OUT_SOUND).Get(), position);
 			else
 				for(const auto &sound : jumpSounds)
 					Audio::Play(sound.first, position);
@@ -1883,7 +2185,7 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 			const map<const Sound *, int> &jumpSounds = isJump
 				? ship->Attributes().JumpInSounds() : ship->Attributes().HyperInSounds();
 			if(jumpSounds.empty())
-				Audio::Play(Audio::Get(isJump ? "jump in" : "hyperdrive in"), position);
+				Audio::Play((isJump ? JUMP_IN_SOUND : HYPERDRIVE_IN_SOUND).Get(), position);
 			else
 				for(const auto &sound : jumpSounds)
 					Audio::Play(sound.first, position);
@@ -2377,6 +2679,7 @@ void Engine::HandleMouseInput(Command &activeCommands)
 	double relX = mousePosX - Screen::RawWidth() / 2.0;
 	double relY = mousePosY - Screen::RawHeight() / 2.0;
 	ai.SetMousePosition(Point(relX, relY));
+	replayFrame.mouse = Point(relX, relY);
 
 	// Activate firing command.
 	if(isMouseTurningEnabled && rightMouseButtonHeld)
@@ -2393,6 +2696,106 @@ void Engine::HandleGamepadInput(Command& activeCommands)
 
 
 
+// Start recording or playing back the player's inputs when they take off,
+// or end a recording that is in progress.
+void Engine::BeginReplay()
+{
+	// A recording only covers a single flight, from a take-off to a landing.
+	// It normally ends when the player lands, but end it here in case the
+	// player took off again without the planet panel being shown.
+	if(replayStart >= 0)
+	{
+		EndReplay();
+		return;
+	}
+
+	// The recording starts with the player about to take off, so that playing
+	// it back places all the ships in exactly the same way.
+	if(!isReplaying)
+		replay->Begin((static_cast<uint64_t>(Random::Int()) << 32) | Random::Int(), player.SaveToString());
+	Random::Seed(replay->Seed());
+	replayStart = step;
+	replayFrame = Replay::Frame();
+	replayPointer = GetPointer();
+}
+
+
+
+void Engine::EndReplay()
+{
+	if(!isReplaying && !Files::WriteAtomic(recordingPath, replay->ToString()))
+		Logger::LogError("Unable to save the recording to \"" + recordingPath + "\".");
+	replay.reset();
+	replayStart = -1;
+}
+
+
+
+// Record the keyboard and pointer inputs for the next step, or replace
+// them with the ones that were recorded.
+void Engine::StepReplay()
+{
+	// The inputs given now are acted on in the next call to CalculateStep().
+	const int replayStep = step + 1 - replayStart;
+	if(isReplaying)
+	{
+		const Replay::Frame frame = replay->Get(replayStep);
+		activeCommands = frame.keys;
+		if(frame.hasPointer)
+			SetPointer(frame.pointer);
+		return;
+	}
+
+	replayFrame = Replay::Frame();
+	replayFrame.keys = activeCommands;
+	const Replay::Pointer pointer = GetPointer();
+	if(pointer != replayPointer)
+	{
+		replayFrame.hasPointer = true;
+		replayFrame.pointer = pointer;
+	}
+}
+
+
+
+Replay::Pointer Engine::GetPointer() const
+{
+	Replay::Pointer pointer;
+	pointer.doClickNextStep = doClickNextStep;
+	pointer.hasShift = hasShift;
+	pointer.hasControl = hasControl;
+	pointer.isRightClick = isRightClick;
+	pointer.isRadarClick = isRadarClick;
+	pointer.isTouch = isTouch;
+	pointer.isDoubleTap = isDoubleTap;
+	pointer.isFingerDown = isFingerDown;
+	pointer.groupSelect = groupSelect;
+	pointer.clickPoint = clickPoint;
+	pointer.uiClickBox = uiClickBox;
+	pointer.clickBox = clickBox;
+	return pointer;
+}
+
+
+
+void Engine::SetPointer(const Replay::Pointer &pointer)
+{
+	doClickNextStep = pointer.doClickNextStep;
+	hasShift = pointer.hasShift;
+	hasControl = pointer.hasControl;
+	isRightClick = pointer.isRightClick;
+	isRadarClick = pointer.isRadarClick;
+	isTouch = pointer.isTouch;
+	isDoubleTap = pointer.isDoubleTap;
+	isFingerDown = pointer.isFingerDown;
+	groupSelect = pointer.groupSelect;
+	clickPoint = pointer.clickPoint;
+	uiClickBox = pointer.uiClickBox;
+	clickBox = pointer.clickBox;
+}
+
+
+
 // Convert a joystick movement vector into actual flagship commands
 void Engine::HandleJoystickMovement(const Point& p)
 {
@@ -2436,7 +2839,7 @@ void Engine::DoCollisions(Projectile &projectile)
 	// The asteroids can collide with projectiles, the same as any other
 	// object. If the asteroid turns out to be closer than the ship, it
 	// shields the ship (unless the projectile has a blast radius).
-	vector<Collision> collisions;
+	collisions.clear();
 	const Government *gov = projectile.GetGovernment();
 	const Weapon &weapon = projectile.GetWeapon();
 
@@ -2462,8 +2865,7 @@ void Engine::DoCollisions(Projectile &projectile)
 		double triggerRadius = weapon.TriggerRadius();
 		if(triggerRadius)
 		{
-			vector<Body *> inRadius;
-			inRadius.reserve(min(static_cast<vector<Body *>::size_type>(triggerRadius), ships.size()));
+			inRadius.clear();
 			shipCollisions.Circle(projectile.Position(), triggerRadius, inRadius);
 			for(const Body *body : inRadius)
 			{
@@ -2528,20 +2930,27 @@ void Engine::DoCollisions(Projectile &projectile)
 			// "safe" weapon.
 			Point hitPos = projectile.Position() + range * projectile.Velocity();
 			bool isSafe = weapon.IsSafe();
-			vector<Body *> blastCollisions;
-			blastCollisions.reserve(32);
-			shipCollisions.Circle(hitPos, blastRadius, blastCollisions);
-			for(Body *body : blastCollisions)
+			inRadius.clear();
+			shipCollisions.Circle(hitPos, blastRadius, inRadius);
+			damaged.clear();
+			for(Body *body : inRadius)
 			{
 				Ship *ship = reinterpret_cast<Ship *>(body);
 				bool targeted = (projectile.Target() == ship);
 				// Phasing cloaked ship will have a chance to ignore the effects of the explosion.
 				if((isSafe && !targeted && !gov->IsEnemy(ship->GetGovernment())) || ship->Phases(projectile))
 					continue;
+				damaged.push_back(ship);
+			}
 
+			// Calculate the damage to every ship in the blast at once, then apply it.
+			damage.CalculateDamage(damaged, hit, damageDealt);
+			for(size_t i = 0; i < damaged.size(); ++i)
+			{
+				Ship *ship = damaged[i];
+				bool targeted = (projectile.Target() == ship);
 				// Only directly targeted ships get provoked by blast weapons.
-				int eventType = ship->TakeDamage(visuals, damage.CalculateDamage(*ship, ship == hit),
-					targeted ? gov : nullptr);
+				int eventType = ship->TakeDamage(visuals, damageDealt[i], targeted ? gov : nullptr);
 				if(eventType)
 					eventQueue.emplace_back(gov, ship->shared_from_this(), eventType);
 			}
@@ -2601,11 +3010,12 @@ void Engine::DoWeather(Weather &weather)
 			affectedShips.reserve(ships.size());
 			shipCollisions.Ring(weather.Origin(), hazard->MinRange(), hazard->MaxRange(), affectedShips);
 		}
+		damaged.clear();
 		for(Body *body : affectedShips)
-		{
-			Ship *hit = reinterpret_cast<Ship *>(body);
-			hit->TakeDamage(visuals, damage.CalculateDamage(*hit), nullptr);
-		}
+			damaged.push_back(reinterpret_cast<Ship *>(body));
+		damage.CalculateDamage(damaged, nullptr, damageDealt);
+		for(size_t i = 0; i < damaged.size(); ++i)
+			damaged[i]->TakeDamage(visuals, damageDealt[i], nullptr);
 	}
 }
 
@@ -2763,17 +3173,20 @@ void Engine::FillRadar()
 {
 	const Ship *flagship = player.Flagship();
 	const System *playerSystem = player.GetSystem();
+	// If the HUD has no radar, there is no need to fill it, but hostile ships
+	// must still be noticed so the alarm can sound.
+	const bool showRadar = GameData::Interfaces().Get("hud")->HasPoint("radar");
 
 	// Add stellar objects.
 	for(const StellarObject &object : playerSystem->Objects())
-		if(object.HasSprite())
+		if(showRadar && object.HasSprite())
 		{
 			double r = max(2., object.Radius() * .03 + .5);
 			radar[currentCalcBuffer].Add(object.RadarType(flagship), object.Position(), r, r - 1.);
 		}
 
 	// Add pointers for neighboring systems.
-	if(flagship)
+	if(showRadar && flagship)
 	{
 		const System *targetSystem = flagship->GetTargetSystem();
 		const set<const System *> &links = (flagship->JumpNavigation().HasJumpDrive()) ?
@@ -2786,7 +3199,7 @@ void Engine::FillRadar()
 	}
 
 	// Add viewport brackets.
-	if(!Preferences::Has("Disable viewport on radar"))
+	if(showRadar && !Preferences::Has("Disable viewport on radar"))
 	{
 		radar[currentCalcBuffer].AddViewportBoundary(Screen::TopLeft() / zoom);
 		radar[currentCalcBuffer].AddViewportBoundary(Screen::TopRight() / zoom);
@@ -2804,13 +3217,16 @@ void Engine::FillRadar()
 			if(ship->IsCloaked() && !isYours)
 				continue;
 
-			// Figure out what radar color should be used for this ship.
-			bool isYourTarget = (flagship && ship == flagship->GetTargetShip());
-			int type = isYourTarget ? Radar::SPECIAL : RadarType(*ship, step);
-			// Calculate how big the radar dot should be.
-			double size = sqrt(ship->Width() + ship->Height()) * .14 + .5;
+			if(showRadar)
+			{
+				// Figure out what radar color should be used for this ship.
+				bool isYourTarget = (flagship && ship == flagship->GetTargetShip());
+				int type = isYourTarget ? Radar::SPECIAL : RadarType(*ship, step);
+				// Calculate how big the radar dot should be.
+				double size = sqrt(ship->Width() + ship->Height()) * .14 + .5;
 
-			radar[currentCalcBuffer].Add(type, ship->Position(), size);
+				radar[currentCalcBuffer].Add(type, ship->Position(), size);
+			}
 
 			// Check if this is a hostile ship.
 			hasHostiles |= (!ship->IsDisabled() && ship->GetGovernment()->IsEnemy()
@@ -2822,7 +3238,7 @@ void Engine::FillRadar()
 	else if(hasHostiles && !hadHostiles)
 	{
 		if(Preferences::PlayAudioAlert())
-			Audio::Play(Audio::Get("alarm"));
+			Audio::Play(ALARM_SOUND.Get());
 		alarmTime = 300;
 		hadHostiles = true;
 	}
@@ -2830,17 +3246,18 @@ void Engine::FillRadar()
 		hadHostiles = false;
 
 	// Add projectiles that have a missile strength or homing.
-	for(Projectile &projectile : projectiles)
-	{
-		if(projectile.MissileStrength())
+	if(showRadar)
+		for(Projectile &projectile : projectiles)
 		{
-			bool isEnemy = projectile.GetGovernment() && projectile.GetGovernment()->IsEnemy();
-			radar[currentCalcBuffer].Add(
-				isEnemy ? Radar::SPECIAL : Radar::INACTIVE, projectile.Position(), 1.);
+			if(projectile.MissileStrength())
+			{
+				bool isEnemy = projectile.GetGovernment() && projectile.GetGovernment()->IsEnemy();
+				radar[currentCalcBuffer].Add(
+					isEnemy ? Radar::SPECIAL : Radar::INACTIVE, projectile.Position(), 1.);
+			}
+			else if(projectile.GetWeapon().BlastRadius())
+				radar[currentCalcBuffer].Add(Radar::SPECIAL, projectile.Position(), 1.8);
 		}
-		else if(projectile.GetWeapon().BlastRadius())
-			radar[currentCalcBuffer].Add(Radar::SPECIAL, projectile.Position(), 1.8);
-	}
 }
 
 
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define ENGINE_H_
 
 #include "AI.h"
+#include "AllocationCounter.h"
 #include "AlertLabel.h"
 #include "AmmoDisplay.h"
 #include "AsteroidField.h"
@@ -24,22 +25,28 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "CollisionSet.h"
 #include "Color.h"
 #include "Command.h"
+#include "DamageDealt.h"
 #include "DrawList.h"
 #include "EscortDisplay.h"
 #include "Information.h"
+#include "ParticleSystem.h"
 #include "PlanetLabel.h"
 #include "Point.h"
 #include "Preferences.h"
 #include "Projectile.h"
 #include "Radar.h"
 #include "Rectangle.h"
+#include "Replay.h"
 #include "TaskQueue.h"
 
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -83,6 +90,21 @@ public:
 	// Give a command on behalf of the player, used for integration tests.
 	void GiveCommand(const Command &command);
 
+	// Record the player's inputs from the next take-off until they land again,
+	// and then save the recording to the given file. This does nothing if a
+	// recording has already been requested or begun.
+	void Record(const std::string &path);
+	// Check if the player's inputs are being recorded in this flight.
+	bool IsRecording() const;
+	// Play the given recording back instead of reading the player's inputs,
+	// beginning with the next take-off.
+	void Play(const std::shared_ptr<Replay> &replay);
+	// Check if every step of the recording being played back has been run.
+	bool IsReplayDone() const;
+	// Stop recording or playing back the player's inputs because they have
+	// landed, saving any recording to its file.
+	void EndFlight();
+
 	// Get any special events that happened in this step.
 	// MainPanel::Step will clear this list.
 	std::list<ShipEvent> &Events();
@@ -148,6 +170,25 @@ private:
 		double angle;
 	};
 
+	// The state of a ship before it moved, to compare with its state afterward.
+	class ShipMove {
+	public:
+		uint64_t seed = 0;
+		bool isMoved = false;
+		bool isJump = false;
+		bool wasHere = false;
+		bool wasHyperspacing = false;
+		bool wasDisabled = false;
+		bool wasUntargetable = false;
+	};
+
+	// The visuals and flotsam created by ships that are moved on another thread.
+	class MoveOutput {
+	public:
+		std::vector<Visual> visuals;
+		std::list<std::shared_ptr<Flotsam>> flotsam;
+	};
+
 	class Zoom {
 	public:
 		constexpr Zoom() : base(0.) {}
@@ -166,6 +207,10 @@ private:
 	void CalculateStep();
 
 	void MoveShip(const std::shared_ptr<Ship> &ship);
+	void MoveShips();
+	void StepShip(Ship &ship, ShipMove &state, std::vector<Visual> &visuals,
+		std::list<std::shared_ptr<Flotsam>> &flotsam) const;
+	void FinishMoveShip(const std::shared_ptr<Ship> &ship, const ShipMove &state);
 
 	void SpawnFleets();
 	void SpawnPersons();
@@ -176,6 +221,15 @@ private:
 	void HandleTouchEvents();
 	void HandleMouseInput(Command &activeCommands);
 	void HandleGamepadInput(Command &activeCommands);
+	// Start recording or playing back the player's inputs when they take off,
+	// or end a recording that is in progress.
+	void BeginReplay();
+	void EndReplay();
+	// Record the keyboard and pointer inputs for the next step, or replace
+	// them with the ones that were recorded.
+	void StepReplay();
+	Replay::Pointer GetPointer() const;
+	void SetPointer(const Replay::Pointer &pointer);
 
 	void FillCollisionSets();
 
@@ -203,7 +257,7 @@ private:
 	std::vector<Projectile> projectiles;
 	std::vector<Weather> activeWeather;
 	std::list<std::shared_ptr<Flotsam>> flotsam;
-	std::vector<Visual> visuals;
+	ParticleSystem particles;
 	AsteroidField asteroids;
 
 	// New objects created within the latest step:
@@ -211,12 +265,40 @@ private:
 	std::vector<Projectile> newProjectiles;
 	std::list<std::shared_ptr<Flotsam>> newFlotsam;
 	std::vector<Visual> newVisuals;
+	// Visuals created by collisions, which are drawn this step but (like the
+	// new visuals) only become particles that move starting next step.
+	std::vector<Visual> visuals;
 
 	// Track which ships currently have anti-missiles or
 	// tractor beams ready to fire.
 	std::vector<Ship *> hasAntiMissile;
 	std::vector<Ship *> hasTractorBeam;
 
+	// Scratch space for finding what each projectile collides with. These are
+	// kept between steps so that their memory is reused instead of reallocated.
+	std::vector<Collision> collisions;
+	std::vector<Body *> inRadius;
+	// The ships damaged by a blast or hazard, and the damage each one takes.
+	std::vector<Ship *> damaged;
+	std::vector<DamageDealt> damageDealt;
+	// The ships other than the flagship that are moving this step, what each
+	// of them was doing before it moved, and what the tasks moving them made.
+	std::vector<std::shared_ptr<Ship>> moving;
+	std::vector<ShipMove> moveStates;
+	std::vector<MoveOutput> moveOutputs;
+	std::vector<std::shared_future<void>> moveTasks;
+
+	// A recording of the player's inputs that is being made or played back,
+	// and the step it began at (or -1 if the player has not taken off yet).
+	std::shared_ptr<Replay> replay;
+	std::string recordingPath;
+	bool isReplaying = false;
+	int replayStart = -1;
+	// The inputs for the step that is being calculated, and what the pointer
+	// state will be in the next step if the player does not touch it.
+	Replay::Frame replayFrame;
+	Replay::Pointer replayPointer;
+
 	AI ai;
 
 	TaskQueue queue;
@@ -310,6 +392,14 @@ private:
 	double load = 0.;
 	int loadCount = 0;
 	double loadSum = 0.;
+	// In debug builds, the average number of heap allocations in each step.
+	double allocations = 0.;
+	uint64_t allocationSum = 0;
+	// In debug builds, the allocations made with each tag in each frame,
+	// averaged over the last 60 frames, and the totals they were taken from.
+	std::vector<AllocationCounter::Tally> allocationRates;
+	std::vector<AllocationCounter::Tally> allocationTotals;
+	int allocationFrames = 0;
 };
 
 
@@ -0,0 +1,73 @@
+/* EpochCounter.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef EPOCH_COUNTER_H_
+#define EPOCH_COUNTER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+
+
+// A number that changes every time the object that owns it changes, so that
+// values computed from that object can be cached until it does. Every epoch is
+// drawn from a single global sequence, so no two different states of any
+// objects ever share one (unless one object is a copy of the other), and an
+// epoch is never 0. A counter may also be part of a larger one, such as that
+// of a fleet, which is then bumped whenever it is, so that the larger one can
+// be checked without checking everything that is part of it.
+class EpochCounter {
+public:
+	EpochCounter() noexcept : value(Next()) {}
+	EpochCounter(const EpochCounter &other) noexcept : value(other.Value()), partOf(other.partOf) {}
+	EpochCounter &operator=(const EpochCounter &other) noexcept
+	{
+		value = other.Value();
+		partOf = other.partOf;
+		return *this;
+	}
+
+	// Mark the owner as having changed, and so also whatever it is part of.
+	// Any number of threads may bump the same larger counter at once.
+	void Bump() noexcept
+	{
+		value = Next();
+		if(std::shared_ptr<EpochCounter> whole = partOf.lock())
+			whole->Bump();
+	}
+	uint64_t Value() const noexcept { return value; }
+
+	// Bump the given counter too whenever this one is bumped. Copies of this
+	// counter are part of the same one.
+	void SetPartOf(const std::shared_ptr<EpochCounter> &whole) noexcept { partOf = whole; }
+
+
+private:
+	static uint64_t Next() noexcept
+	{
+		static std::atomic<uint64_t> last = 0;
+		return ++last;
+	}
+
+
+private:
+	std::atomic<uint64_t> value;
+	std::weak_ptr<EpochCounter> partOf;
+};
+
+
+
+#endif
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "File.h"
 #include "Logger.h"
+#include "ZipArchive.h"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_rwops.h>
@@ -26,17 +27,22 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define STRICT
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <io.h>
 #else
 #include <dirent.h>
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <utime.h>
 #endif
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <mutex>
 #include <stdexcept>
 #include <memory>
@@ -59,6 +65,133 @@ namespace {
 
 	File errorLog;
 
+	// Zip archives mounted as directories, keyed by the archive's path plus a
+	// trailing '/'. Archives are never unmounted, so once found they can be
+	// used without holding the lock.
+	map<string, unique_ptr<const ZipArchive>> archives;
+	mutex archiveMutex;
+
+	// If the given path is inside a mounted archive, return that archive and
+	// store the rest of the path in the given name.
+	const ZipArchive *FindArchive(const string &path, string &name)
+	{
+		lock_guard<mutex> lock(archiveMutex);
+		// Any mount point containing this path is the last one that sorts before it.
+		auto it = archives.upper_bound(path);
+		if(it == archives.begin())
+			return nullptr;
+		--it;
+		if(path.compare(0, it->first.size(), it->first))
+			return nullptr;
+
+		name = path.substr(it->first.size());
+		return it->second.get();
+	}
+
+	// Lists of every file inside of a directory, keyed by that directory, that
+	// are used in place of scanning it. The lists are sorted and never change.
+	map<string, vector<string>> manifests;
+	mutex manifestMutex;
+
+	// Find the manifest covering the given directory, if there is one, and
+	// add every file it lists as being inside that directory.
+	bool ListFromManifest(const string &directory, vector<string> &list)
+	{
+		lock_guard<mutex> lock(manifestMutex);
+		if(manifests.empty())
+			return false;
+
+		// Manifests may be nested, so check the most specific directory first.
+		for(size_t end = directory.size(); end > 1; end = directory.rfind('/', end - 2) + 1)
+		{
+			auto it = manifests.find(directory.substr(0, end));
+			if(it == manifests.end())
+				continue;
+
+			const string &root = it->first;
+			const vector<string> &files = it->second;
+			string prefix = directory.substr(end);
+			for(auto file = lower_bound(files.begin(), files.end(), prefix); file != files.end(); ++file)
+			{
+				if(file->compare(0, prefix.size(), prefix))
+					break;
+				list.push_back(root + *file);
+			}
+			return true;
+		}
+		return false;
+	}
+
+	// The contents of a file read out of an archive, and the read position,
+	// for use by an SDL_RWops that owns them.
+	struct ArchiveFile {
+		string data;
+		size_t position = 0;
+	};
+
+	ArchiveFile &GetArchiveFile(SDL_RWops *ops)
+	{
+		return *static_cast<ArchiveFile *>(ops->hidden.unknown.data1);
+	}
+
+	Sint64 SDLCALL ArchiveFileSize(SDL_RWops *ops)
+	{
+		return GetArchiveFile(ops).data.size();
+	}
+
+	Sint64 SDLCALL ArchiveFileSeek(SDL_RWops *ops, Sint64 offset, int whence)
+	{
+		ArchiveFile &file = GetArchiveFile(ops);
+		Sint64 size = file.data.size();
+		Sint64 base = (whence == RW_SEEK_SET ? 0 : whence == RW_SEEK_CUR ? file.position : size);
+		if(base + offset < 0)
+			return SDL_SetError("Seeking before the start of a file.");
+
+		file.position = min(base + offset, size);
+		return file.position;
+	}
+
+	size_t SDLCALL ArchiveFileRead(SDL_RWops *ops, void *ptr, size_t size, size_t count)
+	{
+		ArchiveFile &file = GetArchiveFile(ops);
+		if(!size)
+			return 0;
+		count = min(count, (file.data.size() - file.position) / size);
+		memcpy(ptr, file.data.data() + file.position, count * size);
+		file.position += count * size;
+		return count;
+	}
+
+	size_t SDLCALL ArchiveFileWrite(SDL_RWops *, const void *, size_t, size_t)
+	{
+		SDL_SetError("Files inside of archives are read-only.");
+		return 0;
+	}
+
+	int SDLCALL ArchiveFileClose(SDL_RWops *ops)
+	{
+		delete &GetArchiveFile(ops);
+		SDL_FreeRW(ops);
+		return 0;
+	}
+
+	// Wrap a file read from an archive in an SDL_RWops, so that it can be used
+	// the same way as one opened from the disk.
+	SDL_RWops *OpenArchiveFile(string &&data)
+	{
+		SDL_RWops *ops = SDL_AllocRW();
+		if(!ops)
+			return nullptr;
+		ops->size = ArchiveFileSize;
+		ops->seek = ArchiveFileSeek;
+		ops->read = ArchiveFileRead;
+		ops->write = ArchiveFileWrite;
+		ops->close = ArchiveFileClose;
+		ops->type = SDL_RWOPS_UNKNOWN;
+		ops->hidden.unknown.data1 = new ArchiveFile{std::move(data)};
+		return ops;
+	}
+
 	// Convert windows-style directory separators ('\\') to standard '/'.
 #if defined _WIN32
 	void FixWindowsSlashes(string &path)
@@ -393,6 +526,13 @@ vector<string> Files::List(string directory)
 		directory += '/';
 
 	vector<string> list;
+	string name;
+	if(const ZipArchive *archive = FindArchive(directory, name))
+	{
+		for(const string &file : archive->List(name))
+			list.push_back(directory + file.substr(name.size()));
+		return list;
+	}
 
 #if defined _WIN32
 	WIN32_FIND_DATAW ffd;
@@ -467,6 +607,13 @@ vector<string> Files::ListDirectories(string directory)
 		directory += '/';
 
 	vector<string> list;
+	string name;
+	if(const ZipArchive *archive = FindArchive(directory, name))
+	{
+		for(const string &subdirectory : archive->ListDirectories(name))
+			list.push_back(directory + subdirectory.substr(name.size()));
+		return list;
+	}
 
 #if defined _WIN32
 	WIN32_FIND_DATAW ffd;
@@ -548,11 +695,32 @@ vector<string> Files::RecursiveList(const string &directory)
 
 
 
+void Files::AddManifest(string directory, vector<string> files)
+{
+	if(directory.empty() || directory.back() != '/')
+		directory += '/';
+
+	lock_guard<mutex> lock(manifestMutex);
+	manifests[std::move(directory)] = std::move(files);
+}
+
+
+
 void Files::RecursiveList(string directory, vector<string> *list)
 {
 	if(directory.empty() || directory.back() != '/')
 		directory += '/';
 
+	string name;
+	if(const ZipArchive *archive = FindArchive(directory, name))
+	{
+		for(const string &file : archive->List(name, true))
+			list->push_back(directory + file.substr(name.size()));
+		return;
+	}
+	if(ListFromManifest(directory, *list))
+		return;
+
 #if defined _WIN32
 	WIN32_FIND_DATAW ffd;
 	HANDLE hFind = FindFirstFileW(Utf8::ToUTF16(directory + '*').c_str(), &ffd);
@@ -635,6 +803,10 @@ void Files::RecursiveList(string directory, vector<string> *list)
 
 bool Files::Exists(const string &filePath)
 {
+	string name;
+	if(const ZipArchive *archive = FindArchive(filePath, name))
+		return archive->HasFile(name) || archive->HasDirectory(name);
+
 #if defined _WIN32
 	struct _stat buf;
 	return !_wstat(Utf8::ToUTF16(filePath).c_str(), &buf);
@@ -665,12 +837,20 @@ bool Files::Exists(const string &filePath)
 
 time_t Files::Timestamp(const string &filePath)
 {
+	// Files inside of an archive are as old as the archive itself.
+	string name;
+	const ZipArchive *archive = FindArchive(filePath, name);
+	const string &path = archive ? archive->Path() : filePath;
+	// Windows can't stat a directory if its path ends in a separator.
+	size_t length = path.size() - (path.size() > 1 && path.back() == '/');
 #if defined _WIN32
 	struct _stat buf;
-	_wstat(Utf8::ToUTF16(filePath).c_str(), &buf);
+	if(_wstat(Utf8::ToUTF16(path.substr(0, length)).c_str(), &buf))
+		return 0;
 #else
 	struct stat buf;
-	stat(filePath.c_str(), &buf);
+	if(stat(path.substr(0, length).c_str(), &buf))
+		return 0;
 #endif
 	return buf.st_mtime;
 }
@@ -737,6 +917,13 @@ string Files::Name(const string &path)
 
 struct SDL_RWops *Files::Open(const string &path, bool write)
 {
+	string name;
+	if(const ZipArchive *archive = FindArchive(path, name))
+	{
+		if(write || !archive->HasFile(name))
+			return nullptr;
+		return OpenArchiveFile(archive->Read(name));
+	}
 	return SDL_RWFromFile(path.c_str(), write ? "wb" : "rb");
 }
 
@@ -751,6 +938,11 @@ void Files::Close(struct SDL_RWops * ops)
 
 string Files::Read(const string &path)
 {
+	// Skip the extra copy through an SDL_RWops for files inside an archive.
+	string name;
+	if(const ZipArchive *archive = FindArchive(path, name))
+		return archive->Read(name);
+
 	File file(path);
 	return Read(file);
 }
@@ -800,6 +992,66 @@ void Files::Write(struct SDL_RWops *file, const string &data)
 
 
 
+// Add the data to the end of the given file, creating it if need be.
+void Files::Append(const string &path, const string &data)
+{
+	// Files inside an archive cannot be written to.
+	string name;
+	if(FindArchive(path, name))
+		return;
+
+	SDL_RWops *file = SDL_RWFromFile(path.c_str(), "ab");
+	Write(file, data);
+	if(file)
+		SDL_RWclose(file);
+}
+
+
+
+bool Files::WriteAtomic(const string &path, const string &data)
+{
+	// The temporary file does not end in ".txt", so it is never mistaken for a
+	// saved game if it is left behind by a crash.
+	const string temp = path + ".tmp";
+#if defined _WIN32
+	FILE *file = _wfopen(Utf8::ToUTF16(temp).c_str(), L"wb");
+	if(!file)
+		return false;
+	bool written = (fwrite(data.data(), 1, data.size(), file) == data.size());
+	written &= !fflush(file) && !_commit(_fileno(file));
+	fclose(file);
+	if(written)
+		written = MoveFileExW(Utf8::ToUTF16(temp).c_str(), Utf8::ToUTF16(path).c_str(),
+			MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	if(fd < 0)
+		return false;
+	bool written = true;
+	for(size_t offset = 0; written && offset < data.size(); )
+	{
+		ssize_t count = write(fd, data.data() + offset, data.size() - offset);
+		if(count > 0)
+			offset += count;
+		else
+			written = (count < 0 && errno == EINTR);
+	}
+	// Make sure the contents are on disk before the rename makes them visible.
+	written &= !fsync(fd);
+	written &= !close(fd);
+	if(written)
+		written = !rename(temp.c_str(), path.c_str());
+#endif
+	if(!written)
+	{
+		Logger::LogError("Error: Unable to write \"" + path + "\".");
+		Delete(temp);
+	}
+	return written;
+}
+
+
+
 void Files::CreateFolder(const std::string &path)
 {
 	if(Exists(path))
@@ -920,6 +1172,15 @@ bool Files::MakeDir(const std::string &path)
 
 bool Files::RmDir(const std::string &path)
 {
+	// A directory inside of a mounted archive can only be removed by deleting
+	// the archive that holds it.
+	string name;
+	if(const ZipArchive *archive = FindArchive(path, name))
+	{
+		Delete(archive->Path());
+		return !Exists(archive->Path());
+	}
+
 	// SDL doesn't expose a file system api for deleting directories. We need to
 	// use operating system primitives here.
 #ifndef _WIN32
@@ -962,3 +1223,24 @@ bool Files::RmDir(const std::string &path)
 	return false;
 #endif
 }
+
+
+
+bool Files::MountArchive(const string &archivePath)
+{
+	string mountPoint = archivePath + '/';
+	{
+		lock_guard<mutex> lock(archiveMutex);
+		if(archives.count(mountPoint))
+			return true;
+	}
+
+	// Parsing the archive's directory can be slow, so don't hold the lock for it.
+	auto archive = make_unique<const ZipArchive>(archivePath);
+	if(!archive->IsValid())
+		return false;
+
+	lock_guard<mutex> lock(archiveMutex);
+	archives.emplace(std::move(mountPoint), std::move(archive));
+	return true;
+}
@@ -52,6 +52,10 @@ public:
 	// that it contains, recursively.
 	static std::vector<std::string> RecursiveList(const std::string &directory);
 	static void RecursiveList(std::string directory, std::vector<std::string> *list);
+	// From now on, answer RecursiveList for the given directory, or anything
+	// inside of it, from this sorted list of the files it holds (relative to
+	// the directory) instead of scanning the disk.
+	static void AddManifest(std::string directory, std::vector<std::string> files);
 
 	static bool Exists(const std::string &filePath);
 	static std::time_t Timestamp(const std::string &filePath);
@@ -61,6 +65,13 @@ public:
 	static bool MakeDir(const std::string &path);
 	static bool RmDir(const std::string &path);
 
+	// Make the contents of the given zip file readable as if it were a directory
+	// of the same name, e.g. "plugins/name.zip/data/map.txt". Listing, checking
+	// for, and reading files all see into mounted archives, so nothing that
+	// loads game data needs to know where its files come from. Returns false
+	// if the file is not a readable zip archive.
+	static bool MountArchive(const std::string &archivePath);
+
 	// Get the filename from a path.
 	static std::string Name(const std::string &path);
 
@@ -71,6 +82,13 @@ public:
 	static std::string Read(struct SDL_RWops *file);
 	static void Write(const std::string &path, const std::string &data);
 	static void Write(struct SDL_RWops *file, const std::string &data);
+	// Add the data to the end of the given file, creating it if need be.
+	static void Append(const std::string &path, const std::string &data);
+	// Write the data to a temporary file next to the given path, flush it to
+	// disk, and then rename it over the original. If the process dies at any
+	// point, the file holds either its old or its new contents, never a mix.
+	// Returns false if the new contents could not be written.
+	static bool WriteAtomic(const std::string &path, const std::string &data);
 	static void CreateFolder(const std::string &path);
 
 	// Open this user's plugins directory in their native file explorer.
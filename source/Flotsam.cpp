@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Flotsam.h"
 
 #include "Angle.h"
+#include "AssetHandle.h"
 #include "Effect.h"
 #include "GameData.h"
 #include "Outfit.h"
@@ -28,6 +29,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	const AssetHandle<Effect> FLOTSAM_DEATH("flotsam death");
+}
+
 
 
 const int Flotsam::TONS_PER_BOX = 5;
@@ -105,7 +110,7 @@ void Flotsam::Move(vector<Visual> &visuals)
 		return;
 
 	// This flotsam has reached the end of its life.
-	const Effect *effect = GameData::Effects().Get("flotsam death");
+	const Effect *effect = FLOTSAM_DEATH.Get();
 	for(int i = 0; i < 3; ++i)
 	{
 		Angle smokeAngle = Angle::Random();
@@ -26,21 +26,24 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <limits>
+#include <utility>
 #include <vector>
 
 using namespace std;
 
 namespace {
-	// Scale of the mask image:
+	// Scale of the mask image, in map units per pixel:
 	const int GRID = 16;
 	// Distance represented by one orthogonal or diagonal step:
 	const int ORTH = 5;
 	const int DIAG = 7;
 	// Limit distances to the size of an unsigned char.
 	const int LIMIT = 255;
-	// Pad beyond the screen enough to include any system that might "cast light"
-	// on the on-screen view.
-	const int PAD = LIMIT / ORTH;
+	// The largest texture that every device is guaranteed to support. A galaxy
+	// too large to fit in it at the usual scale is drawn at a coarser one.
+	const int MAX_SIZE = 2048;
 
 	// OpenGL objects:
 	Shader shader;
@@ -50,14 +53,240 @@ namespace {
 	GLuint vbo;
 	GLuint texture = 0;
 
-	// Keep track of the previous frame's view so that if it is unchanged we can
-	// skip regenerating the mask.
-	double previousZoom = 0.;
-	double previousLeft = 0.;
-	double previousTop = 0.;
-	int previousColumns = 0;
-	int previousRows = 0;
-	Point previousCenter;
+	// The fog is computed once for the whole galaxy, in map coordinates, rather
+	// than for the part of it that is on screen, so panning and zooming the map
+	// only changes where it is drawn. This is the map position of the center
+	// of the first pixel, the size of the image, and the size of each pixel.
+	Point origin;
+	int columns = 0;
+	int rows = 0;
+	int scale = 1;
+	// How far each pixel is from the nearest system the player can view, and
+	// the shading that is uploaded for it.
+	vector<unsigned char> distance;
+	vector<unsigned char> shading;
+	// The pixels that contain a system the player can view, in sorted order.
+	vector<int> lit;
+
+	// The fog is only checked for changes when the map is opened, or when the
+	// player moves to another system.
+	bool shouldUpdate = true;
+	const System *previousSystem = nullptr;
+
+
+	// Stretch the distance values so there is no shading up to about 200 pixels
+	// away, then it transitions somewhat quickly.
+	unsigned char Shade(int value)
+	{
+		return max(0, min(LIMIT, (value - 60) * 4));
+	}
+
+
+	// Lay out the image so that it covers every system, plus enough pixels
+	// around them that the edges are completely fogged. Returns true if the
+	// layout is different than it was before.
+	bool Layout()
+	{
+		double minX = numeric_limits<double>::infinity();
+		double minY = minX;
+		double maxX = -minX;
+		double maxY = -minX;
+		for(const auto &it : GameData::Systems())
+			if(it.second.IsValid())
+			{
+				const Point &pos = it.second.Position();
+				minX = min(minX, pos.X());
+				minY = min(minY, pos.Y());
+				maxX = max(maxX, pos.X());
+				maxY = max(maxY, pos.Y());
+			}
+		if(minX > maxX)
+			minX = minY = maxX = maxY = 0.;
+
+		int newScale = 1;
+		int newColumns = 0;
+		int newRows = 0;
+		Point newOrigin;
+		while(true)
+		{
+			const int pixel = GRID * newScale;
+			const int pad = (LIMIT + ORTH * newScale - 1) / (ORTH * newScale) + 1;
+			// Keep pixels aligned to a multiple of their size, so the fog does not
+			// shift as the galaxy grows.
+			const double left = (floor(minX / pixel) - pad) * pixel;
+			const double top = (floor(minY / pixel) - pad) * pixel;
+			newColumns = static_cast<int>(ceil((maxX - left) / pixel)) + pad + 1;
+			newRows = static_cast<int>(ceil((maxY - top) / pixel)) + pad + 1;
+			// Round up to a multiple of 4 so the rows will be 32-bit aligned.
+			newColumns = (newColumns + 3) & ~3;
+			newOrigin = Point(left, top);
+			if(max(newColumns, newRows) <= MAX_SIZE)
+				break;
+			++newScale;
+		}
+
+		bool changed = (newColumns != columns || newRows != rows || newScale != scale
+			|| newOrigin.X() != origin.X() || newOrigin.Y() != origin.Y());
+		columns = newColumns;
+		rows = newRows;
+		scale = newScale;
+		origin = newOrigin;
+		return changed;
+	}
+
+
+	// Find the pixels containing systems that the player can view.
+	vector<int> FindLit(const PlayerInfo &player)
+	{
+		vector<int> result;
+		const double pixel = GRID * scale;
+		for(const auto &it : GameData::Systems())
+		{
+			const System &system = it.second;
+			if(!system.IsValid() || !player.CanView(system))
+				continue;
+
+			Point pos = (system.Position() - origin) / pixel;
+			int x = round(pos.X());
+			int y = round(pos.Y());
+			if(x >= 0 && y >= 0 && x < columns && y < rows)
+				result.push_back(x + y * columns);
+		}
+		sort(result.begin(), result.end());
+		result.erase(unique(result.begin(), result.end()), result.end());
+		return result;
+	}
+
+
+	// Recompute the whole distance field.
+	void Rebuild()
+	{
+		const int orth = ORTH * scale;
+		const int diag = DIAG * scale;
+		distance.assign(static_cast<size_t>(rows) * columns, LIMIT);
+		for(int index : lit)
+			distance[index] = 0;
+
+		// Distance transformation: make two passes through the buffer. In the first
+		// pass, propagate down and to the right. In the second, propagate in the
+		// opposite direction. Once these two passes are done, each value is equal
+		// to the distance to the nearest lit pixel (or the limit, if that is less).
+		auto at = [](int x, int y) -> int { return distance[x + y * columns]; };
+		for(int y = 0; y < rows; ++y)
+			for(int x = 0; x < columns; ++x)
+			{
+				int value = at(x, y);
+				if(x > 0)
+					value = min(value, orth + at(x - 1, y));
+				if(y > 0)
+				{
+					value = min(value, orth + at(x, y - 1));
+					if(x > 0)
+						value = min(value, diag + at(x - 1, y - 1));
+					if(x + 1 < columns)
+						value = min(value, diag + at(x + 1, y - 1));
+				}
+				distance[x + y * columns] = value;
+			}
+		for(int y = rows - 1; y >= 0; --y)
+			for(int x = columns - 1; x >= 0; --x)
+			{
+				int value = at(x, y);
+				if(x + 1 < columns)
+					value = min(value, orth + at(x + 1, y));
+				if(y + 1 < rows)
+				{
+					value = min(value, orth + at(x, y + 1));
+					if(x + 1 < columns)
+						value = min(value, diag + at(x + 1, y + 1));
+					if(x > 0)
+						value = min(value, diag + at(x - 1, y + 1));
+				}
+				distance[x + y * columns] = value;
+			}
+
+		shading.resize(distance.size());
+		transform(distance.begin(), distance.end(), shading.begin(), Shade);
+	}
+
+
+	// Light up the area around the given pixels, which must not already be lit.
+	// This gives the same distances as rebuilding the whole field would, since
+	// the distance transform measures the same diagonal-then-straight paths.
+	// Returns the range of rows that were changed.
+	pair<int, int> Light(const vector<int> &added)
+	{
+		const int orth = ORTH * scale;
+		const int diag = DIAG * scale;
+		const int radius = LIMIT / orth + 1;
+		int firstRow = rows;
+		int lastRow = -1;
+		for(int index : added)
+		{
+			const int cx = index % columns;
+			const int cy = index / columns;
+			const int top = max(0, cy - radius);
+			const int bottom = min(rows - 1, cy + radius);
+			firstRow = min(firstRow, top);
+			lastRow = max(lastRow, bottom);
+			for(int y = top; y <= bottom; ++y)
+				for(int x = max(0, cx - radius); x <= min(columns - 1, cx + radius); ++x)
+				{
+					const int dx = abs(x - cx);
+					const int dy = abs(y - cy);
+					const int value = min(LIMIT, diag * min(dx, dy) + orth * abs(dx - dy));
+					unsigned char &current = distance[x + y * columns];
+					if(value < current)
+					{
+						current = value;
+						shading[x + y * columns] = Shade(value);
+					}
+				}
+		}
+		return make_pair(firstRow, lastRow);
+	}
+
+
+	// Bring the fog up to date with what the player can view, redoing as little
+	// of it as possible, and upload whatever changed.
+	void Update(const PlayerInfo &player)
+	{
+		bool rebuild = Layout() || !texture;
+		vector<int> newLit = FindLit(player);
+		vector<int> added;
+		if(!rebuild)
+		{
+			// Systems that are no longer viewable can only be removed by starting over.
+			rebuild = !includes(newLit.begin(), newLit.end(), lit.begin(), lit.end());
+			set_difference(newLit.begin(), newLit.end(), lit.begin(), lit.end(), back_inserter(added));
+		}
+		lit.swap(newLit);
+
+		if(rebuild)
+		{
+			Rebuild();
+			if(texture)
+				glDeleteTextures(1, &texture);
+
+			glGenTextures(1, &texture);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+			// Upload the new "image."
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, columns, rows, 0, GL_RED, GL_UNSIGNED_BYTE, shading.data());
+		}
+		else if(!added.empty())
+		{
+			// Only upload the rows that were lit up.
+			pair<int, int> changed = Light(added);
+			glBindTexture(GL_TEXTURE_2D, texture);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, changed.first, columns, changed.second - changed.first + 1,
+				GL_RED, GL_UNSIGNED_BYTE, shading.data() + static_cast<size_t>(changed.first) * columns);
+		}
+	}
 }
 
 
@@ -73,8 +302,8 @@ void FogShader::Init()
 		"out vec2 fragTexCoord;\n"
 
 		"void main() {\n"
-		"  gl_Position = vec4(corner + vert * dimensions, 0, 1);\n"
-		"  fragTexCoord = vert;\n"
+		"  gl_Position = vec4(vert * 2.0 - 1.0, 0, 1);\n"
+		"  fragTexCoord = (gl_Position.xy - corner) / dimensions;\n"
 		"}\n";
 
 	static const char *fragmentCode =
@@ -130,117 +359,38 @@ void FogShader::Init()
 
 void FogShader::Redraw()
 {
-	previousZoom = 0.;
+	shouldUpdate = true;
 }
 
 
 
+// Draw the fog over the whole screen. The fog itself only needs to be updated
+// if the player may be able to view different systems than before.
 void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 {
-	// Generate a scaled-down mask image that represents the entire screen plus
-	// enough pixels beyond the screen to include any systems that may be off
-	// screen but close enough to "illuminate" part of the on-screen map.
-	double left = Screen::Left() - GRID * PAD * zoom + fmod(center.X(), GRID) * zoom;
-	double top = Screen::Top() - GRID * PAD * zoom + fmod(center.Y(), GRID) * zoom;
-	int columns = ceil(Screen::Width() / (GRID * zoom)) + 1 + 2 * PAD;
-	int rows = ceil(Screen::Height() / (GRID * zoom)) + 1 + 2 * PAD;
-	// Round up to a multiple of 4 so the rows will be 32-bit aligned.
-	columns = (columns + 3) & ~3;
-
-	// To avoid extra work, don't regenerate the mask buffer if the view has not
-	// moved. This might cause an inaccurate mask if you explore more systems,
-	// come back to the original, and view the map again without viewing it in
-	// between. But, that's an unlikely situation.
-	bool shouldRegenerate = (
-		zoom != previousZoom || center.X() != previousCenter.X() || center.Y() != previousCenter.Y() ||
-		left != previousLeft || top != previousTop || columns != previousColumns || rows != previousRows);
-	if(shouldRegenerate)
+	if(shouldUpdate || player.GetSystem() != previousSystem)
 	{
-		bool sizeChanged = (!texture || columns != previousColumns || rows != previousRows);
-
-		// Remember the current viewport attributes.
-		previousZoom = zoom;
-		previousCenter = center;
-		previousLeft = left;
-		previousTop = top;
-		previousColumns = columns;
-		previousRows = rows;
-
-		// This buffer will hold the mask image.
-		auto buffer = vector<unsigned char>(static_cast<size_t>(rows) * columns, LIMIT);
-
-		// For each system the player knows about, its "distance" pixel in the
-		// buffer should be set to 0.
-		for(const auto &it : GameData::Systems())
-		{
-			const System &system = it.second;
-			if(!system.IsValid() || !player.CanView(system))
-				continue;
-			Point pos = zoom * (system.Position() + center);
-
-			int x = round((pos.X() - left) / (GRID * zoom));
-			int y = round((pos.Y() - top) / (GRID * zoom));
-			if(x >= 0 && y >= 0 && x < columns && y < rows)
-				buffer[x + y * columns] = 0;
-		}
-
-		// Distance transformation: make two passes through the buffer. In the first
-		// pass, propagate down and to the right. In the second, propagate in the
-		// opposite direction. Once these two passes are done, each value is equal
-		for(int y = 1; y < rows; ++y)
-			for(int x = 1; x < columns; ++x)
-				buffer[x + y * columns] = min<int>(buffer[x + y * columns], min(
-					ORTH + min(buffer[(x - 1) + y * columns], buffer[x + (y - 1) * columns]),
-					DIAG + min(buffer[(x - 1) + (y - 1) * columns], buffer[(x + 1) + (y - 1) * columns])));
-		for(int y = rows - 2; y >= 0; --y)
-			for(int x = columns - 2; x >= 0; --x)
-				buffer[x + y * columns] = min<int>(buffer[x + y * columns], min(
-					ORTH + min(buffer[(x + 1) + y * columns], buffer[x + (y + 1) * columns]),
-					DIAG + min(buffer[(x - 1) + (y + 1) * columns], buffer[(x + 1) + (y + 1) * columns])));
-
-		// Stretch the distance values so there is no shading up to about 200 pixels
-		// away, then it transitions somewhat quickly.
-		for(unsigned char &value : buffer)
-			value = max(0, min(LIMIT, (value - 60) * 4));
-		const void *data = &buffer.front();
-
-		// Set up the OpenGL texture if it doesn't exist yet.
-		if(sizeChanged)
-		{
-			// If the texture size changed, it must be reallocated.
-			if(texture)
-				glDeleteTextures(1, &texture);
-
-			glGenTextures(1, &texture);
-			glBindTexture(GL_TEXTURE_2D, texture);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-			// Upload the new "image."
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, columns, rows, 0, GL_RED, GL_UNSIGNED_BYTE, data);
-		}
-		else
-		{
-			glBindTexture(GL_TEXTURE_2D, texture);
-			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, columns, rows, GL_RED, GL_UNSIGNED_BYTE, data);
-		}
+		Update(player);
+		shouldUpdate = false;
+		previousSystem = player.GetSystem();
 	}
-	else
-		glBindTexture(GL_TEXTURE_2D, texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
 
 	// Set up to draw the image.
 	glUseProgram(shader.Object());
 	glBindVertexArray(vao);
 
-	GLfloat corner[2] = {
-		static_cast<float>(left - .5 * GRID * zoom) / (.5f * Screen::Width()),
-		static_cast<float>(top - .5 * GRID * zoom) / (-.5f * Screen::Height())};
-	glUniform2fv(cornerI, 1, corner);
+	// The corner of the image, and its size, in OpenGL's coordinates. The texture
+	// coordinates of each point on the screen are found from these.
+	const double pixel = GRID * scale;
+	const Point corner = zoom * (origin + center - Point(.5 * pixel, .5 * pixel));
+	GLfloat cornerData[2] = {
+		static_cast<float>(corner.X() / (.5 * Screen::Width())),
+		static_cast<float>(corner.Y() / (-.5 * Screen::Height()))};
+	glUniform2fv(cornerI, 1, cornerData);
 	GLfloat dimensions[2] = {
-		GRID * static_cast<float>(zoom) * (columns + 1.f) / (.5f * Screen::Width()),
-		GRID * static_cast<float>(zoom) * (rows + 1.f) / (-.5f * Screen::Height())};
+		static_cast<float>(zoom * pixel * columns / (.5 * Screen::Width())),
+		static_cast<float>(zoom * pixel * rows / (-.5 * Screen::Height()))};
 	glUniform2fv(dimensionsI, 1, dimensions);
 
 	// Call the shader program to draw the image.
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "FrameTimer.h"
 
+#include <algorithm>
 #include <thread>
 
 #ifdef _WIN32
@@ -49,8 +50,9 @@ FrameTimer::FrameTimer(int fps, int maxLagMsec)
 
 
 
-// Wait until the next frame should begin.
-void FrameTimer::Wait()
+// Wait until the next frame should begin. If this frame took too long,
+// return how many frames were dropped because of it.
+int FrameTimer::Wait()
 {
 	// Note: in theory this could get interrupted by a signal handler, although
 	// it's unlikely the program will receive any signals that do not terminate
@@ -75,11 +77,17 @@ void FrameTimer::Wait()
 #endif
 		now = chrono::steady_clock::now();
 	}
-	// If the lag is too high, don't try to do catch-up.
+	// If the lag is too high, don't try to do catch-up. The frames that were
+	// missed are dropped.
+	int dropped = 0;
 	if(now - next > maxLag)
+	{
+		dropped = max<int>(1, (now - next) / step);
 		next = now;
+	}
 
 	Step();
+	return dropped;
 }
 
 
@@ -101,6 +109,14 @@ void FrameTimer::SetFrameRate(int fps)
 
 
 
+// Begin the next frame now, after the game loop has been stopped for a while.
+void FrameTimer::Reset()
+{
+	next = chrono::steady_clock::now();
+}
+
+
+
 // Calculate when the next frame should begin.
 void FrameTimer::Step()
 {
@@ -34,13 +34,16 @@ public:
 	// the next frame happens immediately but no "catch-up" is done.
 	explicit FrameTimer(int fps, int maxLagMsec = 5);
 
-	// Wait until the next frame should begin.
-	void Wait();
+	// Wait until the next frame should begin. If this frame took too long,
+	// return how many frames were dropped because of it.
+	int Wait();
 	// Find out how long it has been since this timer was created, in seconds.
 	double Time() const;
 
 	// Change the frame rate (for viewing in slow motion).
 	void SetFrameRate(int fps);
+	// Begin the next frame now, after the game loop has been stopped for a while.
+	void Reset();
 
 
 private:
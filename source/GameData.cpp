@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "GameData.h"
 
+#include "AssetHandle.h"
 #include "Audio.h"
 #include "BatchShader.h"
 #include "CategoryList.h"
@@ -25,6 +26,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "CrashState.h"
 #include "DataNode.h"
 #include "DataWriter.h"
+#include "Economy.h"
 #include "Effect.h"
 #include "Files.h"
 #include "FillShader.h"
@@ -54,8 +56,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PointerShader.h"
 #include "Politics.h"
 #include "RenderBuffer.h"
+#include "ResourceManifest.h"
 #include "RingShader.h"
 #include "Ship.h"
+#include "Sound.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
 #include "SpriteShader.h"
@@ -101,6 +105,7 @@ namespace {
 
 	const Government *playerGovernment = nullptr;
 	map<const System *, map<string, int>> purchases;
+	Economy economy;
 
 	ConditionsStore globalConditions;
 
@@ -179,6 +184,32 @@ namespace {
 			LoadSprite(queue, icon);
 		}
 	}
+
+
+
+	// Load every plugin in the given directory, whether it is a folder or a zip
+	// file. Zipped plugins are mounted and read in place rather than extracted.
+	void LoadPlugins(TaskQueue &queue, const string &directory)
+	{
+		vector<string> paths = Files::ListDirectories(directory);
+		for(const string &file : Files::List(directory))
+		{
+			if(file.size() < 4 || file.compare(file.size() - 4, 4, ".zip") || !Files::MountArchive(file))
+				continue;
+
+			// Most archives hold the plugin's folder rather than just its contents.
+			string path = file + '/';
+			vector<string> contents = Files::ListDirectories(path);
+			if(!Plugins::IsPlugin(path) && contents.size() == 1)
+				path = contents.front();
+			paths.push_back(path);
+		}
+		sort(paths.begin(), paths.end());
+
+		for(const string &path : paths)
+			if(Plugins::IsPlugin(path))
+				LoadPlugin(queue, path);
+	}
 }
 
 
@@ -248,9 +279,15 @@ void GameData::FinishLoading()
 	defaultOutfitSales = objects.outfitSales;
 	defaultSubstitutions = objects.substitutions;
 	defaultWormholes = objects.wormholes;
+	economy.Update(objects.systems, Commodities());
 	playerGovernment = objects.governments.Get("Escort");
 
 	politics.Reset();
+
+	// Now that every effect and sound is known, bind the handles that the
+	// engine uses to refer to them every frame.
+	AssetHandle<Effect>::BindAll();
+	AssetHandle<Sound>::BindAll();
 }
 
 
@@ -420,6 +457,8 @@ void GameData::Revert()
 
 	politics.Reset();
 	purchases.clear();
+	economy.Update(objects.systems, Commodities());
+	economy.Reset();
 }
 
 
@@ -455,11 +494,11 @@ void GameData::ReadEconomy(const DataNode &node)
 		}
 		else
 		{
-			System &system = *objects.systems.Get(child.Token(0));
+			const System *system = objects.systems.Get(child.Token(0));
 
 			int index = 0;
 			for(const string &commodity : headings)
-				system.SetSupply(commodity, child.Value(++index));
+				economy.SetSupply(system, commodity, child.Value(++index));
 		}
 	}
 }
@@ -511,41 +550,18 @@ void GameData::WriteEconomy(DataWriter &out)
 
 
 
-void GameData::StepEconomy()
+// Advance the economy by the given number of days.
+void GameData::StepEconomy(int days)
 {
 	// First, apply any purchases the player made. These are deferred until now
 	// so that prices will not change as you are buying or selling goods.
 	for(const auto &pit : purchases)
-	{
-		System &system = const_cast<System &>(*pit.first);
 		for(const auto &cit : pit.second)
-			system.SetSupply(cit.first, system.Supply(cit.first) - cit.second);
-	}
+			economy.SetSupply(pit.first, cit.first, economy.Supply(pit.first, cit.first) - cit.second);
 	purchases.clear();
 
-	// Then, have each system generate new goods for local use and trade.
-	for(auto &it : objects.systems)
-		it.second.StepEconomy();
-
-	// Finally, send out the trade goods. This has to be done in a separate step
-	// because otherwise whichever systems trade last would already have gotten
-	// supplied by the other systems.
-	for(auto &it : objects.systems)
-	{
-		System &system = it.second;
-		if(!system.Links().empty())
-			for(const Trade::Commodity &commodity : Commodities())
-			{
-				double supply = system.Supply(commodity.name);
-				for(const System *neighbor : system.Links())
-				{
-					double scale = neighbor->Links().size();
-					if(scale)
-						supply += neighbor->Exports(commodity.name) / scale;
-				}
-				system.SetSupply(commodity.name, supply);
-			}
-	}
+	// Then, have each system generate new goods and trade them with its neighbors.
+	economy.Step(days);
 }
 
 
@@ -558,6 +574,13 @@ void GameData::AddPurchase(const System &system, const string &commodity, int to
 
 
 
+const Economy &GameData::GetEconomy()
+{
+	return economy;
+}
+
+
+
 // Apply the given change to the universe.
 void GameData::Change(const DataNode &node)
 {
@@ -571,6 +594,7 @@ void GameData::Change(const DataNode &node)
 void GameData::UpdateSystems()
 {
 	objects.UpdateSystems();
+	economy.Update(objects.systems, Commodities());
 }
 
 
@@ -938,15 +962,12 @@ void GameData::LoadSources(TaskQueue &queue)
 	sources.clear();
 	sources.push_back(Files::Resources());
 
-	vector<string> globalPlugins = Files::ListDirectories(Files::Resources() + "plugins/");
-	for(const string &path : globalPlugins)
-		if(Plugins::IsPlugin(path))
-			LoadPlugin(queue, path);
+	LoadPlugins(queue, Files::Resources() + "plugins/");
+	LoadPlugins(queue, Files::Config() + "plugins/");
 
-	vector<string> localPlugins = Files::ListDirectories(Files::Config() + "plugins/");
-	for(const string &path : localPlugins)
-		if(Plugins::IsPlugin(path))
-			LoadPlugin(queue, path);
+	// Everything else that is loaded from the sources finds its files through
+	// their manifests, instead of scanning every directory.
+	ResourceManifest::Load(sources);
 }
 
 
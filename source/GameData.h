@@ -34,6 +34,7 @@ class Conversation;
 class DataNode;
 class DataWriter;
 class Date;
+class Economy;
 class Effect;
 class Fleet;
 class FormationPattern;
@@ -101,8 +102,10 @@ public:
 	// Functions for the dynamic economy.
 	static void ReadEconomy(const DataNode &node);
 	static void WriteEconomy(DataWriter &out);
-	static void StepEconomy();
+	// Advance the economy by the given number of days.
+	static void StepEconomy(int days = 1);
 	static void AddPurchase(const System &system, const std::string &commodity, int tons);
+	static const Economy &GetEconomy();
 	// Apply the given change to the universe.
 	static void Change(const DataNode &node);
 	// Update the neighbor lists and other information for all the systems.
@@ -160,15 +160,15 @@ bool GameWindow::Init(bool headless)
 
 	// Settings that must be declared before the context creation.
 	SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-#ifdef _WIN32
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
-#endif
 #ifdef ES_GLES
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_ES);
 #else
+	// Instanced drawing (glVertexAttribDivisor) is only core as of OpenGL 3.3.
+	// OpenGL ES 3.0 already includes it.
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+	SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
 	SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 #endif
 	SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
@@ -176,7 +176,12 @@ bool GameWindow::Init(bool headless)
 	context = SDL_GL_CreateContext(mainWindow);
 	if(!context)
 	{
-		ExitWithError("Unable to create OpenGL context! Check if your system supports OpenGL 3.0.");
+		ExitWithError("Unable to create OpenGL context! Check if your system supports "
+#ifdef ES_GLES
+			"OpenGL ES 3.0.");
+#else
+			"OpenGL 3.3.");
+#endif
 		return false;
 	}
 
@@ -218,10 +223,18 @@ bool GameWindow::Init(bool headless)
 		return false;
 	}
 
+#ifdef ES_GLES
 	if(*glVersion < '3')
+#else
+	if(*glVersion < '3' || (glVersion[0] == '3' && glVersion[1] == '.' && glVersion[2] < '3'))
+#endif
 	{
 		ostringstream out;
+#ifdef ES_GLES
 		out << "Endless Sky requires OpenGL version 3.0 or higher." << endl;
+#else
+		out << "Endless Sky requires OpenGL version 3.3 or higher." << endl;
+#endif
 		out << "Your OpenGL version is " << glVersion << ", GLSL version " << glslVersion << "." << endl;
 		out << "Please update your graphics drivers.";
 		ExitWithError(out.str());
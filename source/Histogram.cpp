@@ -0,0 +1,121 @@
+/* Histogram.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+
+
+// Add a duration, in seconds.
+void Histogram::Add(double seconds)
+{
+	const uint64_t microseconds = min(max(0., seconds), 1000.) * 1000000.;
+	atomic<uint32_t> &bucket = counts[Bucket(microseconds)];
+	// Only one thread adds to a histogram, so there is no need for an atomic
+	// increment; the values only need to be atomic so that they can be read.
+	bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+	count.store(count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+
+
+void Histogram::Clear()
+{
+	for(atomic<uint32_t> &bucket : counts)
+		bucket.store(0, memory_order_relaxed);
+	count.store(0, memory_order_relaxed);
+}
+
+
+
+// The number of durations that have been added.
+uint64_t Histogram::Count() const
+{
+	return count.load(memory_order_relaxed);
+}
+
+
+
+// Get the duration that the given fraction (from 0 to 1) of all the
+// durations are no longer than, in seconds.
+double Histogram::Percentile(double fraction) const
+{
+	const uint64_t total = Count();
+	if(!total)
+		return 0.;
+
+	// Find the first bucket by which the given number of durations have been
+	// counted. The counts may change while this is running, so if the end is
+	// reached first, report the last bucket with anything in it.
+	const uint64_t rank = max<uint64_t>(1, ceil(min(1., max(0., fraction)) * total));
+	uint64_t sum = 0;
+	size_t last = 0;
+	for(size_t i = 0; i < BUCKETS; ++i)
+	{
+		const uint32_t bucketCount = counts[i].load(memory_order_relaxed);
+		if(!bucketCount)
+			continue;
+		sum += bucketCount;
+		last = i;
+		if(sum >= rank)
+			break;
+	}
+	return Value(last);
+}
+
+
+
+// Get the longest duration, to within the size of its bucket.
+double Histogram::Max() const
+{
+	return Percentile(1.);
+}
+
+
+
+size_t Histogram::Bucket(uint64_t microseconds)
+{
+	// Durations shorter than 2^SUB_BITS microseconds each get their own bucket.
+	if(microseconds < (1u << SUB_BITS))
+		return microseconds;
+
+	// Otherwise, the position of the highest set bit picks a range, and the
+	// next SUB_BITS bits pick one of the buckets within it.
+	size_t highBit = 0;
+	for(uint64_t value = microseconds; value >>= 1; )
+		++highBit;
+	if(highBit >= MAX_BITS)
+		return BUCKETS - 1;
+	const size_t shift = highBit - SUB_BITS;
+	return ((highBit - SUB_BITS + 1) << SUB_BITS) + ((microseconds >> shift) & ((1u << SUB_BITS) - 1));
+}
+
+
+
+// The middle of the range of durations that fall in the given bucket.
+double Histogram::Value(size_t bucket)
+{
+	const size_t range = bucket >> SUB_BITS;
+	if(!range)
+		return (bucket + .5) * .000001;
+
+	const size_t shift = range - 1;
+	const uint64_t low = static_cast<uint64_t>((1u << SUB_BITS) + (bucket & ((1u << SUB_BITS) - 1))) << shift;
+	const uint64_t width = static_cast<uint64_t>(1) << shift;
+	return (low + .5 * width) * .000001;
+}
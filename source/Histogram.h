@@ -0,0 +1,65 @@
+/* Histogram.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+
+// A histogram of durations, with log-linear buckets: each power of two
+// microseconds is split into 16 buckets, so any percentile it reports is
+// within about 6% of the true value, and the whole range from a microsecond
+// to several seconds takes a few hundred counters. Adding a duration is just
+// a bit scan and an increment, so it can be done every frame. A histogram
+// may only have one thread adding to it, but any thread may read it.
+class Histogram {
+public:
+	// Add a duration, in seconds.
+	void Add(double seconds);
+	void Clear();
+
+	// The number of durations that have been added.
+	uint64_t Count() const;
+	// Get the duration that the given fraction (from 0 to 1) of all the
+	// durations are no longer than, in seconds.
+	double Percentile(double fraction) const;
+	// Get the longest duration, to within the size of its bucket.
+	double Max() const;
+
+
+private:
+	static size_t Bucket(uint64_t microseconds);
+	// The middle of the range of durations that fall in the given bucket.
+	static double Value(size_t bucket);
+
+
+private:
+	// Durations of up to 2^24 microseconds (about 16 seconds) are counted in
+	// their own buckets. Any longer ones are all counted in the last bucket.
+	static const size_t SUB_BITS = 4;
+	static const size_t MAX_BITS = 24;
+	static const size_t BUCKETS = (MAX_BITS - SUB_BITS + 1) << SUB_BITS;
+
+	std::array<std::atomic<uint32_t>, BUCKETS> counts = {};
+	std::atomic<uint64_t> count = 0;
+};
+
+
+
+#endif
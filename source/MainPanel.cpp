@@ -108,6 +108,9 @@ void MainPanel::Step()
 	// will call this object's OnCallback() function;
 	if(isActive && player.GetPlanet() && !player.GetPlanet()->IsWormhole())
 	{
+		// A recording of the player's flight ends when they land, since the
+		// app may well be closed before they take off again.
+		engine.EndFlight();
 		GetUI()->Push(new PlanetPanel(player, bind(&MainPanel::OnCallback, this)));
 		player.Land(GetUI());
 		// Save on landing, in case the app is killed uncleanly
@@ -618,18 +618,18 @@ bool MapPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool
 
 bool MapPanel::Click(int x, int y, int clicks)
 {
-	// Figure out if a system was clicked on.
+	// Figure out if a system was clicked on. The nodes are exactly the systems
+	// that can be selected, in order of their names.
+	if(commodity != cachedCommodity)
+		UpdateCache();
 	Point click = Point(x, y) / Zoom() - center;
-	for(const auto &it : GameData::Systems())
-	{
-		const System &system = it.second;
-		if(system.IsValid() && !system.Inaccessible() && click.Distance(system.Position()) < 10.
-				&& (player.HasSeen(system) || &system == specialSystem))
+	nodeIndex.Query(Rectangle(click, Point(20., 20.)), found);
+	for(size_t i : found)
+		if(click.Distance(nodes[i].position) < 10.)
 		{
-			Select(&system);
+			Select(nodes[i].system);
 			break;
 		}
-	}
 
 	return true;
 }
@@ -1094,6 +1094,15 @@ void MapPanel::CenterOnSystem(const System *system, bool immediate)
 
 
 
+MapPanel::Node::Node(const System *system, const Color &color, const string &name,
+		const Color &nameColor, const Government *government)
+	: system(system), position(system->Position()), color(color), name(name), nameColor(nameColor),
+	government(government)
+{
+}
+
+
+
 // Cache the map layout, so it doesn't have to be re-calculated every frame.
 // The node cache must be updated when the coloring mode changes.
 void MapPanel::UpdateCache()
@@ -1249,7 +1258,7 @@ void MapPanel::UpdateCache()
 			}
 		}
 
-		nodes.emplace_back(system.Position(), color,
+		nodes.emplace_back(&system, color,
 			player.KnowsName(system) ? system.Name() : "",
 			(&system == &playerSystem) ? closeNameColor : farNameColor,
 			player.CanView(system) ? system.GetGovernment() : nullptr);
@@ -1280,6 +1289,18 @@ void MapPanel::UpdateCache()
 				links.emplace_back(system->Position(), link->Position(), isClose ? closeColor : farColor);
 			}
 	}
+
+	// Index the nodes and links by position. Cells about the size of a typical
+	// hyperspace link keep both the number of cells and the items in each small.
+	vector<Rectangle> boxes;
+	boxes.reserve(max(nodes.size(), links.size()));
+	for(const Node &node : nodes)
+		boxes.emplace_back(node.position, Point());
+	nodeIndex.Build(boxes, System::DEFAULT_NEIGHBOR_DISTANCE);
+	boxes.clear();
+	for(const Link &link : links)
+		boxes.push_back(Rectangle::WithCorners(link.start, link.end));
+	linkIndex.Build(boxes, System::DEFAULT_NEIGHBOR_DISTANCE);
 }
 
 
@@ -1509,11 +1530,13 @@ void MapPanel::DrawWormholes()
 void MapPanel::DrawLinks()
 {
 	double zoom = Zoom();
-	for(const Link &link : links)
+	linkIndex.Query(VisibleArea(LINK_WIDTH), found);
+	for(size_t i : found)
 	{
+		const Link &link = links[i];
 		Point from = zoom * (link.start + center);
 		Point to = zoom * (link.end + center);
-		Point unit = (from - to).Unit() * LINK_OFFSET;
+		Point unit = link.unit * LINK_OFFSET;
 		from -= unit;
 		to += unit;
 
@@ -1528,32 +1551,34 @@ void MapPanel::DrawSystems()
 	if(commodity != cachedCommodity)
 		UpdateCache();
 
+	double zoom = Zoom();
 	// If coloring by government, we need to keep track of which ones are the
 	// closest to the center of the window because those will be the ones that
-	// are shown in the map key.
+	// are shown in the map key. Governments that are off screen still count.
 	if(commodity == SHOW_GOVERNMENT)
-		closeGovernments.clear();
-
-	// Draw the circles for the systems.
-	double zoom = Zoom();
-	for(const Node &node : nodes)
 	{
-		Point pos = zoom * (node.position + center);
-		RingShader::Draw(pos, OUTER, INNER, node.color);
-
-		if(commodity == SHOW_GOVERNMENT && node.government && node.government->GetName() != "Uninhabited")
-		{
-			// For every government that is drawn, keep track of how close it
-			// is to the center of the view. The four closest governments
-			// will be displayed in the key.
-			double distance = pos.Length();
-			auto it = closeGovernments.find(node.government);
-			if(it == closeGovernments.end())
-				closeGovernments[node.government] = distance;
-			else
-				it->second = min(it->second, distance);
-		}
+		closeGovernments.clear();
+		for(const Node &node : nodes)
+			if(node.government && node.government->GetName() != "Uninhabited")
+			{
+				// For every government that is drawn, keep track of how close it
+				// is to the center of the view. The four closest governments
+				// will be displayed in the key.
+				double distance = (zoom * (node.position + center)).Length();
+				auto it = closeGovernments.find(node.government);
+				if(it == closeGovernments.end())
+					closeGovernments[node.government] = distance;
+				else
+					it->second = min(it->second, distance);
+			}
 	}
+
+	// Draw the circles for the systems that are on screen.
+	nodeIndex.Query(VisibleArea(OUTER), found);
+	RingShader::Bind();
+	for(size_t i : found)
+		RingShader::Add(zoom * (nodes[i].position + center), OUTER, INNER, nodes[i].color);
+	RingShader::Unbind();
 }
 
 
@@ -1569,8 +1594,13 @@ void MapPanel::DrawNames()
 	bool useBigFont = (zoom > 2.);
 	const Font &font = FontSet::Get(useBigFont ? 18 : 14);
 	Point offset(useBigFont ? 8. : 6., -.5 * font.Height());
-	for(const Node &node : nodes)
-		font.Draw(node.name, zoom * (node.position + center) + offset, node.nameColor);
+	// Names are drawn to the right of each system, so also draw those of
+	// systems up to a long name's width off the left side of the screen.
+	Rectangle area = VisibleArea(font.Height());
+	area = Rectangle::WithCorners(area.TopLeft() - Point(300. / zoom, 0.), area.BottomRight());
+	nodeIndex.Query(area, found);
+	for(size_t i : found)
+		font.Draw(nodes[i].name, zoom * (nodes[i].position + center) + offset, nodes[i].nameColor);
 }
 
 
@@ -1667,16 +1697,28 @@ void MapPanel::DrawPointer(Point position, unsigned &systemCount, const Color &c
 
 
 
+// Get the part of the map that is on screen, in map coordinates, plus the
+// given margin (in pixels) on each side.
+Rectangle MapPanel::VisibleArea(double margin) const
+{
+	const double zoom = Zoom();
+	const Point corner(Screen::Right() + margin, Screen::Bottom() + margin);
+	return Rectangle::WithCorners(-corner / zoom - center, corner / zoom - center);
+}
+
+
+
 void MapPanel::UpdateGamepadMapCursor()
 {
 	// Have the cursor jump to the closest system to the center of the
 	// screen, if its close enough.
 	Point best(-100000.0, -100000.0);
 	double best_distance = 1000000000000.0;
-	size_t idx = 0;
-	for(const Node &node : nodes)
+	// Only systems within 100 units of the center can be selected.
+	nodeIndex.Query(Rectangle(-center, Point(200., 200.) / Zoom()), found);
+	for(size_t idx : found)
 	{
-		Point pos = Zoom() * (node.position + center);
+		Point pos = Zoom() * (nodes[idx].position + center);
 		double distance = pos.LengthSquared();
 		if(distance < best_distance)
 		{
@@ -1684,7 +1726,6 @@ void MapPanel::UpdateGamepadMapCursor()
 			best_distance = distance;
 			controllerSelected = idx;
 		}
-		++idx;
 	}
 
 	if(best_distance < 10000) // 100^2 units
@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Color.h"
 #include "DistanceMap.h"
 #include "Point.h"
+#include "SpatialIndex.h"
 #include "ZoomGesture.h"
 #include "text/WrappedText.h"
 
@@ -192,6 +193,9 @@ private:
 		bool drawBack = true, bool bigger = false);
 
 	void UpdateGamepadMapCursor();
+	// Get the part of the map that is on screen, in map coordinates, plus the
+	// given margin (in pixels) on each side.
+	Rectangle VisibleArea(double margin) const;
 
 private:
 	// This is the coloring mode currently used in the cache.
@@ -199,10 +203,10 @@ private:
 
 	class Node {
 	public:
-		Node(const Point &position, const Color &color, const std::string &name,
-			const Color &nameColor, const Government *government)
-			: position(position), color(color), name(name), nameColor(nameColor), government(government) {}
+		Node(const System *system, const Color &color, const std::string &name,
+			const Color &nameColor, const Government *government);
 
+		const System *system;
 		Point position;
 		Color color;
 		std::string name;
@@ -214,14 +218,23 @@ private:
 	class Link {
 	public:
 		Link(const Point &start, const Point &end, const Color &color)
-			: start(start), end(end), color(color) {}
+			: start(start), end(end), unit((start - end).Unit()), color(color) {}
 
 		Point start;
 		Point end;
+		// The direction from the end to the start, which does not change with zoom.
+		Point unit;
 		Color color;
 	};
 	std::vector<Link> links;
 
+	// Indices of the nodes and links by where they are on the map, so that only
+	// the ones on screen need to be drawn or checked for clicks.
+	SpatialIndex nodeIndex;
+	SpatialIndex linkIndex;
+	// The nodes or links found by the most recent query of either index.
+	mutable std::vector<size_t> found;
+
 	Animate<double> mapZoom;
 	ZoomGesture zoomGesture;
 
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Mission.h"
 
+#include "ConditionCache.h"
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "Dialog.h"
@@ -335,6 +336,10 @@ void Mission::Load(const DataNode &node)
 
 	if(displayName.empty())
 		displayName = name;
+	displayNameTemplate = Format::Template(displayName);
+	descriptionTemplate = Format::Template(description);
+	blockedTemplate = Format::Template(blocked);
+	clearanceTemplate = Format::Template(clearance);
 	if(hasPriority && location == LANDING)
 		node.PrintTrace("Warning: \"priority\" tag has no effect on \"landing\" missions:");
 }
@@ -786,7 +791,8 @@ bool Mission::HasFullClearance() const
 
 
 // Check if it's possible to offer or complete this mission right now.
-bool Mission::CanOffer(const PlayerInfo &player, const shared_ptr<Ship> &boardingShip) const
+bool Mission::CanOffer(const PlayerInfo &player, const shared_ptr<Ship> &boardingShip,
+	ConditionCache *offerConditions) const
 {
 	if(location == BOARDING || location == ASSISTING)
 	{
@@ -806,7 +812,7 @@ bool Mission::CanOffer(const PlayerInfo &player, const shared_ptr<Ship> &boardin
 	}
 
 	const auto &playerConditions = player.Conditions();
-	if(!toOffer.Test(playerConditions))
+	if(!(offerConditions ? offerConditions->Test(toOffer, playerConditions) : toOffer.Test(playerConditions)))
 		return false;
 
 	if(!toFail.IsEmpty() && toFail.Test(playerConditions))
@@ -1194,6 +1200,17 @@ bool Mission::HasShip(const shared_ptr<Ship> &ship) const
 
 
 
+// Add each of this mission's NPC ships to the given index of which
+// missions and NPCs every ship belongs to.
+void Mission::IndexNPCs(unordered_map<const Ship *, vector<pair<Mission *, NPC *>>> &index)
+{
+	for(NPC &npc : npcs)
+		for(const shared_ptr<Ship> &ship : npc.Ships())
+			index[ship.get()].emplace_back(this, &npc);
+}
+
+
+
 // If any event occurs between two ships, check to see if this mission cares
 // about it. This may affect the mission status or display a message.
 void Mission::Do(const ShipEvent &event, PlayerInfo &player, UI *ui)
@@ -1249,9 +1266,14 @@ void Mission::Do(const ShipEvent &event, PlayerInfo &player, UI *ui)
 		if(Enter(system, player, ui))
 			UpdateNPCs(player);
 	}
+}
 
-	for(NPC &npc : npcs)
-		npc.Do(event, player, ui, this, isVisible);
+
+
+// Tell one of this mission's NPCs about an event whose target belongs to it.
+void Mission::Do(const ShipEvent &event, NPC &npc, PlayerInfo &player, UI *ui)
+{
+	npc.Do(event, player, ui, this, isVisible);
 }
 
 
@@ -1549,11 +1571,18 @@ Mission Mission::Instantiate(const PlayerInfo &player, const shared_ptr<Ship> &b
 		result.genericOnEnter.emplace_back(action.Instantiate(
 			player.Conditions(), subs, sourceSystem, jumps, payload));
 
-	// Perform substitution in the name and description.
-	result.displayName = Format::Replace(Phrase::ExpandPhrases(displayName), subs);
-	result.description = Format::Replace(Phrase::ExpandPhrases(description), subs);
-	result.clearance = Format::Replace(Phrase::ExpandPhrases(clearance), subs);
-	result.blocked = Format::Replace(Phrase::ExpandPhrases(blocked), subs);
+	// Perform substitution in the name and description. Phrases are picked at
+	// random, so text that uses them must be scanned again every time.
+	auto substitute = [&subs](const string &text, const Format::Template &compiled) -> string
+	{
+		if(text.find("${") == string::npos)
+			return compiled.Replace(subs);
+		return Format::Replace(Phrase::ExpandPhrases(text), subs);
+	};
+	result.displayName = substitute(displayName, displayNameTemplate);
+	result.description = substitute(description, descriptionTemplate);
+	result.clearance = substitute(clearance, clearanceTemplate);
+	result.blocked = substitute(blocked, blockedTemplate);
 	result.clearanceFilter = clearanceFilter;
 	result.hasFullClearance = hasFullClearance;
 
@@ -24,13 +24,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "MissionAction.h"
 #include "NPC.h"
 #include "TextReplacements.h"
+#include "text/Format.h"
 
 #include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+class ConditionCache;
 class DataNode;
 class DataWriter;
 class Planet;
@@ -130,7 +135,9 @@ public:
 	// check for whether you can offer a mission does not take available space
 	// into account, so before actually offering a mission you should also check
 	// if the player has enough space.
-	bool CanOffer(const PlayerInfo &player, const std::shared_ptr<Ship> &boardingShip = nullptr) const;
+	// If a cache is given, the "to offer" conditions are tested through it.
+	bool CanOffer(const PlayerInfo &player, const std::shared_ptr<Ship> &boardingShip = nullptr,
+		ConditionCache *offerConditions = nullptr) const;
 	bool CanAccept(const PlayerInfo &player) const;
 	bool HasSpace(const PlayerInfo &player) const;
 	bool HasSpace(const Ship &ship) const;
@@ -167,9 +174,15 @@ public:
 	void UpdateNPCs(const PlayerInfo &player);
 	// Checks if the given ship belongs to one of the mission's NPCs.
 	bool HasShip(const std::shared_ptr<Ship> &ship) const;
+	// Add each of this mission's NPC ships to the given index of which
+	// missions and NPCs every ship belongs to.
+	void IndexNPCs(std::unordered_map<const Ship *, std::vector<std::pair<Mission *, NPC *>>> &index);
 	// If any event occurs between two ships, check to see if this mission cares
-	// about it. This may affect the mission status or display a message.
+	// about it. This may affect the mission status or display a message. The
+	// NPCs of this mission that the event's target belongs to are told about
+	// it separately, through the second function.
 	void Do(const ShipEvent &event, PlayerInfo &player, UI *ui);
+	void Do(const ShipEvent &event, NPC &npc, PlayerInfo &player, UI *ui);
 	bool RequiresGiftedShip(const std::string &shipId) const;
 
 	// Get the internal name used for this mission. This name is unique and is
@@ -198,6 +211,12 @@ private:
 	std::string displayName;
 	std::string description;
 	std::string blocked;
+	// The text that is filled in when the mission is instantiated, scanned for
+	// substitutions once when it is loaded.
+	Format::Template displayNameTemplate;
+	Format::Template descriptionTemplate;
+	Format::Template blockedTemplate;
+	Format::Template clearanceTemplate;
 	Location location = SPACEPORT;
 
 	EsUuid uuid;
@@ -37,6 +37,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	int TriggerBit(NPC::Trigger trigger)
+	{
+		return 1 << static_cast<int>(trigger);
+	}
+
 	string TriggerToText(NPC::Trigger trigger)
 	{
 		switch(trigger)
@@ -744,17 +749,19 @@ NPC NPC::Instantiate(const PlayerInfo &player, map<string, string> &subs, const
 // Handle any NPC mission actions that may have been triggered by a ShipEvent.
 void NPC::DoActions(const ShipEvent &event, bool newEvent, PlayerInfo &player, UI *ui, const Mission *caller)
 {
-	// Map the ShipEvent that was received to the Triggers it could flip.
-	static const map<int, vector<Trigger>> eventTriggers = {
-		{ShipEvent::ASSIST, {Trigger::ASSIST}},
-		{ShipEvent::SCAN_CARGO, {Trigger::SCAN_CARGO}},
-		{ShipEvent::SCAN_OUTFITS, {Trigger::SCAN_OUTFITS}},
-		{ShipEvent::PROVOKE, {Trigger::PROVOKE}},
-		{ShipEvent::DISABLE, {Trigger::DISABLE}},
-		{ShipEvent::BOARD, {Trigger::BOARD}},
-		{ShipEvent::CAPTURE, {Trigger::CAPTURE, Trigger::KILL}},
-		{ShipEvent::DESTROY, {Trigger::DESTROY, Trigger::KILL}},
-		{ShipEvent::ENCOUNTER, {Trigger::ENCOUNTER}},
+	// Map the ShipEvent that was received to the Triggers it could flip. Each
+	// Trigger is a bit in the second value, so the Triggers that might run can
+	// be found without building a set of them for every event.
+	static const pair<int, int> eventTriggers[] = {
+		{ShipEvent::ASSIST, TriggerBit(Trigger::ASSIST)},
+		{ShipEvent::SCAN_CARGO, TriggerBit(Trigger::SCAN_CARGO)},
+		{ShipEvent::SCAN_OUTFITS, TriggerBit(Trigger::SCAN_OUTFITS)},
+		{ShipEvent::PROVOKE, TriggerBit(Trigger::PROVOKE)},
+		{ShipEvent::DISABLE, TriggerBit(Trigger::DISABLE)},
+		{ShipEvent::BOARD, TriggerBit(Trigger::BOARD)},
+		{ShipEvent::CAPTURE, TriggerBit(Trigger::CAPTURE) | TriggerBit(Trigger::KILL)},
+		{ShipEvent::DESTROY, TriggerBit(Trigger::DESTROY) | TriggerBit(Trigger::KILL)},
+		{ShipEvent::ENCOUNTER, TriggerBit(Trigger::ENCOUNTER)},
 	};
 
 	int type = event.Type();
@@ -766,15 +773,17 @@ void NPC::DoActions(const ShipEvent &event, bool newEvent, PlayerInfo &player, U
 		type &= ~ShipEvent::DESTROY;
 
 	// Get the actions for the Triggers that could potentially run.
-	set<Trigger> triggers;
+	int triggers = 0;
 	for(const auto &it : eventTriggers)
 		if(type & it.first)
-			triggers.insert(it.second.begin(), it.second.end());
+			triggers |= it.second;
+	if(!triggers || npcActions.empty())
+		return;
 
-	for(Trigger trigger : triggers)
+	for(auto &it : npcActions)
 	{
-		auto it = npcActions.find(trigger);
-		if(it == npcActions.end())
+		const Trigger trigger = it.first;
+		if(!(triggers & TriggerBit(trigger)))
 			continue;
 
 		static const map<Trigger, int> triggerRequirements = {
@@ -811,7 +820,7 @@ void NPC::DoActions(const ShipEvent &event, bool newEvent, PlayerInfo &player, U
 					return it != shipEvents.end() && (it->second & requiredEvents) && !(it->second & excludedEvents);
 				}))
 		{
-			it->second.Do(player, ui, caller);
+			it.second.Do(player, ui, caller);
 		}
 	}
 }
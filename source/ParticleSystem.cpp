@@ -0,0 +1,167 @@
+/* ParticleSystem.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ParticleSystem.h"
+
+#include "BatchDrawList.h"
+#include "Effect.h"
+#include "Sprite.h"
+#include "Visual.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+// Add the given visuals, which were created during the given step. This
+// calculates their animation offsets, so it must be done before they are
+// drawn for the first time.
+void ParticleSystem::Add(const vector<Visual> &visuals, int step)
+{
+	for(const Visual &visual : visuals)
+	{
+		// Any random or starting offset of an animation is filled in the first
+		// time its frame is found, so do that now.
+		visual.GetFrame(step);
+
+		x.push_back(visual.position.X());
+		y.push_back(visual.position.Y());
+		velocityX.push_back(visual.velocity.X());
+		velocityY.push_back(visual.velocity.Y());
+		angle.push_back(visual.angle);
+		spin.push_back(visual.spin);
+		lifetime.push_back(visual.lifetime);
+		frameRate.push_back(visual.frameRate);
+		frameOffset.push_back(visual.frameOffset);
+		effect.push_back(visual.effect);
+	}
+}
+
+
+
+void ParticleSystem::Clear()
+{
+	x.clear();
+	y.clear();
+	velocityX.clear();
+	velocityY.clear();
+	angle.clear();
+	spin.clear();
+	lifetime.clear();
+	frameRate.clear();
+	frameOffset.clear();
+	effect.clear();
+}
+
+
+
+// Step every effect forward, removing any that have expired.
+void ParticleSystem::Step()
+{
+	// First, move every effect, including the ones that are about to expire,
+	// so that these loops have no branches in them.
+	const size_t count = x.size();
+	double *px = x.data();
+	double *py = y.data();
+	const double *vx = velocityX.data();
+	const double *vy = velocityY.data();
+	int32_t *life = lifetime.data();
+	for(size_t i = 0; i < count; ++i)
+	{
+		px[i] += vx[i];
+		py[i] += vy[i];
+		--life[i];
+	}
+	for(size_t i = 0; i < count; ++i)
+		angle[i] += spin[i];
+
+	// Then remove each effect whose lifetime ran out, by moving the last
+	// effect into its place.
+	size_t size = count;
+	for(size_t i = 0; i < size; )
+	{
+		if(life[i] >= 0)
+		{
+			++i;
+			continue;
+		}
+		--size;
+		x[i] = x[size];
+		y[i] = y[size];
+		velocityX[i] = velocityX[size];
+		velocityY[i] = velocityY[size];
+		angle[i] = angle[size];
+		spin[i] = spin[size];
+		lifetime[i] = lifetime[size];
+		frameRate[i] = frameRate[size];
+		frameOffset[i] = frameOffset[size];
+		effect[i] = effect[size];
+	}
+	x.resize(size);
+	y.resize(size);
+	velocityX.resize(size);
+	velocityY.resize(size);
+	angle.resize(size);
+	spin.resize(size);
+	lifetime.resize(size);
+	frameRate.resize(size);
+	frameOffset.resize(size);
+	effect.resize(size);
+}
+
+
+
+// Draw every effect, as of the given step.
+void ParticleSystem::Draw(BatchDrawList &draw, int step) const
+{
+	for(size_t i = 0; i < x.size(); ++i)
+	{
+		const Effect &body = *effect[i];
+		const Sprite *sprite = body.GetSprite();
+		if(!sprite)
+			continue;
+
+		// This matches how Body::SetStep() finds the frame, except that the
+		// frame rate and offset belong to this effect rather than the Body.
+		float frame = 0.f;
+		const int animationStep = step - body.pause;
+		if(animationStep >= 0 && sprite->Frames() > 1)
+			frame = body.WrapFrame(max(0.f, frameRate[i] * animationStep + frameOffset[i]));
+		draw.AddParticle(body, Point(x[i], y[i]), angle[i], frame);
+	}
+}
+
+
+
+size_t ParticleSystem::Size() const
+{
+	return x.size();
+}
+
+
+
+// Get the position and facing of the effect at the given index.
+Point ParticleSystem::Position(size_t index) const
+{
+	return Point(x[index], y[index]);
+}
+
+
+
+Angle ParticleSystem::Facing(size_t index) const
+{
+	return angle[index];
+}
@@ -0,0 +1,76 @@
+/* ParticleSystem.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PARTICLE_SYSTEM_H_
+#define PARTICLE_SYSTEM_H_
+
+#include "Angle.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BatchDrawList;
+class Effect;
+class Visual;
+
+
+
+// All the visual effects (explosions, sparks, engine flares, etc.) that are
+// currently active. Effects are created as Visual objects, but once they have
+// been created the only things that change about them are their position,
+// facing, remaining lifetime, and animation frame, so each of those is kept in
+// its own flat array rather than in a full Body for each effect. That way,
+// stepping the effects forward is a few simple loops that the compiler can
+// vectorize. Effects that expire are replaced by the last effect in the arrays,
+// so the order they are stored and drawn in is not the order they were created.
+class ParticleSystem {
+public:
+	// Add the given visuals, which were created during the given step. This
+	// calculates their animation offsets, so it must be done before they are
+	// drawn for the first time.
+	void Add(const std::vector<Visual> &visuals, int step);
+	void Clear();
+
+	// Step every effect forward, removing any that have expired.
+	void Step();
+	// Draw every effect, as of the given step.
+	void Draw(BatchDrawList &draw, int step) const;
+
+	size_t Size() const;
+	// Get the position and facing of the effect at the given index.
+	Point Position(size_t index) const;
+	Angle Facing(size_t index) const;
+
+
+private:
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<double> velocityX;
+	std::vector<double> velocityY;
+	std::vector<Angle> angle;
+	std::vector<Angle> spin;
+	std::vector<int32_t> lifetime;
+	// The frame of each effect's animation at a given step is frameRate * step
+	// + frameOffset, wrapped according to the Effect it was created from.
+	std::vector<float> frameRate;
+	std::vector<float> frameOffset;
+	std::vector<const Effect *> effect;
+};
+
+
+
+#endif
@@ -37,13 +37,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Preferences.h"
 #include "RaidFleet.h"
 #include "Random.h"
-#include "SavedGame.h"
 #include "Ship.h"
 #include "ShipEvent.h"
 #include "ShipJumpNavigation.h"
 #include "StartConditions.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "TaskQueue.h"
 #include "UI.h"
 
 #include <algorithm>
@@ -59,6 +59,22 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// Saved games are written to disk by a worker thread, so that autosaves do
+	// not stall the game. Only the serialization happens on the main thread.
+	TaskQueue saveQueue;
+
+	// Get the date stored in a saved game without loading the rest of it. Unlike
+	// SavedGame, this does not look up any sprites, so it is safe to call from
+	// a worker thread.
+	Date SavedDate(const string &path)
+	{
+		DataFile file(path);
+		for(const DataNode &node : file)
+			if(node.Token(0) == "date" && node.Size() >= 4)
+				return Date(node.Value(1), node.Value(2), node.Value(3));
+		return Date();
+	}
+
 	// Move the flagship to the start of your list of ships. It does not make sense
 	// that the flagship would change if you are reunited with a different ship that
 	// was higher up the list.
@@ -128,10 +144,26 @@ namespace {
 
 
 
+PlayerInfo::PlayerInfo()
+{
+	cargo.SetPartOf(fleetEpoch);
+}
+
+
+
+PlayerInfo::~PlayerInfo() noexcept
+{
+	WaitForSave();
+}
+
+
+
 // Completely clear all loaded information, to prepare for loading a file or
 // creating a new pilot.
 void PlayerInfo::Clear()
 {
+	// Don't let a save that is still being written outlive this player.
+	WaitForSave();
 	*this = PlayerInfo();
 
 	Random::Seed(time(nullptr));
@@ -166,6 +198,7 @@ void PlayerInfo::New(const StartConditions &start)
 	for(const Ship &ship : start.Ships())
 	{
 		ships.emplace_back(new Ship(ship));
+		AddToFleetEpoch(*ships.back());
 		ships.back()->SetSystem(&start.GetSystem());
 		ships.back()->SetPlanet(&start.GetPlanet());
 		ships.back()->SetIsSpecial();
@@ -175,6 +208,7 @@ void PlayerInfo::New(const StartConditions &start)
 	// Load starting conditions from a "start" item in the data files. If no
 	// such item exists, StartConditions defines default values.
 	date = start.GetDate();
+	dateEpoch.Bump();
 	GameData::SetDate(date);
 	// Make sure the fleet depreciation object knows it is tracking the player's
 	// fleet, not the planet's stock.
@@ -235,7 +269,10 @@ void PlayerInfo::Load(const string &path)
 			lastName = child.Token(2);
 		}
 		else if(child.Token(0) == "date" && child.Size() >= 4)
+		{
 			date = Date(child.Value(1), child.Value(2), child.Value(3));
+			dateEpoch.Bump();
+		}
 		else if(child.Token(0) == "system entry method" && child.Size() >= 2)
 			entry = StringToEntry(child.Token(1));
 		else if(child.Token(0) == "previous system" && child.Size() >= 2)
@@ -275,12 +312,14 @@ void PlayerInfo::Load(const string &path)
 			for(const DataNode &grand : child)
 				if(grand.Size() >= 2)
 					tributeReceived[GameData::Planets().Get(grand.Token(0))] = grand.Value(1);
+			tributeEpoch.Bump();
 		}
 		// Records of things you own:
 		else if(child.Token(0) == "ship")
 		{
 			// Ships owned by the player have various special characteristics:
 			ships.push_back(make_shared<Ship>(child));
+			AddToFleetEpoch(*ships.back());
 			ships.back()->SetIsSpecial();
 			ships.back()->SetIsYours();
 			// Defer finalizing this ship until we have processed all changes to game state.
@@ -295,6 +334,7 @@ void PlayerInfo::Load(const string &path)
 						if(grandGrand.Token(0) == "cargo")
 						{
 							CargoHold &storage = planetaryStorage[GameData::Planets().Get(grand.Token(1))];
+							storage.SetPartOf(fleetEpoch);
 							storage.Load(grandGrand);
 						}
 		}
@@ -328,6 +368,7 @@ void PlayerInfo::Load(const string &path)
 		else if(child.Token(0) == "mission")
 		{
 			missions.emplace_back(child);
+			missionsEpoch.Bump();
 			cargo.AddMissionCargo(&missions.back());
 		}
 		else if((child.Token(0) == "mission cargo" || child.Token(0) == "mission passengers") && child.HasChildren())
@@ -363,7 +404,11 @@ void PlayerInfo::Load(const string &path)
 				giftedShips[grand.Token(0)] = EsUuid::FromString(grand.Token(1));
 		}
 		else if(child.Token(0) == "event")
-			gameEvents.emplace_back(child);
+		{
+			GameEvent event(child);
+			Date eventDate = event.GetDate();
+			gameEvents.emplace(eventDate, std::move(event));
+		}
 		else if(child.Token(0) == "changes")
 		{
 			for(const DataNode &grand : child)
@@ -496,36 +541,51 @@ void PlayerInfo::Save() const
 	if(!CanBeSaved())
 		return;
 
-	// Remember that this was the most recently saved player.
-	Files::Write(Files::Config() + "recent.txt", filePath + '\n');
+	// Take a snapshot of everything that needs to be saved now, so that the
+	// worker thread never touches the player or the game data.
+	string data = SaveToString();
+	DataWriter globalConditions;
+	GameData::GlobalConditions().Save(globalConditions);
+	string globalData = globalConditions.SaveToString();
+	const int previousCount = Preferences::GetPreviousSaveCount();
+	const bool spaceport = planet && planet->HasServices();
 
-	if(filePath.rfind(".txt") == filePath.length() - 4)
+	// Only one save may be in flight at a time, so that the backups are rotated
+	// in order.
+	WaitForSave();
+	pendingSave = saveQueue.Run([filePath = filePath, date = date, previousCount, spaceport,
+		data = std::move(data), globalData = std::move(globalData)]
 	{
-		// Only update the backups if this save will have a newer date.
-		SavedGame saved(filePath);
-		if(saved.GetDate() != date.ToString())
+		// Remember that this was the most recently saved player.
+		Files::Write(Files::Config() + "recent.txt", filePath + '\n');
+
+		if(filePath.rfind(".txt") == filePath.length() - 4)
 		{
-			string root = filePath.substr(0, filePath.length() - 4);
-			const int previousCount = Preferences::GetPreviousSaveCount();
-			const string rootPrevious = root + "~~previous-";
-			for(int i = previousCount - 1; i > 0; --i)
+			// Only update the backups if this save will have a newer date.
+			if(SavedDate(filePath) != date)
 			{
-				const string toMove = rootPrevious + to_string(i) + ".txt";
-				if(Files::Exists(toMove))
-					Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+				string root = filePath.substr(0, filePath.length() - 4);
+				const string rootPrevious = root + "~~previous-";
+				for(int i = previousCount - 1; i > 0; --i)
+				{
+					const string toMove = rootPrevious + to_string(i) + ".txt";
+					if(Files::Exists(toMove))
+						Files::Move(toMove, rootPrevious + to_string(i + 1) + ".txt");
+				}
+				// Copy rather than move the current save, so that a valid save
+				// exists under the main name even if the game dies right now.
+				if(Files::Exists(filePath))
+					Files::Copy(filePath, rootPrevious + "1.txt");
+				if(spaceport)
+					Files::WriteAtomic(rootPrevious + "spaceport.txt", data);
 			}
-			if(Files::Exists(filePath))
-				Files::Move(filePath, rootPrevious + "1.txt");
-			if(planet->HasServices())
-				Save(rootPrevious + "spaceport.txt");
 		}
-	}
 
-	Save(filePath);
+		Files::WriteAtomic(filePath, data);
 
-	// Save global conditions:
-	DataWriter globalConditions(Files::Config() + "global conditions.txt");
-	GameData::GlobalConditions().Save(globalConditions);
+		// Save global conditions:
+		Files::WriteAtomic(Files::Config() + "global conditions.txt", globalData);
+	});
 }
 
 
@@ -605,10 +665,7 @@ void PlayerInfo::AddEvent(const GameEvent &event, const Date &date)
 			AddChanges(eventChanges);
 	}
 	else
-	{
-		gameEvents.push_back(event);
-		gameEvents.back().SetDate(date);
-	}
+		gameEvents.emplace(date, event)->second.SetDate(date);
 }
 
 
@@ -725,19 +782,17 @@ const Date &PlayerInfo::GetDate() const
 void PlayerInfo::IncrementDate()
 {
 	++date;
+	dateEpoch.Bump();
+	fleetEpoch->Bump();
 
-	// Check if any special events should happen today.
-	auto it = gameEvents.begin();
+	// Check if any special events should happen today. The events are sorted
+	// by date, so only the ones at the front need to be checked. Applying an
+	// event may add more events, including ones that happen today.
 	list<DataNode> eventChanges;
-	while(it != gameEvents.end())
+	while(!gameEvents.empty() && !(date < gameEvents.begin()->first))
 	{
-		if(date < it->GetDate())
-			++it;
-		else
-		{
-			eventChanges.splice(eventChanges.end(), it->Apply(*this));
-			it = gameEvents.erase(it);
-		}
+		auto event = gameEvents.extract(gameEvents.begin());
+		eventChanges.splice(eventChanges.end(), event.mapped().Apply(*this));
 	}
 	if(!eventChanges.empty())
 		AddChanges(eventChanges);
@@ -784,7 +839,7 @@ void PlayerInfo::IncrementDate()
 
 	// For accounting, keep track of the player's net worth. This is for
 	// calculation of yearly income to determine maximum mortgage amounts.
-	int64_t assets = depreciation.Value(ships, date.DaysSinceEpoch());
+	int64_t assets = depreciation.FleetValue(ships, date.DaysSinceEpoch());
 	for(const shared_ptr<Ship> &ship : ships)
 		assets += ship->Cargo().Value(system);
 
@@ -827,6 +882,7 @@ void PlayerInfo::SetSystem(const System &system)
 {
 	this->previousSystem = this->system;
 	this->system = &system;
+	fleetEpoch->Bump();
 	Visit(system);
 }
 
@@ -851,6 +907,7 @@ const System *PlayerInfo::GetPreviousSystem() const
 void PlayerInfo::SetPlanet(const Planet *planet)
 {
 	this->planet = planet;
+	fleetEpoch->Bump();
 }
 
 
@@ -1053,6 +1110,7 @@ const shared_ptr<Ship> &PlayerInfo::FlagshipPtr()
 // Set the flagship (on departure or during flight).
 void PlayerInfo::SetFlagship(Ship &other)
 {
+	fleetEpoch->Bump();
 	// Remove active data in the old flagship.
 	if(flagship && flagship.get() != &other)
 		flagship->ClearTargetsAndOrders();
@@ -1171,6 +1229,7 @@ map<const shared_ptr<Ship>, vector<string>> PlayerInfo::FlightCheck() const
 void PlayerInfo::AddShip(const shared_ptr<Ship> &ship)
 {
 	ships.push_back(ship);
+	AddToFleetEpoch(*ship);
 	ship->SetIsSpecial();
 	ship->SetIsYours();
 	if(ship->HasBays())
@@ -1227,6 +1286,7 @@ const Ship *PlayerInfo::GiftShip(const Ship *model, const string &name, const st
 // Sell the given ship (if it belongs to the player).
 void PlayerInfo::SellShip(const Ship *selected, bool storeOutfits)
 {
+	fleetEpoch->Bump();
 	for(auto it = ships.begin(); it != ships.end(); ++it)
 		if(it->get() == selected)
 		{
@@ -1268,6 +1328,7 @@ void PlayerInfo::SellShip(const Ship *selected, bool storeOutfits)
 // instead of allowing the player to buy them back by putting them in the stock.
 void PlayerInfo::TakeShip(const Ship *shipToTake, const Ship *model, bool takeOutfits)
 {
+	fleetEpoch->Bump();
 	for(auto it = ships.begin(); it != ships.end(); ++it)
 		if(it->get() == shipToTake)
 		{
@@ -1298,6 +1359,7 @@ void PlayerInfo::TakeShip(const Ship *shipToTake, const Ship *model, bool takeOu
 
 vector<shared_ptr<Ship>>::iterator PlayerInfo::DisownShip(const Ship *selected)
 {
+	fleetEpoch->Bump();
 	for(auto it = ships.begin(); it != ships.end(); ++it)
 		if(it->get() == selected)
 		{
@@ -1315,6 +1377,7 @@ vector<shared_ptr<Ship>>::iterator PlayerInfo::DisownShip(const Ship *selected)
 // flying with the player, and requires no daily crew payments.
 void PlayerInfo::ParkShip(const Ship *selected, bool isParked)
 {
+	fleetEpoch->Bump();
 	for(auto &ship : ships)
 		if(ship.get() == selected)
 		{
@@ -1463,7 +1526,10 @@ const CargoHold &PlayerInfo::Cargo() const
 CargoHold &PlayerInfo::Storage()
 {
 	assert(planet && "can't get planetary storage in-flight");
-	return planetaryStorage[planet];
+	auto it = planetaryStorage.try_emplace(planet);
+	if(it.second)
+		it.first->second.SetPartOf(fleetEpoch);
+	return it.first->second;
 }
 
 
@@ -1509,6 +1575,7 @@ void PlayerInfo::Land(UI *ui)
 	// This can only be done while landed.
 	if(!system || !planet)
 		return;
+	fleetEpoch->Bump();
 
 	if(!freshlyLoaded)
 	{
@@ -1652,6 +1719,7 @@ bool PlayerInfo::TakeOff(UI *ui, const bool distributeCargo)
 	// This can only be done while landed.
 	if(!system || !planet)
 		return false;
+	fleetEpoch->Bump();
 
 	flagship = FlagshipPtr();
 	if(!flagship)
@@ -1865,6 +1933,7 @@ void PlayerInfo::PoolCargo()
 	// This can only be done while landed.
 	if(!planet)
 		return;
+	fleetEpoch->Bump();
 	for(const shared_ptr<Ship> &ship : ships)
 		if(ship->GetPlanet() == planet && !ship->IsParked())
 			ship->Cargo().TransferAll(cargo);
@@ -1874,6 +1943,7 @@ void PlayerInfo::PoolCargo()
 
 const CargoHold &PlayerInfo::DistributeCargo()
 {
+	fleetEpoch->Bump();
 	for(const shared_ptr<Ship> &ship : ships)
 		if(!ship->IsParked() && !ship->IsDisabled() && ship->GetPlanet() == planet)
 		{
@@ -1957,6 +2027,7 @@ bool PlayerInfo::HasLogs() const
 // hiring panel. Updates the information on how much space is available.
 void PlayerInfo::UpdateCargoCapacities()
 {
+	fleetEpoch->Bump();
 	int size = 0;
 	int bunks = 0;
 	flagship = FlagshipPtr();
@@ -2077,6 +2148,7 @@ void PlayerInfo::AcceptJob(const Mission &mission, UI *ui)
 			it->Do(Mission::ACCEPT, *this, ui);
 			auto spliceIt = it->IsUnique() ? missions.begin() : missions.end();
 			missions.splice(spliceIt, availableJobs, it);
+			missionsEpoch.Bump();
 			SortAvailable(); // Might not have cargo anymore, so some jobs can be sorted to end
 			break;
 		}
@@ -2218,6 +2290,7 @@ void PlayerInfo::MissionCallback(int response)
 		// to the front, so they appear at the top of the list if viewed.
 		auto spliceIt = mission.IsUnique() ? missions.begin() : missions.end();
 		missions.splice(spliceIt, missionList, missionList.begin());
+		missionsEpoch.Bump();
 		mission.Do(Mission::ACCEPT, *this);
 		if(shouldAutosave)
 			Autosave();
@@ -2263,6 +2336,7 @@ void PlayerInfo::RemoveMission(Mission::Trigger trigger, const Mission &mission,
 			// this first avoids the possibility of an infinite loop, e.g. if a
 			// mission's "on fail" fails the mission itself.
 			doneMissions.splice(doneMissions.end(), missions, it);
+			missionsEpoch.Bump();
 
 			it->Do(trigger, *this, ui);
 			cargo.RemoveMissionCargo(&mission);
@@ -2290,6 +2364,7 @@ void PlayerInfo::FailMission(const Mission &mission)
 // Update mission status based on an event.
 void PlayerInfo::HandleEvent(const ShipEvent &event, UI *ui)
 {
+	fleetEpoch->Bump();
 	// Combat rating increases when you disable an enemy ship.
 	if(event.ActorGovernment() && event.ActorGovernment()->IsPlayer())
 		if((event.Type() & ShipEvent::DISABLE) && event.Target() && !event.Target()->IsYours())
@@ -2299,8 +2374,27 @@ void PlayerInfo::HandleEvent(const ShipEvent &event, UI *ui)
 			rating = min(maxRating, rating + (event.Target()->Cost() + 250000) / 500000);
 		}
 
+	// Find the NPCs that the target of this event belongs to, which are listed
+	// in the same order as their missions.
+	if(npcIndexEpoch != missionsEpoch.Value())
+	{
+		npcIndex.clear();
+		for(Mission &mission : missions)
+			mission.IndexNPCs(npcIndex);
+		npcIndexEpoch = missionsEpoch.Value();
+	}
+	vector<pair<Mission *, NPC *>> npcs;
+	auto it = npcIndex.find(event.Target().get());
+	if(it != npcIndex.end())
+		npcs = it->second;
+
+	auto npcIt = npcs.begin();
 	for(Mission &mission : missions)
+	{
 		mission.Do(event, *this, ui);
+		for( ; npcIt != npcs.end() && npcIt->first == &mission; ++npcIt)
+			mission.Do(event, *npcIt->second, *this, ui);
+	}
 
 	// If the player's flagship was destroyed, the player is dead.
 	if((event.Type() & ShipEvent::DESTROY) && !ships.empty() && event.Target().get() == Flagship())
@@ -2366,12 +2460,14 @@ bool PlayerInfo::SetTribute(const Planet *planet, int64_t payment)
 	if(payment > 0)
 	{
 		tributeReceived[planet] = payment;
+		tributeEpoch.Bump();
 		// Properly connect this function to the dominated property of planets.
 		GameData::GetPolitics().DominatePlanet(planet);
 	}
 	else
 	{
 		tributeReceived.erase(planet);
+		tributeEpoch.Bump();
 		// Properly connect this function to the (no longer) dominated property of planets.
 		GameData::GetPolitics().DominatePlanet(planet, false);
 	}
@@ -3149,6 +3245,7 @@ void PlayerInfo::ValidateLoad()
 	// Validate the missions that were loaded. Active-but-invalid missions are removed from
 	// the standard mission list, effectively pausing them until necessary data is restored.
 	auto mit = stable_partition(missions.begin(), missions.end(), mem_fn(&Mission::IsValid));
+	missionsEpoch.Bump();
 	if(mit != missions.end())
 		inactiveMissions.splice(inactiveMissions.end(), missions, mit, missions.end());
 
@@ -3161,9 +3258,37 @@ void PlayerInfo::ValidateLoad()
 
 
 
+// Get a number that changes whenever the fleet, the outfits installed in it,
+// or the cargo it or the player's storage holds do. Those cargo holds and
+// ships bump the fleet epoch themselves whenever they change.
+uint64_t PlayerInfo::FleetEpoch() const
+{
+	return fleetEpoch->Value();
+}
+
+
+
+// Make a ship that has joined the fleet bump its epoch when it changes. A ship
+// that later leaves the fleet may still bump it, which is harmless.
+void PlayerInfo::AddToFleetEpoch(Ship &ship)
+{
+	fleetEpoch->Bump();
+	ship.SetPartOf(fleetEpoch);
+}
+
+
+
 // Helper to register derived conditions.
 void PlayerInfo::RegisterDerivedConditions()
 {
+	// Conditions that take some work to compute are cached until whatever they
+	// are derived from changes. The fleet is only cached while landed, because
+	// ships in flight change (e.g. by being disabled) without the player knowing.
+	auto dateEpochFun = [this]() -> uint64_t { return dateEpoch.Value(); };
+	auto accountEpochFun = [this]() -> uint64_t { return accounts.Epoch(); };
+	auto tributeEpochFun = [this]() -> uint64_t { return tributeEpoch.Value(); };
+	auto fleetEpochFun = [this]() -> uint64_t { return planet ? FleetEpoch() : 0; };
+
 	// Read-only date functions.
 	auto &&dayProvider = conditions.GetProviderNamed("day");
 	dayProvider.SetGetFunction([this](const string &name) { return date.Day(); });
@@ -3176,18 +3301,22 @@ void PlayerInfo::RegisterDerivedConditions()
 
 	auto &&daysSinceYearStartProvider = conditions.GetProviderNamed("days since year start");
 	daysSinceYearStartProvider.SetGetFunction([this](const string &name) { return date.DaysSinceYearStart(); });
+	daysSinceYearStartProvider.SetCacheEpoch(dateEpochFun);
 
 	auto &&daysUntilYearEndProvider = conditions.GetProviderNamed("days until year end");
 	daysUntilYearEndProvider.SetGetFunction([this](const string &name) { return date.DaysUntilYearEnd(); });
+	daysUntilYearEndProvider.SetCacheEpoch(dateEpochFun);
 
 	auto &&daysSinceEpochProvider = conditions.GetProviderNamed("days since epoch");
 	daysSinceEpochProvider.SetGetFunction([this](const string &name) { return date.DaysSinceEpoch(); });
+	daysSinceEpochProvider.SetCacheEpoch(dateEpochFun);
 
 	auto &&daysSinceStartProvider = conditions.GetProviderNamed("days since start");
 	daysSinceStartProvider.SetGetFunction([this](const string &name)
 	{
 		return date.DaysSinceEpoch() - StartData().GetDate().DaysSinceEpoch();
 	});
+	daysSinceStartProvider.SetCacheEpoch(dateEpochFun);
 
 	// Read-only account conditions.
 	// Bound financial conditions to +/- 4.6 x 10^18 credits, within the range of a 64-bit int.
@@ -3204,26 +3333,32 @@ void PlayerInfo::RegisterDerivedConditions()
 	auto &&unpaidMortgagesProvider = conditions.GetProviderNamed("unpaid mortgages");
 	unpaidMortgagesProvider.SetGetFunction([this](const string &name) {
 		return min(limit, accounts.TotalDebt("Mortgage")); });
+	unpaidMortgagesProvider.SetCacheEpoch(accountEpochFun);
 
 	auto &&unpaidFinesProvider = conditions.GetProviderNamed("unpaid fines");
 	unpaidFinesProvider.SetGetFunction([this](const string &name) {
 		return min(limit, accounts.TotalDebt("Fine")); });
+	unpaidFinesProvider.SetCacheEpoch(accountEpochFun);
 
 	auto &&unpaidDebtsProvider = conditions.GetProviderNamed("unpaid debts");
 	unpaidDebtsProvider.SetGetFunction([this](const string &name) {
 		return min(limit, accounts.TotalDebt("Debt")); });
+	unpaidDebtsProvider.SetCacheEpoch(accountEpochFun);
 
 	auto &&unpaidSalariesProvider = conditions.GetProviderNamed("unpaid salaries");
 	unpaidSalariesProvider.SetGetFunction([this](const string &name) {
 		return min(limit, accounts.CrewSalariesOwed()); });
+	unpaidSalariesProvider.SetCacheEpoch(accountEpochFun);
 
 	auto &&unpaidMaintenanceProvider = conditions.GetProviderNamed("unpaid maintenance");
 	unpaidMaintenanceProvider.SetGetFunction([this](const string &name) {
 		return min(limit, accounts.MaintenanceDue()); });
+	unpaidMaintenanceProvider.SetCacheEpoch(accountEpochFun);
 
 	auto &&creditScoreProvider = conditions.GetProviderNamed("credit score");
 	creditScoreProvider.SetGetFunction([this](const string &name) {
 		return accounts.CreditScore(); });
+	creditScoreProvider.SetCacheEpoch(accountEpochFun);
 
 	// Read/write assets and debts.
 	auto &&salaryIncomeProvider = conditions.GetProviderPrefixed("salary: ");
@@ -3261,6 +3396,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		return it->second;
 	};
 	tributeProvider.SetGetFunction(tributeHasGetFun);
+	tributeProvider.SetCacheEpoch(tributeEpochFun);
 	tributeProvider.SetSetFunction([this](const string &name, int64_t value) -> bool {
 		return SetTribute(name.substr(strlen("tribute: ")), value);
 	});
@@ -3431,6 +3567,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				retVal += ship->Attributes().Get("cargo space");
 		return retVal;
 	});
+	cargoSpaceProvider.SetCacheEpoch(fleetEpochFun);
 
 	auto &&passengerSpaceProvider = conditions.GetProviderNamed("passenger space");
 	passengerSpaceProvider.SetGetFunction([this](const string &name) -> int64_t
@@ -3443,6 +3580,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				retVal += ship->Attributes().Get("bunks") - ship->RequiredCrew();
 		return retVal;
 	});
+	passengerSpaceProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The number of active, present ships the player has of the given category
 	// (e.g. Heavy Warships).
@@ -3456,6 +3594,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				++retVal;
 		return retVal;
 	});
+	shipTypesProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The number of ships the player has of the given category anywhere in their fleet.
 	auto &&shipTypesAllProvider = conditions.GetProviderPrefixed("ships (all): ");
@@ -3467,6 +3606,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				++retVal;
 		return retVal;
 	});
+	shipTypesAllProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The number of ships the player has of the given model active and present.
 	auto &&shipModelProvider = conditions.GetProviderPrefixed("ship model: ");
@@ -3479,6 +3619,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				++retVal;
 		return retVal;
 	});
+	shipModelProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The number of ships that the player has of the given model anywhere in their fleet.
 	auto &&shipModelAllProvider = conditions.GetProviderPrefixed("ship model (all): ");
@@ -3490,6 +3631,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				++retVal;
 		return retVal;
 	});
+	shipModelAllProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The total number of ships the player has active and present.
 	auto &&totalPresentShipsProvider = conditions.GetProviderNamed("total ships");
@@ -3501,6 +3643,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				++retVal;
 		return retVal;
 	});
+	totalPresentShipsProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The total number of ships the player has anywhere.
 	auto &&totalAnywhereShipsProvider = conditions.GetProviderNamed("total ships (all)");
@@ -3512,6 +3655,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				++retVal;
 		return retVal;
 	});
+	totalAnywhereShipsProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks all sources of outfits which are present with the player.
 	// If in orbit, this means checking all ships in-system for installed and in cargo outfits.
@@ -3526,7 +3670,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		int64_t retVal = 0;
 		if(planet)
 		{
-			retVal += Cargo().Get(outfit);
+			retVal += cargo.Get(outfit);
 			auto it = planetaryStorage.find(planet);
 			if(it != planetaryStorage.end())
 				retVal += it->second.Get(outfit);
@@ -3545,6 +3689,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		}
 		return retVal;
 	});
+	presentOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// Conditions to determine what outfits the player owns, with various possible locations to check.
 	// The following condition checks all possible locations for outfits in the player's possession.
@@ -3554,7 +3699,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		const Outfit *outfit = GameData::Outfits().Find(name.substr(strlen("outfit (all): ")));
 		if(!outfit)
 			return 0;
-		int64_t retVal = Cargo().Get(outfit);
+		int64_t retVal = cargo.Get(outfit);
 		for(const shared_ptr<Ship> &ship : ships)
 		{
 			if(ship->IsDestroyed())
@@ -3566,6 +3711,7 @@ void PlayerInfo::RegisterDerivedConditions()
 			retVal += storage.second.Get(outfit);
 		return retVal;
 	});
+	allOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks the player's fleet for installed outfits on active
 	// escorts local to the player.
@@ -3589,6 +3735,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		}
 		return retVal;
 	});
+	presentInstalledOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks the player's fleet for installed outfits on parked escorts
 	// which are local to the player.
@@ -3610,6 +3757,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		}
 		return retVal;
 	});
+	parkedInstalledOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks the player's entire fleet for installed outfits.
 	auto &&allInstalledOutfitProvider = conditions.GetProviderPrefixed("outfit (all installed): ");
@@ -3624,6 +3772,7 @@ void PlayerInfo::RegisterDerivedConditions()
 				retVal += ship->OutfitCount(outfit);
 		return retVal;
 	});
+	allInstalledOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks the flagship's installed outfits.
 	auto &&flagshipInstalledOutfitProvider = conditions.GetProviderPrefixed("outfit (flagship installed): ");
@@ -3636,6 +3785,7 @@ void PlayerInfo::RegisterDerivedConditions()
 			return 0;
 		return flagship->OutfitCount(outfit);
 	});
+	flagshipInstalledOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks the player's fleet for outfits in the cargo of escorts
 	// local to the player.
@@ -3647,7 +3797,7 @@ void PlayerInfo::RegisterDerivedConditions()
 			return 0;
 		int64_t retVal = 0;
 		if(planet)
-			retVal += Cargo().Get(outfit);
+			retVal += cargo.Get(outfit);
 		for(const shared_ptr<Ship> &ship : ships)
 		{
 			// If not on a planet, parked ships in system don't count.
@@ -3659,6 +3809,7 @@ void PlayerInfo::RegisterDerivedConditions()
 		}
 		return retVal;
 	});
+	presentCargoOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks all cargo locations in the player's fleet.
 	auto &&allCargoOutfitProvider = conditions.GetProviderPrefixed("outfit (all cargo): ");
@@ -3669,12 +3820,13 @@ void PlayerInfo::RegisterDerivedConditions()
 			return 0;
 		int64_t retVal = 0;
 		if(planet)
-			retVal += Cargo().Get(outfit);
+			retVal += cargo.Get(outfit);
 		for(const shared_ptr<Ship> &ship : ships)
 			if(!ship->IsDestroyed())
 				retVal += ship->Cargo().Get(outfit);
 		return retVal;
 	});
+	allCargoOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks the flagship's cargo or the pooled cargo if landed.
 	auto &&flagshipCargoOutfitProvider = conditions.GetProviderPrefixed("outfit (flagship cargo): ");
@@ -3683,8 +3835,9 @@ void PlayerInfo::RegisterDerivedConditions()
 		const Outfit *outfit = GameData::Outfits().Find(name.substr(strlen("outfit (flagship cargo): ")));
 		if(!outfit)
 			return 0;
-		return (flagship ? flagship->Cargo().Get(outfit) : 0) + (planet ? Cargo().Get(outfit) : 0);
+		return (flagship ? flagship->Cargo().Get(outfit) : 0) + (planet ? cargo.Get(outfit) : 0);
 	});
+	flagshipCargoOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks planetary storage on the current planet, or on
 	// planets in the current system if in orbit.
@@ -3711,6 +3864,7 @@ void PlayerInfo::RegisterDerivedConditions()
 			return retVal;
 		}
 	});
+	presentStorageOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// The following condition checks all planetary storage.
 	auto &&allStorageOutfitProvider = conditions.GetProviderPrefixed("outfit (all storage): ");
@@ -3724,6 +3878,7 @@ void PlayerInfo::RegisterDerivedConditions()
 			retVal += storage.second.Get(outfit);
 		return retVal;
 	});
+	allStorageOutfitProvider.SetCacheEpoch(fleetEpochFun);
 
 	// This condition corresponds to the method by which the flagship entered the current system.
 	auto &&systemEntryProvider = conditions.GetProviderPrefixed("entered system by: ");
@@ -3932,19 +4087,24 @@ void PlayerInfo::RegisterDerivedConditions()
 // New missions are generated each time you land on a planet.
 void PlayerInfo::CreateMissions()
 {
+	// Anything may have happened to the fleet since the last time missions
+	// were offered, such as outfits being given to the flagship.
+	fleetEpoch->Bump();
 	boardingMissions.clear();
 
 	// Check for available missions.
 	bool skipJobs = planet && !planet->GetPort().HasService(Port::ServicesType::JobBoard);
 	bool hasPriorityMissions = false;
+	// Most missions are ruled out by their "to offer" conditions, and those
+	// results only change when one of the conditions they use is written to.
+	offerConditions.Update(conditions);
 	for(const auto &it : GameData::Missions())
 	{
 		if(it.second.IsAtLocation(Mission::BOARDING) || it.second.IsAtLocation(Mission::ASSISTING))
 			continue;
 		if(skipJobs && it.second.IsAtLocation(Mission::JOB))
 			continue;
-
-		if(it.second.CanOffer(*this))
+		if(it.second.CanOffer(*this, nullptr, &offerConditions))
 		{
 			list<Mission> &missions =
 				it.second.IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
@@ -4120,6 +4280,7 @@ void PlayerInfo::SortAvailable()
 // Visit, Complete, Fail), and remove now-complete or now-failed missions.
 void PlayerInfo::StepMissions(UI *ui)
 {
+	fleetEpoch->Bump();
 	// Check for NPCs that have been destroyed without their destruction
 	// being registered, e.g. by self-destruct:
 	for(Mission &mission : missions)
@@ -4220,20 +4381,32 @@ void PlayerInfo::Autosave() const
 		return;
 
 	string path = filePath.substr(0, filePath.length() - 4) + "~autosave.txt";
-	Save(path);
+	string data = SaveToString();
+	WaitForSave();
+	pendingSave = saveQueue.Run([path = std::move(path), data = std::move(data)]
+	{
+		Files::WriteAtomic(path, data);
+	});
 }
 
 
 
-void PlayerInfo::Save(const string &filePath) const
+string PlayerInfo::SaveToString() const
 {
 	if(transactionSnapshot)
-		transactionSnapshot->SaveToPath(filePath);
-	else
-	{
-		DataWriter out(filePath);
-		Save(out);
-	}
+		return transactionSnapshot->SaveToString();
+
+	DataWriter out;
+	Save(out);
+	return out.SaveToString();
+}
+
+
+
+void PlayerInfo::WaitForSave() const
+{
+	if(pendingSave.valid())
+		pendingSave.wait();
 }
 
 
@@ -4464,8 +4637,8 @@ void PlayerInfo::Save(DataWriter &out) const
 	}
 
 	// Save pending events, and changes that have happened due to past events.
-	for(const GameEvent &event : gameEvents)
-		event.Save(out);
+	for(const auto &it : gameEvents)
+		it.second.Save(out);
 	if(!dataChanges.empty())
 	{
 		out.Write("changes");
@@ -4662,6 +4835,7 @@ bool PlayerInfo::DisplayCarrierHelp() const
 void PlayerInfo::AddStockShip(const Ship *model, const string &name)
 {
 	ships.push_back(make_shared<Ship>(*model));
+	AddToFleetEpoch(*ships.back());
 	ships.back()->SetName(!name.empty() ? name : GameData::Phrases().Get("civilian")->Get());
 	ships.back()->SetSystem(system);
 	ships.back()->SetPlanet(planet);
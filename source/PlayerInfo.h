@@ -18,11 +18,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Account.h"
 #include "CargoHold.h"
+#include "ConditionCache.h"
 #include "ConditionsStore.h"
 #include "CoreStartData.h"
 #include "DataNode.h"
 #include "Date.h"
 #include "Depreciation.h"
+#include "EpochCounter.h"
 #include "EsUuid.h"
 #include "GameEvent.h"
 #include "Government.h"
@@ -31,11 +33,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SystemEntry.h"
 
 #include <chrono>
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -66,13 +70,13 @@ public:
 
 
 public:
-	PlayerInfo() = default;
+	PlayerInfo();
 	// Don't allow copying this class.
 	PlayerInfo(const PlayerInfo &) = delete;
 	PlayerInfo &operator=(const PlayerInfo &) = delete;
 	PlayerInfo(PlayerInfo &&) = default;
 	PlayerInfo &operator=(PlayerInfo &&) = default;
-	~PlayerInfo() noexcept = default;
+	~PlayerInfo() noexcept;
 
 	// Reset the player to an "empty" state, i.e. no player is loaded.
 	void Clear();
@@ -87,6 +91,10 @@ public:
 	bool LoadRecent();
 	// Save this player (using the Identifier() as the file name).
 	void Save() const;
+	// Block until the save that is being written in the background (if any) is done.
+	void WaitForSave() const;
+	// Serialize the player, or return the transaction snapshot if one is active.
+	std::string SaveToString() const;
 
 	// Get the root filename used for this player's saved game files. (If there
 	// are multiple pilots with the same name it may have a digit appended.)
@@ -347,6 +355,11 @@ private:
 	void ApplyChanges();
 	// After loading & applying changes, make sure the player & ship locations are sensible.
 	void ValidateLoad();
+	// Get a number that changes whenever the fleet, the outfits installed in it,
+	// or the cargo it or the player's storage holds do.
+	uint64_t FleetEpoch() const;
+	// Make a ship that has joined the fleet bump its epoch when it changes.
+	void AddToFleetEpoch(Ship &ship);
 	// Helper to register derived conditions.
 	void RegisterDerivedConditions();
 
@@ -354,7 +367,6 @@ private:
 	void CreateMissions();
 	void StepMissions(UI *ui);
 	void Autosave() const;
-	void Save(const std::string &path) const;
 	void Save(DataWriter &out) const;
 
 	// Check for and apply any punitive actions from planetary security.
@@ -430,6 +442,22 @@ private:
 	bool sortSeparatePossible = false;
 
 	ConditionsStore conditions;
+	// The results of each mission's "to offer" conditions, which only need to
+	// be tested again when the conditions they use change.
+	ConditionCache offerConditions;
+	// These change along with the date, the tribute received, and the ships in
+	// the player's fleet, so that conditions derived from them can be cached
+	// until they do. The cargo holds and ships in the fleet are part of its
+	// epoch, so that it changes whenever their contents do.
+	EpochCounter dateEpoch;
+	EpochCounter tributeEpoch;
+	std::shared_ptr<EpochCounter> fleetEpoch = std::make_shared<EpochCounter>();
+	// The NPCs of the active missions that each ship belongs to, in mission
+	// order, so that ship events are only sent to the NPCs they concern. This
+	// is rebuilt whenever the list of active missions changes.
+	std::unordered_map<const Ship *, std::vector<std::pair<Mission *, NPC *>>> npcIndex;
+	EpochCounter missionsEpoch;
+	uint64_t npcIndexEpoch = 0;
 	std::map<std::string, EsUuid> giftedShips;
 
 	std::set<const System *> seen;
@@ -452,8 +480,9 @@ private:
 	DataNode economy;
 	// Persons that have been killed in this player's universe:
 	std::vector<std::string> destroyedPersons;
-	// Events that are going to happen some time in the future:
-	std::list<GameEvent> gameEvents;
+	// Events that are going to happen some time in the future, in the order
+	// they will happen:
+	std::multimap<Date, GameEvent> gameEvents;
 
 	// The system and position therein to which the "orbits" system UI issued a move order.
 	std::pair<const System *, Point> interstellarEscortDestination;
@@ -471,6 +500,8 @@ private:
 	CoreStartData startData;
 
 	DataWriter *transactionSnapshot = nullptr;
+	// The file operations of the most recent save, which run on a worker thread.
+	mutable std::shared_future<void> pendingSave;
 };
 
 
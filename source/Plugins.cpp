@@ -202,6 +202,9 @@ const Plugin *Plugins::Load(const string &path)
 	// Get the name of the folder containing the plugin.
 	size_t pos = path.rfind('/', path.length() - 2) + 1;
 	string name = path.substr(pos, path.length() - 1 - pos);
+	// A plugin may also be the contents of a zip file.
+	if(name.size() > 4 && !name.compare(name.size() - 4, 4, ".zip"))
+		name.resize(name.size() - 4);
 
 	string pluginFile = path + "plugin.txt";
 	string aboutText;
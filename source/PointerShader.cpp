@@ -20,21 +20,32 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Screen.h"
 #include "Shader.h"
 
+#include <cstddef>
 #include <stdexcept>
+#include <vector>
 
 using namespace std;
 
 namespace {
+	// Everything needed to draw one pointer. Pointers are queued up between
+	// Bind() and Unbind(), and then all drawn with a single instanced draw call.
+	class Instance {
+	public:
+		float center[2];
+		float angle[2];
+		float size[2];
+		float offset;
+		float color[4];
+	};
+
 	Shader shader;
 	GLint scaleI;
-	GLint centerI;
-	GLint angleI;
-	GLint sizeI;
-	GLint offsetI;
-	GLint colorI;
 
 	GLuint vao;
 	GLuint vbo;
+	GLuint instanceVbo;
+
+	vector<Instance> instances;
 }
 
 
@@ -45,46 +56,45 @@ void PointerShader::Init()
 		"// vertex pointer shader\n"
 		"precision mediump float;\n"
 		"uniform vec2 scale;\n"
-		"uniform vec2 center;\n"
-		"uniform vec2 angle;\n"
-		"uniform vec2 size;\n"
-		"uniform float offset;\n"
 
 		"in vec2 vert;\n"
+		"in vec2 center;\n"
+		"in vec2 angle;\n"
+		"in vec2 size;\n"
+		"in float offset;\n"
+		"in vec4 color;\n"
 		"out vec2 coord;\n"
+		"out vec2 fragSize;\n"
+		"out vec4 fragColor;\n"
 
 		"void main() {\n"
 		"  coord = vert * size.x;\n"
 		"  vec2 base = center + angle * (offset - size.y * (vert.x + vert.y));\n"
 		"  vec2 wing = vec2(angle.y, -angle.x) * (size.x * .5 * (vert.x - vert.y));\n"
 		"  gl_Position = vec4((base + wing) * scale, 0, 1);\n"
+		"  fragSize = size;\n"
+		"  fragColor = color;\n"
 		"}\n";
 
 	static const char *fragmentCode =
 		"// fragment pointer shader\n"
 		"precision mediump float;\n"
-		"uniform vec4 color;\n"
-		"uniform vec2 size;\n"
-
 		"in vec2 coord;\n"
+		"in vec2 fragSize;\n"
+		"in vec4 fragColor;\n"
 		"out vec4 finalColor;\n"
 
 		"void main() {\n"
-		"  float height = (coord.x + coord.y) / size.x;\n"
+		"  float height = (coord.x + coord.y) / fragSize.x;\n"
 		"  float taper = height * height * height;\n"
-		"  taper *= taper * .5 * size.x;\n"
+		"  taper *= taper * .5 * fragSize.x;\n"
 		"  float alpha = clamp(.8 * min(coord.x, coord.y) - taper, 0.f, 1.f);\n"
 		"  alpha *= clamp(1.8 * (1. - height), 0.f, 1.f);\n"
-		"  finalColor = color * alpha;\n"
+		"  finalColor = fragColor * alpha;\n"
 		"}\n";
 
 	shader = Shader(vertexCode, fragmentCode);
 	scaleI = shader.Uniform("scale");
-	centerI = shader.Uniform("center");
-	angleI = shader.Uniform("angle");
-	sizeI = shader.Uniform("size");
-	offsetI = shader.Uniform("offset");
-	colorI = shader.Uniform("color");
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
@@ -103,6 +113,23 @@ void PointerShader::Init()
 	glEnableVertexAttribArray(shader.Attrib("vert"));
 	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 
+	// Every other attribute comes from the instance buffer, one per pointer.
+	glGenBuffers(1, &instanceVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	auto instanceAttrib = [](const char *name, GLint size, size_t offset)
+	{
+		GLint attrib = shader.Attrib(name);
+		glEnableVertexAttribArray(attrib);
+		glVertexAttribPointer(attrib, size, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			reinterpret_cast<const GLvoid *>(offset));
+		glVertexAttribDivisor(attrib, 1);
+	};
+	instanceAttrib("center", 2, offsetof(Instance, center));
+	instanceAttrib("angle", 2, offsetof(Instance, angle));
+	instanceAttrib("size", 2, offsetof(Instance, size));
+	instanceAttrib("offset", 1, offsetof(Instance, offset));
+	instanceAttrib("color", 4, offsetof(Instance, color));
+
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
@@ -139,26 +166,29 @@ void PointerShader::Bind()
 void PointerShader::Add(const Point &center, const Point &angle,
 	float width, float height, float offset, const Color &color)
 {
-	GLfloat c[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
-	glUniform2fv(centerI, 1, c);
-
-	GLfloat a[2] = {static_cast<float>(angle.X()), static_cast<float>(angle.Y())};
-	glUniform2fv(angleI, 1, a);
-
-	GLfloat size[2] = {width, height};
-	glUniform2fv(sizeI, 1, size);
-
-	glUniform1f(offsetI, offset);
-
-	glUniform4fv(colorI, 1, color.Get());
-
-	glDrawArrays(GL_TRIANGLES, 0, 3);
+	const float *rgba = color.Get();
+	instances.push_back({
+		{static_cast<float>(center.X()), static_cast<float>(center.Y())},
+		{static_cast<float>(angle.X()), static_cast<float>(angle.Y())},
+		{width, height},
+		offset,
+		{rgba[0], rgba[1], rgba[2], rgba[3]}});
 }
 
 
 
+// Draw all the pointers that were added since Bind() was called.
 void PointerShader::Unbind()
 {
+	if(!instances.empty())
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Instance) * instances.size(), instances.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 3, instances.size());
+		instances.clear();
+	}
+
 	glBindVertexArray(0);
 	glUseProgram(0);
 }
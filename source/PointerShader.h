@@ -22,6 +22,8 @@ class Point;
 
 
 // Functions for drawing triangular "pointers," e.g. for target crosshairs.
+// Pointers added in between Bind() and Unbind() are all drawn at once, with a
+// single draw call, by Unbind().
 class PointerShader {
 public:
 	static void Init();
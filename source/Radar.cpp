@@ -35,6 +35,17 @@ const int Radar::BLINK = 7;
 const int Radar::VIEWPORT = 8;
 const int Radar::STAR = 9;
 
+namespace {
+	// The number of different types of objects (and colors) on the radar.
+	const int TYPES = 10;
+
+	// Any unknown type is drawn as inactive.
+	uint8_t Type(int type)
+	{
+		return (type >= 0 && type < TYPES) ? type : Radar::INACTIVE;
+	}
+}
+
 
 
 void Radar::Clear()
@@ -57,7 +68,7 @@ void Radar::SetCenter(const Point &center)
 // given position should be in world units (not shrunk to radar units).
 void Radar::Add(int type, Point position, double outer, double inner)
 {
-	objects.emplace_back(GetColor(type).Opaque(), position - center, outer, inner);
+	objects.emplace_back(type, position - center, outer, inner);
 }
 
 
@@ -65,7 +76,7 @@ void Radar::Add(int type, Point position, double outer, double inner)
 // Add a pointer, pointing in the direction of the given vector.
 void Radar::AddPointer(int type, const Point &position)
 {
-	pointers.emplace_back(GetColor(type), position.Unit());
+	pointers.emplace_back(type, position.Unit());
 }
 
 
@@ -77,9 +88,9 @@ void Radar::AddViewportBoundary(const Point &vertex)
 	Point end(vertex.X(), vertex.Y() - copysign(200., vertex.Y()));
 
 	// Add the horizontal leg, pointing from start to vertex.
-	lines.emplace_back(GetColor(VIEWPORT), start, vertex - start);
+	lines.emplace_back(VIEWPORT, start, vertex - start);
 	// Add the vertical leg, pointing from end to vertex.
-	lines.emplace_back(GetColor(VIEWPORT), end, vertex - end);
+	lines.emplace_back(VIEWPORT, end, vertex - end);
 }
 
 
@@ -87,6 +98,11 @@ void Radar::AddViewportBoundary(const Point &vertex)
 // Draw the radar display at the given coordinates.
 void Radar::Draw(const Point &center, double scale, double radius, double pointerRadius) const
 {
+	// Objects are drawn fully opaque, while lines and pointers may not be.
+	Color opaque[TYPES];
+	for(int type = 0; type < TYPES; ++type)
+		opaque[type] = GetColor(type).Opaque();
+
 	// Draw any desired line vectors.
 	for(const Line &line : lines)
 	{
@@ -108,27 +124,27 @@ void Radar::Draw(const Point &center, double scale, double radius, double pointe
 		else if(endExcess > 0)
 			v -= endExcess * v.Unit();
 
-		LineShader::Draw(start + center, start + v + center, 1.f, line.color);
+		LineShader::Draw(start + center, start + v + center, 1.f, GetColor(line.type));
 	}
 
-	// Draw StellarObjects and ships.
+	// Draw StellarObjects and ships, all in a single batch.
 	RingShader::Bind();
 	for(const Object &object : objects)
 	{
-		Point position = object.position * scale;
+		Point position = Point(object.x, object.y) * scale;
 		double length = position.Length();
 		if(length > radius)
 			position *= radius / length;
 		position += center;
 
-		RingShader::Add(position, object.outer, object.inner, object.color);
+		RingShader::Add(position, object.outer, object.inner, opaque[object.type]);
 	}
 	RingShader::Unbind();
 
 	// Draw neighboring system indicators.
 	PointerShader::Bind();
 	for(const Pointer &pointer : pointers)
-		PointerShader::Add(center, pointer.unit, 10.f, 10.f, pointerRadius, pointer.color);
+		PointerShader::Add(center, Point(pointer.x, pointer.y), 10.f, 10.f, pointerRadius, GetColor(pointer.type));
 	PointerShader::Unbind();
 }
 
@@ -157,22 +173,22 @@ const Color &Radar::GetColor(int type)
 
 
 
-Radar::Object::Object(const Color &color, const Point &pos, double out, double in)
-	: color(color), position(pos), outer(out), inner(in)
+Radar::Object::Object(int type, const Point &pos, double out, double in)
+	: x(pos.X()), y(pos.Y()), outer(out), inner(in), type(Type(type))
 {
 }
 
 
 
-Radar::Pointer::Pointer(const Color &color, const Point &unit)
-	: color(color), unit(unit)
+Radar::Pointer::Pointer(int type, const Point &unit)
+	: x(unit.X()), y(unit.Y()), type(Type(type))
 {
 }
 
 
 
 // Create a line starting from "base" with length and angle described by "vector."
-Radar::Line::Line(const Color &color, const Point &base, const Point &vector)
-	: color(color), base(base), vector(vector)
+Radar::Line::Line(int type, const Point &base, const Point &vector)
+	: base(base), vector(vector), type(Type(type))
 {
 }
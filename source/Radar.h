@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Color.h"
 #include "Point.h"
 
+#include <cstdint>
 #include <vector>
 
 
@@ -60,31 +61,35 @@ public:
 
 
 private:
+	// The objects on the radar are stored as compactly as possible, with a
+	// type instead of a color. The colors are looked up when drawing.
 	class Object {
 	public:
-		Object(const Color &color, const Point &pos, double out, double in);
+		Object(int type, const Point &pos, double out, double in);
 
-		Color color;
-		Point position;
-		double outer;
-		double inner;
+		float x;
+		float y;
+		float outer;
+		float inner;
+		uint8_t type;
 	};
 
 	class Pointer {
 	public:
-		Pointer(const Color &color, const Point &unit);
+		Pointer(int type, const Point &unit);
 
-		Color color;
-		Point unit;
+		float x;
+		float y;
+		uint8_t type;
 	};
 
 	class Line {
 	public:
-		Line(const Color &color, const Point &base, const Point &vector);
+		Line(int type, const Point &base, const Point &vector);
 
-		Color color;
 		Point base;
 		Point vector;
+		uint8_t type;
 	};
 
 private:
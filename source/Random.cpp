@@ -49,6 +49,22 @@ void Random::Seed(uint64_t seed)
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
 	gen.seed(seed);
+	// Forget any value the normal distribution generated ahead of time, so
+	// that it is generated from the new seed instead.
+	normal.reset();
+}
+
+
+
+// Check whether each thread has its own generator, so that seeding it in
+// one thread has no effect on the numbers generated in any other.
+bool Random::IsPerThread()
+{
+#ifndef __linux__
+	return false;
+#else
+	return true;
+#endif
 }
 
 
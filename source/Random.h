@@ -28,6 +28,9 @@ public:
 	// Seed the generator (e.g. to make it produce exactly the same random
 	// numbers it produced previously).
 	static void Seed(uint64_t seed);
+	// Check whether each thread has its own generator, so that seeding it in
+	// one thread has no effect on the numbers generated in any other.
+	static bool IsPerThread();
 
 	static uint32_t Int();
 	static uint32_t Int(uint32_t modulus);
@@ -0,0 +1,359 @@
+/* Replay.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Replay.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// Every recording begins with this, followed by the version of the format.
+	const string MAGIC = "ESREPLAY";
+	const uint64_t VERSION = 1;
+
+	// Which inputs are present in each frame.
+	const uint8_t HAS_KEYS = 1;
+	const uint8_t HAS_COMMAND = 2;
+	const uint8_t HAS_MOUSE = 4;
+	const uint8_t HAS_POINTER = 8;
+
+	bool IsEqual(const Point &a, const Point &b)
+	{
+		return a.X() == b.X() && a.Y() == b.Y();
+	}
+
+	bool IsEqual(const Rectangle &a, const Rectangle &b)
+	{
+		return IsEqual(a.Center(), b.Center()) && IsEqual(a.Dimensions(), b.Dimensions());
+	}
+
+	// Integers are stored seven bits at a time, so small ones take one byte.
+	void WriteVarint(string &out, uint64_t value)
+	{
+		while(value >= 0x80)
+		{
+			out += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	void WriteDouble(string &out, double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		for(int i = 0; i < 8; ++i)
+			out += static_cast<char>(bits >> (8 * i));
+	}
+
+	void WritePoint(string &out, const Point &point)
+	{
+		WriteDouble(out, point.X());
+		WriteDouble(out, point.Y());
+	}
+
+	// Read the values written by the functions above. Reading past the end of
+	// the data returns zeros and marks the data as not valid.
+	class Reader {
+	public:
+		explicit Reader(const string &data) : data(data) {}
+
+		bool IsValid() const { return isValid; }
+		bool AtEnd() const { return pos >= data.size(); }
+
+		uint8_t Byte()
+		{
+			if(AtEnd())
+			{
+				isValid = false;
+				return 0;
+			}
+			return data[pos++];
+		}
+
+		uint64_t Varint()
+		{
+			uint64_t value = 0;
+			for(int shift = 0; shift < 64; shift += 7)
+			{
+				uint8_t byte = Byte();
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if(!(byte & 0x80))
+					return value;
+			}
+			isValid = false;
+			return 0;
+		}
+
+		double Double()
+		{
+			uint64_t bits = 0;
+			for(int i = 0; i < 8; ++i)
+				bits |= static_cast<uint64_t>(Byte()) << (8 * i);
+			double value;
+			memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		Point ReadPoint()
+		{
+			double x = Double();
+			return Point(x, Double());
+		}
+
+		string Bytes(uint64_t count)
+		{
+			if(count > data.size() - pos)
+			{
+				isValid = false;
+				pos = data.size();
+				return string();
+			}
+			pos += count;
+			return data.substr(pos - count, count);
+		}
+
+
+	private:
+		const string &data;
+		size_t pos = 0;
+		bool isValid = true;
+	};
+}
+
+
+
+bool Replay::Pointer::operator==(const Pointer &other) const
+{
+	return doClickNextStep == other.doClickNextStep && hasShift == other.hasShift
+		&& hasControl == other.hasControl && isRightClick == other.isRightClick
+		&& isRadarClick == other.isRadarClick && isTouch == other.isTouch
+		&& isDoubleTap == other.isDoubleTap && isFingerDown == other.isFingerDown
+		&& groupSelect == other.groupSelect && IsEqual(clickPoint, other.clickPoint)
+		&& IsEqual(uiClickBox, other.uiClickBox) && IsEqual(clickBox, other.clickBox);
+}
+
+
+
+// Check if the player gave no inputs at all in this step.
+bool Replay::Frame::IsEmpty() const
+{
+	return !keys && !command && !isMouseTurning && !hasPointer;
+}
+
+
+
+// Start a new recording.
+void Replay::Begin(uint64_t seed, const string &saveData)
+{
+	*this = Replay();
+	this->seed = seed;
+	this->saveData = saveData;
+}
+
+
+
+// Add the inputs given in the next step of the recording. Steps in which
+// the player gave no inputs do not need to be added.
+void Replay::Add(const Frame &frame)
+{
+	frames.push_back(frame);
+	steps = max(steps, frame.step);
+}
+
+
+
+// Mark the given number of steps as having been recorded.
+void Replay::SetSteps(int steps)
+{
+	this->steps = max(this->steps, steps);
+}
+
+
+
+uint64_t Replay::Seed() const
+{
+	return seed;
+}
+
+
+
+// The saved game this recording begins with.
+const string &Replay::SaveData() const
+{
+	return saveData;
+}
+
+
+
+// The number of steps in this recording.
+int Replay::Steps() const
+{
+	return steps;
+}
+
+
+
+// Get the inputs given in the given step, or an empty frame if there were
+// none. Steps must be asked for in increasing order.
+Replay::Frame Replay::Get(int step) const
+{
+	while(next < frames.size() && frames[next].step < step)
+		++next;
+	if(next < frames.size() && frames[next].step == step)
+		return frames[next];
+
+	Frame frame;
+	frame.step = step;
+	return frame;
+}
+
+
+
+// Convert this recording to its compact binary form.
+string Replay::ToString() const
+{
+	string out = MAGIC;
+	WriteVarint(out, VERSION);
+	WriteVarint(out, seed);
+	WriteVarint(out, steps);
+	WriteVarint(out, saveData.size());
+	out += saveData;
+
+	auto writeCommand = [&out](const Command &command)
+	{
+		WriteVarint(out, command.state);
+		WriteDouble(out, command.turn);
+	};
+
+	WriteVarint(out, frames.size());
+	int previous = 0;
+	for(const Frame &frame : frames)
+	{
+		WriteVarint(out, frame.step - previous);
+		previous = frame.step;
+
+		uint8_t flags = (frame.keys ? HAS_KEYS : 0) | (frame.command ? HAS_COMMAND : 0)
+			| (frame.isMouseTurning ? HAS_MOUSE : 0) | (frame.hasPointer ? HAS_POINTER : 0);
+		out += static_cast<char>(flags);
+		if(flags & HAS_KEYS)
+			writeCommand(frame.keys);
+		if(flags & HAS_COMMAND)
+			writeCommand(frame.command);
+		if(flags & HAS_MOUSE)
+			WritePoint(out, frame.mouse);
+		if(flags & HAS_POINTER)
+		{
+			const Pointer &pointer = frame.pointer;
+			out += static_cast<char>(pointer.doClickNextStep | (pointer.hasShift << 1) | (pointer.hasControl << 2)
+				| (pointer.isRightClick << 3) | (pointer.isRadarClick << 4) | (pointer.isTouch << 5)
+				| (pointer.isDoubleTap << 6));
+			WriteVarint(out, pointer.isFingerDown + 1);
+			WriteVarint(out, pointer.groupSelect + 1);
+			WritePoint(out, pointer.clickPoint);
+			WritePoint(out, pointer.uiClickBox.Center());
+			WritePoint(out, pointer.uiClickBox.Dimensions());
+			WritePoint(out, pointer.clickBox.Center());
+			WritePoint(out, pointer.clickBox.Dimensions());
+		}
+	}
+	return out;
+}
+
+
+
+// Convert this recording from its compact binary form. If the given data is
+// not a recording, this returns false and the recording is empty.
+bool Replay::FromString(const string &data)
+{
+	*this = Replay();
+
+	Reader in(data);
+	if(in.Bytes(MAGIC.size()) != MAGIC || in.Varint() != VERSION)
+		return false;
+
+	Replay result;
+	result.seed = in.Varint();
+	result.steps = in.Varint();
+	result.saveData = in.Bytes(in.Varint());
+
+	auto readCommand = [&in]()
+	{
+		Command command;
+		command.state = in.Varint();
+		command.turn = in.Double();
+		return command;
+	};
+
+	uint64_t count = in.Varint();
+	int previous = 0;
+	for(uint64_t i = 0; i < count && in.IsValid(); ++i)
+	{
+		Frame frame;
+		frame.step = previous + in.Varint();
+		previous = frame.step;
+
+		uint8_t flags = in.Byte();
+		if(flags & HAS_KEYS)
+			frame.keys = readCommand();
+		if(flags & HAS_COMMAND)
+			frame.command = readCommand();
+		frame.isMouseTurning = (flags & HAS_MOUSE);
+		if(frame.isMouseTurning)
+			frame.mouse = in.ReadPoint();
+		frame.hasPointer = (flags & HAS_POINTER);
+		if(frame.hasPointer)
+		{
+			Pointer &pointer = frame.pointer;
+			uint8_t bits = in.Byte();
+			pointer.doClickNextStep = bits & 1;
+			pointer.hasShift = bits & 2;
+			pointer.hasControl = bits & 4;
+			pointer.isRightClick = bits & 8;
+			pointer.isRadarClick = bits & 16;
+			pointer.isTouch = bits & 32;
+			pointer.isDoubleTap = bits & 64;
+			pointer.isFingerDown = static_cast<int>(in.Varint()) - 1;
+			pointer.groupSelect = static_cast<int>(in.Varint()) - 1;
+			pointer.clickPoint = in.ReadPoint();
+			Point center = in.ReadPoint();
+			pointer.uiClickBox = Rectangle(center, in.ReadPoint());
+			center = in.ReadPoint();
+			pointer.clickBox = Rectangle(center, in.ReadPoint());
+		}
+		result.frames.push_back(frame);
+	}
+	if(!in.IsValid() || !in.AtEnd())
+		return false;
+
+	*this = std::move(result);
+	return true;
+}
+
+
+
+// Keep track of how long the engine took to calculate each step while
+// playing this recording back.
+void Replay::AddStepTime(double seconds)
+{
+	stepTimes.push_back(seconds);
+}
+
+
+
+const vector<double> &Replay::StepTimes() const
+{
+	return stepTimes;
+}
@@ -0,0 +1,123 @@
+/* Replay.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "Command.h"
+#include "Point.h"
+#include "Rectangle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+// A recording of everything the player did while in flight, starting from a
+// take-off: the saved game the player took off with, the seed of the random
+// number generator, and the inputs the engine acted on in each step. Playing
+// it back gives the engine exactly the same inputs, so a session that had a
+// performance problem can be run again, as fast as possible and without any
+// graphics, to compare how long each step takes in different builds.
+class Replay {
+public:
+	// The state of the mouse or touchscreen pointer, as the engine tracks it.
+	class Pointer {
+	public:
+		bool operator==(const Pointer &other) const;
+		bool operator!=(const Pointer &other) const { return !(*this == other); }
+
+	public:
+		bool doClickNextStep = false;
+		bool hasShift = false;
+		bool hasControl = false;
+		bool isRightClick = false;
+		bool isRadarClick = false;
+		bool isTouch = false;
+		bool isDoubleTap = false;
+		int isFingerDown = -1;
+		int groupSelect = -1;
+		Point clickPoint;
+		Rectangle uiClickBox;
+		Rectangle clickBox;
+	};
+
+	// The inputs the engine acted on in a single step.
+	class Frame {
+	public:
+		// Check if the player gave no inputs at all in this step.
+		bool IsEmpty() const;
+
+	public:
+		// The step these inputs were given in, counting from the take-off.
+		int step = 0;
+		// The commands given with the keyboard (or by an integration test), and
+		// all the commands the flagship acted on, including any that were given
+		// with the mouse or a game controller.
+		Command keys;
+		Command command;
+		// Where the mouse was, if it was steering the flagship.
+		bool isMouseTurning = false;
+		Point mouse;
+		// The pointer state, if it changed in this step.
+		bool hasPointer = false;
+		Pointer pointer;
+	};
+
+
+public:
+	// Start a new recording.
+	void Begin(uint64_t seed, const std::string &saveData);
+	// Add the inputs given in the next step of the recording. Steps in which
+	// the player gave no inputs do not need to be added.
+	void Add(const Frame &frame);
+	// Mark the given number of steps as having been recorded.
+	void SetSteps(int steps);
+
+	uint64_t Seed() const;
+	// The saved game this recording begins with.
+	const std::string &SaveData() const;
+	// The number of steps in this recording.
+	int Steps() const;
+	// Get the inputs given in the given step, or an empty frame if there were
+	// none. Steps must be asked for in increasing order.
+	Frame Get(int step) const;
+
+	// Convert this recording to or from its compact binary form. If the given
+	// data is not a recording, this returns false and the recording is empty.
+	std::string ToString() const;
+	bool FromString(const std::string &data);
+
+	// Keep track of how long the engine took to calculate each step while
+	// playing this recording back.
+	void AddStepTime(double seconds);
+	const std::vector<double> &StepTimes() const;
+
+
+private:
+	uint64_t seed = 0;
+	std::string saveData;
+	int steps = 0;
+	std::vector<Frame> frames;
+	// The next frame that Get() will return.
+	mutable size_t next = 0;
+
+	std::vector<double> stepTimes;
+};
+
+
+
+#endif
@@ -0,0 +1,167 @@
+/* ResourceManifest.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ResourceManifest.h"
+
+#include "DataFile.h"
+#include "DataNode.h"
+#include "DataWriter.h"
+#include "Files.h"
+
+#include <algorithm>
+#include <ctime>
+#include <map>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// The name of the manifest packaged with the game's resources.
+	const string BUNDLED_MANIFEST = "manifest.txt";
+
+	struct Manifest {
+		// Every directory, relative to the source, and when it was last modified.
+		vector<pair<string, time_t>> directories;
+		// Every file, relative to the source, in sorted order.
+		vector<string> files;
+	};
+
+	string CachePath()
+	{
+		return Files::Config() + "manifests.txt";
+	}
+
+	// A manifest is a list of "directory" nodes, each holding the names of the
+	// files directly inside it. Directories are given relative to the source
+	// directory, and the source directory itself is "".
+	template <class Nodes>
+	Manifest Parse(const Nodes &nodes)
+	{
+		Manifest manifest;
+		for(const DataNode &node : nodes)
+			if(node.Token(0) == "directory" && node.Size() >= 2)
+			{
+				const string &directory = node.Token(1);
+				manifest.directories.emplace_back(directory, static_cast<time_t>(node.Size() >= 3 ? node.Value(2) : 0.));
+				for(const DataNode &child : node)
+					manifest.files.push_back(directory + child.Token(0));
+			}
+		sort(manifest.files.begin(), manifest.files.end());
+		return manifest;
+	}
+
+	void Write(DataWriter &out, const Manifest &manifest)
+	{
+		map<string, vector<string>> contents;
+		for(const string &file : manifest.files)
+		{
+			size_t split = file.rfind('/') + 1;
+			contents[file.substr(0, split)].push_back(file.substr(split));
+		}
+		for(const auto &[directory, time] : manifest.directories)
+		{
+			out.Write("directory", directory, static_cast<int64_t>(time));
+			out.BeginChild();
+			{
+				for(const string &name : contents[directory])
+					out.Write(name);
+			}
+			out.EndChild();
+		}
+	}
+
+	// Check whether nothing has been added to or removed from any directory in
+	// the manifest since it was made. If a directory's time is not known (which
+	// is the case for Android assets) the manifest can't be trusted.
+	bool IsCurrent(const string &source, const Manifest &manifest)
+	{
+		for(const auto &[directory, time] : manifest.directories)
+			if(!time || Files::Timestamp(source + directory) != time)
+				return false;
+		return !manifest.directories.empty();
+	}
+
+	Manifest Scan(const string &source)
+	{
+		Manifest manifest;
+		vector<string> pending(1);
+		while(!pending.empty())
+		{
+			string directory = std::move(pending.back());
+			pending.pop_back();
+
+			// Get the time before listing the contents, so that any change made
+			// during the scan will be caught the next time.
+			manifest.directories.emplace_back(directory, Files::Timestamp(source + directory));
+			for(const string &path : Files::List(source + directory))
+				manifest.files.push_back(path.substr(source.size()));
+			for(const string &path : Files::ListDirectories(source + directory))
+				pending.push_back(path.substr(source.size()));
+		}
+		sort(manifest.files.begin(), manifest.files.end());
+		return manifest;
+	}
+}
+
+
+
+void ResourceManifest::Load(const vector<string> &sources)
+{
+	// The game's resources, and any plugins bundled with them, do not change
+	// once packaged, so a manifest that was made then does not need checking.
+	const string &resources = Files::Resources();
+	bool hasBundled = false;
+	if(Files::Exists(resources + BUNDLED_MANIFEST))
+	{
+		Manifest bundled = Parse(DataFile(resources + BUNDLED_MANIFEST));
+		hasBundled = !bundled.files.empty();
+		if(hasBundled)
+			Files::AddManifest(resources, std::move(bundled.files));
+	}
+
+	map<string, Manifest> cache;
+	for(const DataNode &node : DataFile(CachePath()))
+		if(node.Token(0) == "source" && node.Size() >= 2)
+			cache[node.Token(1)] = Parse(node);
+
+	bool changed = false;
+	map<string, Manifest> manifests;
+	for(const string &source : sources)
+	{
+		if(hasBundled && !source.compare(0, resources.size(), resources))
+			continue;
+
+		auto it = cache.find(source);
+		bool isCurrent = (it != cache.end() && IsCurrent(source, it->second));
+		Manifest manifest = isCurrent ? std::move(it->second) : Scan(source);
+		changed |= !isCurrent;
+
+		Files::AddManifest(source, manifest.files);
+		manifests.emplace(source, std::move(manifest));
+	}
+
+	if(!changed)
+		return;
+	DataWriter out(CachePath());
+	for(const auto &[source, manifest] : manifests)
+	{
+		out.Write("source", source);
+		out.BeginChild();
+		{
+			Write(out, manifest);
+		}
+		out.EndChild();
+	}
+}
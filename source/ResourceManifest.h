@@ -0,0 +1,40 @@
+/* ResourceManifest.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef RESOURCE_MANIFEST_H_
+#define RESOURCE_MANIFEST_H_
+
+#include <string>
+#include <vector>
+
+
+
+// A list of every file in each of the game's source directories, so that
+// loading does not have to scan them one entry at a time. The game's own
+// resources may come with a manifest generated when they were packaged (by
+// utils/generate_manifest.py), which is trusted as is. Manifests for other
+// sources are cached in the config directory along with the modification time
+// of every directory they list, and a source is only scanned again when one of
+// those times changes.
+class ResourceManifest {
+public:
+	// Find or build the manifest for each source directory, and have
+	// Files::RecursiveList use them from now on.
+	static void Load(const std::vector<std::string> &sources);
+};
+
+
+
+#endif
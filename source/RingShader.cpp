@@ -21,24 +21,35 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Screen.h"
 #include "Shader.h"
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace std;
 
 namespace {
+	// Everything needed to draw one ring. Rings are queued up between Bind()
+	// and Unbind(), and then all drawn with a single instanced draw call.
+	class Instance {
+	public:
+		float position[2];
+		float radius;
+		float width;
+		float angle;
+		float startAngle;
+		float dash;
+		float color[4];
+	};
+
 	Shader shader;
 	GLint scaleI;
-	GLint positionI;
-	GLint radiusI;
-	GLint widthI;
-	GLint angleI;
-	GLint startAngleI;
-	GLint dashI;
-	GLint colorI;
 
 	GLuint vao;
 	GLuint vbo;
+	GLuint instanceVbo;
+
+	vector<Instance> instances;
 }
 
 
@@ -49,44 +60,60 @@ void RingShader::Init()
 		"// vertex ring shader\n"
 		"precision mediump float;\n"
 		"uniform vec2 scale;\n"
-		"uniform vec2 position;\n"
-		"uniform float radius;\n"
-		"uniform float width;\n"
 
 		"in vec2 vert;\n"
+		"in vec2 position;\n"
+		"in float radius;\n"
+		"in float width;\n"
+		"in float angle;\n"
+		"in float startAngle;\n"
+		"in float dash;\n"
+		"in vec4 color;\n"
 		"out vec2 coord;\n"
+		"out float fragRadius;\n"
+		"out float fragWidth;\n"
+		"out float fragAngle;\n"
+		"out float fragStartAngle;\n"
+		"out float fragDash;\n"
+		"out vec4 fragColor;\n"
 
 		"void main() {\n"
 		"  coord = (radius + width) * vert;\n"
 		"  gl_Position = vec4((coord + position) * scale, 0.f, 1.f);\n"
+		"  fragRadius = radius;\n"
+		"  fragWidth = width;\n"
+		"  fragAngle = angle;\n"
+		"  fragStartAngle = startAngle;\n"
+		"  fragDash = dash;\n"
+		"  fragColor = color;\n"
 		"}\n";
 
 	static const char *fragmentCode =
 		"// fragment ring shader\n"
 		"precision mediump float;\n"
-		"uniform vec4 color;\n"
-		"uniform float radius;\n"
-		"uniform float width;\n"
-		"uniform float angle;\n"
-		"uniform float startAngle;\n"
-		"uniform float dash;\n"
 		"const float pi = 3.1415926535897932384626433832795;\n"
 
 		"in vec2 coord;\n"
+		"in float fragRadius;\n"
+		"in float fragWidth;\n"
+		"in float fragAngle;\n"
+		"in float fragStartAngle;\n"
+		"in float fragDash;\n"
+		"in vec4 fragColor;\n"
 		"out vec4 finalColor;\n"
 
 		"void main() {\n"
-		"  float arc = mod(atan(coord.x, coord.y) + pi + startAngle, 2.f * pi);\n"
-		"  float arcFalloff = 1.f - min(2.f * pi - arc, arc - angle) * radius;\n"
-		"  if(dash != 0.f)\n"
+		"  float arc = mod(atan(coord.x, coord.y) + pi + fragStartAngle, 2.f * pi);\n"
+		"  float arcFalloff = 1.f - min(2.f * pi - arc, arc - fragAngle) * fragRadius;\n"
+		"  if(fragDash != 0.f)\n"
 		"  {\n"
-		"    arc = mod(arc, dash);\n"
-		"    arcFalloff = min(arcFalloff, min(arc, dash - arc) * radius);\n"
+		"    arc = mod(arc, fragDash);\n"
+		"    arcFalloff = min(arcFalloff, min(arc, fragDash - arc) * fragRadius);\n"
 		"  }\n"
 		"  float len = length(coord);\n"
-		"  float lenFalloff = width - abs(len - radius);\n"
+		"  float lenFalloff = fragWidth - abs(len - fragRadius);\n"
 		"  float alpha = clamp(min(arcFalloff, lenFalloff), 0.f, 1.f);\n"
-		"  finalColor = color * alpha;\n"
+		"  finalColor = fragColor * alpha;\n"
 		"}\n";
 
 	auto replace = [](std::string& s, const std::string& a, const std::string& b)
@@ -115,13 +142,6 @@ void RingShader::Init()
 		shader = Shader(vertexCode, fragmentCode);
 	}
 	scaleI = shader.Uniform("scale");
-	positionI = shader.Uniform("position");
-	radiusI = shader.Uniform("radius");
-	widthI = shader.Uniform("width");
-	angleI = shader.Uniform("angle");
-	startAngleI = shader.Uniform("startAngle");
-	dashI = shader.Uniform("dash");
-	colorI = shader.Uniform("color");
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
@@ -141,6 +161,25 @@ void RingShader::Init()
 	glEnableVertexAttribArray(shader.Attrib("vert"));
 	glVertexAttribPointer(shader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
 
+	// Every other attribute comes from the instance buffer, one per ring.
+	glGenBuffers(1, &instanceVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	auto instanceAttrib = [](const char *name, GLint size, size_t offset)
+	{
+		GLint attrib = shader.Attrib(name);
+		glEnableVertexAttribArray(attrib);
+		glVertexAttribPointer(attrib, size, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			reinterpret_cast<const GLvoid *>(offset));
+		glVertexAttribDivisor(attrib, 1);
+	};
+	instanceAttrib("position", 2, offsetof(Instance, position));
+	instanceAttrib("radius", 1, offsetof(Instance, radius));
+	instanceAttrib("width", 1, offsetof(Instance, width));
+	instanceAttrib("angle", 1, offsetof(Instance, angle));
+	instanceAttrib("startAngle", 1, offsetof(Instance, startAngle));
+	instanceAttrib("dash", 1, offsetof(Instance, dash));
+	instanceAttrib("color", 4, offsetof(Instance, color));
+
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
@@ -193,24 +232,31 @@ void RingShader::Add(const Point &pos, float out, float in, const Color &color)
 void RingShader::Add(const Point &pos, float radius, float width, float fraction,
 	const Color &color, float dash, float startAngle)
 {
-	GLfloat position[2] = {static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
-
-	glUniform1f(radiusI, radius);
-	glUniform1f(widthI, width);
-	glUniform1f(angleI, fraction * 2. * PI);
-	glUniform1f(startAngleI, startAngle * TO_RAD);
-	glUniform1f(dashI, dash ? 2. * PI / dash : 0.);
-
-	glUniform4fv(colorI, 1, color.Get());
-
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	const float *rgba = color.Get();
+	instances.push_back({
+		{static_cast<float>(pos.X()), static_cast<float>(pos.Y())},
+		radius,
+		width,
+		static_cast<float>(fraction * 2. * PI),
+		static_cast<float>(startAngle * TO_RAD),
+		static_cast<float>(dash ? 2. * PI / dash : 0.),
+		{rgba[0], rgba[1], rgba[2], rgba[3]}});
 }
 
 
 
+// Draw all the rings that were added since Bind() was called.
 void RingShader::Unbind()
 {
+	if(!instances.empty())
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(Instance) * instances.size(), instances.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances.size());
+		instances.clear();
+	}
+
 	glBindVertexArray(0);
 	glUseProgram(0);
 }
@@ -22,7 +22,8 @@ class Point;
 
 
 // Class representing a shader that draws round "dots," either filled in or with
-// transparent centers (i.e. circles or rings).
+// transparent centers (i.e. circles or rings). Rings added in between Bind() and
+// Unbind() are all drawn at once, with a single draw call, by Unbind().
 class RingShader {
 public:
 	static void Init();
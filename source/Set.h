@@ -16,30 +16,45 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef SET_H_
 #define SET_H_
 
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 
 
 // Template representing a set of named objects of a given type, where you can
 // query it for a pointer to any object and it will return one, whether or not that
 // object has been loaded yet. (This allows cyclic pointers.)
+// The objects are stored in a map, so that pointers to them never change and
+// iterating over them visits them in order of their names. Looking them up by
+// name is done using a separate hash table (with linear probing) of iterators
+// into that map, so that it does not require walking a tree of string compares.
 template<class Type>
 class Set {
 public:
+	Set() = default;
+	Set(const Set &other);
+	Set(Set &&other);
+	Set &operator=(const Set &other);
+	Set &operator=(Set &&other);
+
 	// Allow non-const access to the owner of this set; it can hand off only
 	// const references to avoid anyone else modifying the objects.
-	Type *Get(const std::string &name) { return &data[name]; }
-	const Type *Get(const std::string &name) const { return &data[name]; }
+	Type *Get(const std::string &name) { return &Insert(name)->second; }
+	const Type *Get(const std::string &name) const { return &Insert(name)->second; }
 	// If an item already exists in this set, get it. Otherwise, return a null
 	// pointer rather than creating the item.
 	const Type *Find(const std::string &name) const;
 
-	bool Has(const std::string &name) const { return data.count(name); }
+	bool Has(const std::string &name) const { return index[Probe(name, Hash(name))].isUsed; }
 
 	typename std::map<std::string, Type>::iterator begin() { return data.begin(); }
 	typename std::map<std::string, Type>::const_iterator begin() const { return data.begin(); }
-	typename std::map<std::string, Type>::const_iterator find(const std::string &key) const { return data.find(key); }
+	typename std::map<std::string, Type>::const_iterator find(const std::string &key) const;
 	typename std::map<std::string, Type>::iterator end() { return data.end(); }
 	typename std::map<std::string, Type>::const_iterator end() const { return data.end(); }
 
@@ -50,17 +65,100 @@ public:
 	void Revert(const Set<Type> &other);
 
 
+private:
+	class Slot {
+	public:
+		size_t hash = 0;
+		bool isUsed = false;
+		typename std::map<std::string, Type>::iterator it;
+	};
+
+
+private:
+	static size_t Hash(const std::string &name) { return std::hash<std::string>()(name); }
+	// Get the index of the slot holding the given name, or of the empty slot
+	// where it would be added if it is not in this set.
+	size_t Probe(const std::string &name, size_t hash) const;
+	// Get the entry with the given name, adding it if it does not exist.
+	typename std::map<std::string, Type>::iterator Insert(const std::string &name) const;
+	// Rebuild the hash table to hold every entry in the map, with room to add
+	// entries until it is half full.
+	void Reindex() const;
+
+
 private:
 	mutable std::map<std::string, Type> data;
+	// The size of the table is always a power of two, and it is always less
+	// than half full, so every probe sequence ends at an empty slot.
+	mutable std::vector<Slot> index = std::vector<Slot>(MIN_INDEX_SIZE);
+
+	static const size_t MIN_INDEX_SIZE = 16;
 };
 
 
 
+template <class Type>
+Set<Type>::Set(const Set &other)
+	: data(other.data)
+{
+	Reindex();
+}
+
+
+
+template <class Type>
+Set<Type>::Set(Set &&other)
+	: data(std::move(other.data))
+{
+	Reindex();
+	other.data.clear();
+	other.Reindex();
+}
+
+
+
+template <class Type>
+Set<Type> &Set<Type>::operator=(const Set &other)
+{
+	if(this != &other)
+	{
+		data = other.data;
+		Reindex();
+	}
+	return *this;
+}
+
+
+
+template <class Type>
+Set<Type> &Set<Type>::operator=(Set &&other)
+{
+	if(this != &other)
+	{
+		data = std::move(other.data);
+		Reindex();
+		other.data.clear();
+		other.Reindex();
+	}
+	return *this;
+}
+
+
+
 template <class Type>
 const Type *Set<Type>::Find(const std::string &name) const
 {
-	auto it = data.find(name);
-	return (it == data.end() ? nullptr : &it->second);
+	const Slot &slot = index[Probe(name, Hash(name))];
+	return (slot.isUsed ? &slot.it->second : nullptr);
+}
+
+
+
+template <class Type>
+typename std::map<std::string, Type>::const_iterator Set<Type>::find(const std::string &key) const
+{
+	const Slot &slot = index[Probe(key, Hash(key))];
+	return (slot.isUsed ? slot.it : data.end());
 }
 
 
@@ -87,6 +185,66 @@ void Set<Type>::Revert(const Set<Type> &other)
 		// There should never be a case when an entry in the set we are
 		// reverting to has a name that is not also in this set.
 	}
+	// Some entries may have been erased, so the hash table must be rebuilt.
+	Reindex();
+}
+
+
+
+// Get the index of the slot holding the given name, or of the empty slot
+// where it would be added if it is not in this set.
+template <class Type>
+size_t Set<Type>::Probe(const std::string &name, size_t hash) const
+{
+	const size_t mask = index.size() - 1;
+	size_t i = hash & mask;
+	for( ; index[i].isUsed; i = (i + 1) & mask)
+		if(index[i].hash == hash && index[i].it->first == name)
+			break;
+	return i;
+}
+
+
+
+// Get the entry with the given name, adding it if it does not exist.
+template <class Type>
+typename std::map<std::string, Type>::iterator Set<Type>::Insert(const std::string &name) const
+{
+	const size_t hash = Hash(name);
+	size_t i = Probe(name, hash);
+	if(index[i].isUsed)
+		return index[i].it;
+
+	auto it = data.emplace_hint(data.lower_bound(name), std::piecewise_construct,
+		std::forward_as_tuple(name), std::forward_as_tuple());
+	if(2 * data.size() >= index.size())
+		Reindex();
+	else
+		index[i] = Slot{hash, true, it};
+	return it;
+}
+
+
+
+// Rebuild the hash table to hold every entry in the map, with room to add
+// entries until it is half full.
+template <class Type>
+void Set<Type>::Reindex() const
+{
+	size_t size = MIN_INDEX_SIZE;
+	while(size <= 2 * data.size())
+		size *= 2;
+	index.assign(size, Slot());
+
+	const size_t mask = size - 1;
+	for(auto it = data.begin(); it != data.end(); ++it)
+	{
+		const size_t hash = Hash(it->first);
+		size_t i = hash & mask;
+		while(index[i].isUsed)
+			i = (i + 1) & mask;
+		index[i] = Slot{hash, true, it};
+	}
 }
 
 
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Ship.h"
 
+#include "AssetHandle.h"
 #include "Audio.h"
 #include "CategoryList.h"
 #include "CategoryTypes.h"
@@ -54,6 +55,19 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	const AssetHandle<Effect> BASIC_LAUNCH("basic launch");
+	const AssetHandle<Effect> SMOKE("smoke");
+	const AssetHandle<Effect> ION_SPARK("ion spark");
+	const AssetHandle<Effect> SCRAMBLE_SPARK("scramble spark");
+	const AssetHandle<Effect> DISRUPTION_SPARK("disruption spark");
+	const AssetHandle<Effect> SLOWING_SPARK("slowing spark");
+	const AssetHandle<Effect> DISCHARGE_SPARK("discharge spark");
+	const AssetHandle<Effect> CORROSION_SPARK("corrosion spark");
+	const AssetHandle<Effect> LEAKAGE_SPARK("leakage spark");
+	const AssetHandle<Effect> BURNING_SPARK("burning spark");
+	const AssetHandle<Effect> JUMP_DRIVE_SPARK("jump drive");
+	const AssetHandle<Sound> SCAN_SOUND("scan");
+
 	const string FIGHTER_REPAIR = "Repair fighters in";
 	const vector<string> BAY_SIDE = {"inside", "over", "under"};
 	const vector<string> BAY_FACING = {"forward", "left", "right", "back"};
@@ -230,6 +244,7 @@ Ship::Ship(const DataNode &node)
 
 void Ship::Load(const DataNode &node)
 {
+	outfitEpoch.Bump();
 	if(node.Size() >= 2)
 		trueModelName = node.Token(1);
 	if(node.Size() >= 3)
@@ -601,6 +616,7 @@ void Ship::Load(const DataNode &node)
 // loaded yet. So, wait until everything has been loaded, then call this.
 void Ship::FinishLoading(bool isNewInstance)
 {
+	outfitEpoch.Bump();
 	// All copies of this ship should save pointers to the "explosion" weapon
 	// definition stored safely in the ship model, which will not be destroyed
 	// until GameData is when the program quits. Also copy other attributes of
@@ -837,7 +853,7 @@ void Ship::FinishLoading(bool isNewInstance)
 		else
 			++it;
 		if(bay.side == Bay::INSIDE && bay.launchEffects.empty() && Crew())
-			bay.launchEffects.emplace_back(GameData::Effects().Get("basic launch"));
+			bay.launchEffects.emplace_back(BASIC_LAUNCH.Get());
 	}
 
 	canBeCarried = bayCategories.Contains(attributes.Category());
@@ -855,6 +871,7 @@ void Ship::FinishLoading(bool isNewInstance)
 		warning += "Defaulting " + string(attributes.Get("drag") ? "invalid" : "missing") + " \"drag\" attribute to 100.0\n";
 		attributes.Set("drag", 100.);
 	}
+	derivedStats.Calibrate(attributes);
 
 	// Calculate the values used to determine this ship's value and danger.
 	attraction = CalculateAttraction();
@@ -1169,6 +1186,7 @@ const string &Ship::Name() const
 void Ship::SetTrueModelName(const string &model)
 {
 	this->trueModelName = model;
+	outfitEpoch.Bump();
 }
 
 
@@ -1611,8 +1629,11 @@ const FireCommand &Ship::FiringCommands() const noexcept
 // Move this ship. A ship may create effects as it moves, in particular if
 // it is in the process of blowing up. If this returns false, the ship
 // should be deleted.
-void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
+void Ship::MoveSelf(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 {
+	pendingMove = PendingMove::NONE;
+	isUsingAfterburner = false;
+
 	// Do nothing with ships that are being forgotten.
 	if(StepFlags())
 		return;
@@ -1632,36 +1653,55 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	DoJettison(flotsam);
 	DoCloakDecision();
 
-	bool isUsingAfterburner = false;
-
 	// Don't let the ship do anything else if it is being destroyed.
-	if(!isBeingDestroyed)
+	if(isBeingDestroyed)
 	{
-		// See if the ship is entering hyperspace.
-		// If it is, nothing more needs to be done here.
-		if(DoHyperspaceLogic(visuals))
-			return;
+		pendingMove = PendingMove::DRIFT;
+		return;
+	}
 
-		// Check if we're trying to land.
-		// If we landed, we're done.
-		if(DoLandingLogic())
-			return;
+	// Entering or leaving hyperspace, landing, and departing all depend on
+	// where other ships are, so they are left for FinishMove().
+	if(hyperspaceSystem || hyperspaceCount || landingPlanet || zoom < 1.f)
+	{
+		pendingMove = PendingMove::TRAVEL;
+		return;
+	}
+
+	// Move the turrets.
+	if(!isDisabled)
+		armament.Aim(firingCommands);
+
+	DoInitializeMovement();
+	StepPilot();
+	DoMovement(isUsingAfterburner);
+	pendingMove = PendingMove::FLY;
+}
 
-		// Move the turrets.
-		if(!isDisabled)
-			armament.Aim(firingCommands);
 
-		DoInitializeMovement();
-		StepPilot();
-		DoMovement(isUsingAfterburner);
-		StepTargeting();
+
+void Ship::FinishMove(vector<Visual> &visuals)
+{
+	if(pendingMove == PendingMove::NONE)
+		return;
+
+	if(pendingMove == PendingMove::TRAVEL)
+	{
+		// See if the ship is entering hyperspace. If not, it is landing.
+		// Either way, nothing more needs to be done here.
+		if(!DoHyperspaceLogic(visuals))
+			DoLandingLogic();
+		return;
 	}
 
+	if(pendingMove == PendingMove::FLY)
+		StepTargeting();
+
 	// Move the ship.
 	position += velocity;
 
 	// Show afterburner flares unless the ship is being destroyed.
-	if(!isBeingDestroyed)
+	if(pendingMove == PendingMove::FLY)
 		DoEngineVisuals(visuals, isUsingAfterburner);
 
 	// Start fading the damage overlay.
@@ -1920,7 +1960,7 @@ int Ship::Scan(const PlayerInfo &player)
 	auto playScanSounds = [](const map<const Sound *, int> &sounds, Point &position)
 	{
 		if(sounds.empty())
-			Audio::Play(Audio::Get("scan"), position);
+			Audio::Play(SCAN_SOUND.Get(), position);
 		else
 			for(const auto &sound : sounds)
 				Audio::Play(sound.first, position);
@@ -3429,6 +3469,13 @@ const Outfit &Ship::BaseAttributes() const
 
 
 
+const ShipDerivedStats &Ship::DerivedStats() const
+{
+	return derivedStats;
+}
+
+
+
 // Get outfit information.
 const map<const Outfit *, int> &Ship::Outfits() const
 {
@@ -3437,6 +3484,22 @@ const map<const Outfit *, int> &Ship::Outfits() const
 
 
 
+uint64_t Ship::OutfitEpoch() const
+{
+	return outfitEpoch.Value();
+}
+
+
+
+// Bump the given epoch too whenever this ship's outfits or cargo change.
+void Ship::SetPartOf(const shared_ptr<EpochCounter> &fleetEpoch)
+{
+	outfitEpoch.SetPartOf(fleetEpoch);
+	cargo.SetPartOf(fleetEpoch);
+}
+
+
+
 int Ship::OutfitCount(const Outfit *outfit) const
 {
 	auto it = outfits.find(outfit);
@@ -3450,6 +3513,7 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 {
 	if(outfit && count)
 	{
+		outfitEpoch.Bump();
 		auto it = outfits.find(outfit);
 		int before = outfits.count(outfit);
 		if(it == outfits.end())
@@ -3462,6 +3526,10 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 		}
 		int after = outfits.count(outfit);
 		attributes.Add(*outfit, count);
+		// Ammunition is added and removed with every shot, and usually has
+		// none of the attributes that the derived stats are calculated from.
+		if(ShipDerivedStats::IsAffectedBy(*outfit))
+			derivedStats.Calibrate(attributes);
 		if(outfit->IsWeapon())
 		{
 			armament.Add(outfit, count);
@@ -3795,7 +3863,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 	{
 		if(!forget)
 		{
-			const Effect *effect = GameData::Effects().Get("smoke");
+			const Effect *effect = SMOKE.Get();
 			double size = Width() + Height();
 			double scale = .03 * size + .5;
 			double radius = .2 * size;
@@ -3892,7 +3960,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 
 
 
-// Generate energy, heat, etc. (This is called by Move().)
+// Generate energy, heat, etc. (This is called by MoveSelf().)
 void Ship::DoGeneration()
 {
 	// First, allow any carried ships to do their own generation.
@@ -3911,36 +3979,21 @@ void Ship::DoGeneration()
 		// 4. Shields of carried fighters
 		// 5. Transfer of excess energy and fuel to carried fighters.
 
-		const double hullAvailable = (attributes.Get("hull repair rate")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull repair rate")))
-			* (1. + attributes.Get("hull repair multiplier"));
-		const double hullEnergy = (attributes.Get("hull energy")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull energy")))
-			* (1. + attributes.Get("hull energy multiplier")) / hullAvailable;
-		const double hullFuel = (attributes.Get("hull fuel")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull fuel")))
-			* (1. + attributes.Get("hull fuel multiplier")) / hullAvailable;
-		const double hullHeat = (attributes.Get("hull heat")
-			+ (hullDelay ? 0 : attributes.Get("delayed hull heat")))
-			* (1. + attributes.Get("hull heat multiplier")) / hullAvailable;
-		double hullRemaining = hullAvailable;
-		DoRepair(hull, hullRemaining, MaxHull(),
+		const ShipDerivedStats::Repair &hullRepair = hullDelay ? derivedStats.hullDuringDelay : derivedStats.hull;
+		const double hullEnergy = hullRepair.energy;
+		const double hullFuel = hullRepair.fuel;
+		const double hullHeat = hullRepair.heat;
+		double hullRemaining = hullRepair.rate;
+		DoRepair(hull, hullRemaining, derivedStats.maxHull,
 			energy, hullEnergy, fuel, hullFuel, heat, hullHeat);
 
-		const double shieldsAvailable = (attributes.Get("shield generation")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield generation")))
-			* (1. + attributes.Get("shield generation multiplier"));
-		const double shieldsEnergy = (attributes.Get("shield energy")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield energy")))
-			* (1. + attributes.Get("shield energy multiplier")) / shieldsAvailable;
-		const double shieldsFuel = (attributes.Get("shield fuel")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield fuel")))
-			* (1. + attributes.Get("shield fuel multiplier")) / shieldsAvailable;
-		const double shieldsHeat = (attributes.Get("shield heat")
-			+ (shieldDelay ? 0 : attributes.Get("delayed shield heat")))
-			* (1. + attributes.Get("shield heat multiplier")) / shieldsAvailable;
-		double shieldsRemaining = shieldsAvailable;
-		DoRepair(shields, shieldsRemaining, MaxShields(),
+		const ShipDerivedStats::Repair &shieldsRepair = shieldDelay ? derivedStats.shieldsDuringDelay
+			: derivedStats.shields;
+		const double shieldsEnergy = shieldsRepair.energy;
+		const double shieldsFuel = shieldsRepair.fuel;
+		const double shieldsHeat = shieldsRepair.heat;
+		double shieldsRemaining = shieldsRepair.rate;
+		DoRepair(shields, shieldsRemaining, derivedStats.maxShields,
 			energy, shieldsEnergy, fuel, shieldsFuel, heat, shieldsHeat);
 
 		if(!bays.empty())
@@ -3974,15 +4027,15 @@ void Ship::DoGeneration()
 
 			// Now that there is no more need to use energy for hull and shield
 			// repair, if there is still excess energy, transfer it.
-			double energyRemaining = energy - attributes.Get("energy capacity");
-			double fuelRemaining = fuel - attributes.Get("fuel capacity");
+			double energyRemaining = energy - derivedStats.energyCapacity;
+			double fuelRemaining = fuel - derivedStats.fuelCapacity;
 			for(const pair<double, Ship *> &it : carried)
 			{
 				Ship &ship = *it.second;
 				if(energyRemaining > 0.)
-					DoRepair(ship.energy, energyRemaining, ship.attributes.Get("energy capacity"));
+					DoRepair(ship.energy, energyRemaining, ship.derivedStats.energyCapacity);
 				if(fuelRemaining > 0.)
-					DoRepair(ship.fuel, fuelRemaining, ship.attributes.Get("fuel capacity"));
+					DoRepair(ship.fuel, fuelRemaining, ship.derivedStats.fuelCapacity);
 			}
 
 			// Carried ships can recharge energy from their parent's batteries,
@@ -3991,7 +4044,7 @@ void Ship::DoGeneration()
 			{
 				Ship &ship = *it.second;
 				if(ship.HasDeployOrder())
-					DoRepair(ship.energy, energy, ship.attributes.Get("energy capacity"));
+					DoRepair(ship.energy, energy, ship.derivedStats.energyCapacity);
 			}
 		}
 		// Decrease the shield and hull delays by 1 now that shield generation
@@ -4039,106 +4092,80 @@ void Ship::DoGeneration()
 	// TODO: Mothership gives status resistance to carried ships?
 	if(ionization)
 	{
-		double ionResistance = attributes.Get("ion resistance");
-		double ionEnergy = attributes.Get("ion resistance energy") / ionResistance;
-		double ionFuel = attributes.Get("ion resistance fuel") / ionResistance;
-		double ionHeat = attributes.Get("ion resistance heat") / ionResistance;
-		DoStatusEffect(isDisabled, ionization, ionResistance,
-			energy, ionEnergy, fuel, ionFuel, heat, ionHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.ion;
+		DoStatusEffect(isDisabled, ionization, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	if(scrambling)
 	{
-		double scramblingResistance = attributes.Get("scramble resistance");
-		double scramblingEnergy = attributes.Get("scramble resistance energy") / scramblingResistance;
-		double scramblingFuel = attributes.Get("scramble resistance fuel") / scramblingResistance;
-		double scramblingHeat = attributes.Get("scramble resistance heat") / scramblingResistance;
-		DoStatusEffect(isDisabled, scrambling, scramblingResistance,
-			energy, scramblingEnergy, fuel, scramblingFuel, heat, scramblingHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.scramble;
+		DoStatusEffect(isDisabled, scrambling, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	if(disruption)
 	{
-		double disruptionResistance = attributes.Get("disruption resistance");
-		double disruptionEnergy = attributes.Get("disruption resistance energy") / disruptionResistance;
-		double disruptionFuel = attributes.Get("disruption resistance fuel") / disruptionResistance;
-		double disruptionHeat = attributes.Get("disruption resistance heat") / disruptionResistance;
-		DoStatusEffect(isDisabled, disruption, disruptionResistance,
-			energy, disruptionEnergy, fuel, disruptionFuel, heat, disruptionHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.disruption;
+		DoStatusEffect(isDisabled, disruption, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	if(slowness)
 	{
-		double slowingResistance = attributes.Get("slowing resistance");
-		double slowingEnergy = attributes.Get("slowing resistance energy") / slowingResistance;
-		double slowingFuel = attributes.Get("slowing resistance fuel") / slowingResistance;
-		double slowingHeat = attributes.Get("slowing resistance heat") / slowingResistance;
-		DoStatusEffect(isDisabled, slowness, slowingResistance,
-			energy, slowingEnergy, fuel, slowingFuel, heat, slowingHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.slowing;
+		DoStatusEffect(isDisabled, slowness, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	if(discharge)
 	{
-		double dischargeResistance = attributes.Get("discharge resistance");
-		double dischargeEnergy = attributes.Get("discharge resistance energy") / dischargeResistance;
-		double dischargeFuel = attributes.Get("discharge resistance fuel") / dischargeResistance;
-		double dischargeHeat = attributes.Get("discharge resistance heat") / dischargeResistance;
-		DoStatusEffect(isDisabled, discharge, dischargeResistance,
-			energy, dischargeEnergy, fuel, dischargeFuel, heat, dischargeHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.discharge;
+		DoStatusEffect(isDisabled, discharge, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	if(corrosion)
 	{
-		double corrosionResistance = attributes.Get("corrosion resistance");
-		double corrosionEnergy = attributes.Get("corrosion resistance energy") / corrosionResistance;
-		double corrosionFuel = attributes.Get("corrosion resistance fuel") / corrosionResistance;
-		double corrosionHeat = attributes.Get("corrosion resistance heat") / corrosionResistance;
-		DoStatusEffect(isDisabled, corrosion, corrosionResistance,
-			energy, corrosionEnergy, fuel, corrosionFuel, heat, corrosionHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.corrosion;
+		DoStatusEffect(isDisabled, corrosion, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	if(leakage)
 	{
-		double leakResistance = attributes.Get("leak resistance");
-		double leakEnergy = attributes.Get("leak resistance energy") / leakResistance;
-		double leakFuel = attributes.Get("leak resistance fuel") / leakResistance;
-		double leakHeat = attributes.Get("leak resistance heat") / leakResistance;
-		DoStatusEffect(isDisabled, leakage, leakResistance,
-			energy, leakEnergy, fuel, leakFuel, heat, leakHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.leak;
+		DoStatusEffect(isDisabled, leakage, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	if(burning)
 	{
-		double burnResistance = attributes.Get("burn resistance");
-		double burnEnergy = attributes.Get("burn resistance energy") / burnResistance;
-		double burnFuel = attributes.Get("burn resistance fuel") / burnResistance;
-		double burnHeat = attributes.Get("burn resistance heat") / burnResistance;
-		DoStatusEffect(isDisabled, burning, burnResistance,
-			energy, burnEnergy, fuel, burnFuel, heat, burnHeat);
+		const ShipDerivedStats::Resistance &resistance = derivedStats.burn;
+		DoStatusEffect(isDisabled, burning, resistance.resistance,
+			energy, resistance.energy, fuel, resistance.fuel, heat, resistance.heat);
 	}
 
 	// When ships recharge, what actually happens is that they can exceed their
 	// maximum capacity for the rest of the turn, but must be clamped to the
 	// maximum here before they gain more. This is so that, for example, a ship
 	// with no batteries but a good generator can still move.
-	energy = min(energy, attributes.Get("energy capacity"));
-	fuel = min(fuel, attributes.Get("fuel capacity"));
+	energy = min(energy, derivedStats.energyCapacity);
+	fuel = min(fuel, derivedStats.fuelCapacity);
 
-	heat -= heat * HeatDissipation();
+	heat -= heat * derivedStats.heatDissipation;
 	if(heat > MaximumHeat())
 	{
 		isOverheated = true;
-		double heatRatio = Heat() / (1. + attributes.Get("overheat damage threshold"));
+		double heatRatio = Heat() / (1. + derivedStats.overheatDamageThreshold);
 		if(heatRatio > 1.)
-			hull -= attributes.Get("overheat damage rate") * heatRatio;
+			hull -= derivedStats.overheatDamageRate * heatRatio;
 	}
 	else if(heat < .9 * MaximumHeat())
 		isOverheated = false;
 
-	double maxShields = MaxShields();
-	shields = min(shields, maxShields);
-	double maxHull = MaxHull();
-	hull = min(hull, maxHull);
+	shields = min(shields, derivedStats.maxShields);
+	hull = min(hull, derivedStats.maxHull);
 
 	isDisabled = isOverheated || hull < MinimumHull() || (!crew && RequiredCrew());
 
@@ -4152,35 +4179,34 @@ void Ship::DoGeneration()
 		if(currentSystem)
 		{
 			double scale = .2 + 1.8 / (.001 * position.Length() + 1);
-			fuel += currentSystem->RamscoopFuel(attributes.Get("ramscoop"), scale);
+			fuel += currentSystem->RamscoopFuel(derivedStats.ramscoop, scale);
 
 			double solarScaling = currentSystem->SolarPower() * scale;
-			energy += solarScaling * attributes.Get("solar collection");
-			heat += solarScaling * attributes.Get("solar heat");
+			energy += solarScaling * derivedStats.solarCollection;
+			heat += solarScaling * derivedStats.solarHeat;
 		}
 
-		double coolingEfficiency = CoolingEfficiency();
-		energy += attributes.Get("energy generation") - attributes.Get("energy consumption");
-		fuel += attributes.Get("fuel generation");
-		heat += attributes.Get("heat generation");
-		heat -= coolingEfficiency * attributes.Get("cooling");
+		energy += derivedStats.netEnergy;
+		fuel += derivedStats.fuelGeneration;
+		heat += derivedStats.heatGeneration;
+		heat -= derivedStats.cooling;
 
 		// Convert fuel into energy and heat only when the required amount of fuel is available.
-		if(attributes.Get("fuel consumption") <= fuel)
+		if(derivedStats.fuelConsumption <= fuel)
 		{
-			fuel -= attributes.Get("fuel consumption");
-			energy += attributes.Get("fuel energy");
-			heat += attributes.Get("fuel heat");
+			fuel -= derivedStats.fuelConsumption;
+			energy += derivedStats.fuelEnergy;
+			heat += derivedStats.fuelHeat;
 		}
 
 		// Apply active cooling. The fraction of full cooling to apply equals
 		// your ship's current fraction of its maximum temperature.
-		double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+		double activeCooling = derivedStats.activeCooling;
 		if(activeCooling > 0. && heat > 0. && energy >= 0.)
 		{
 			// Handle the case where "active cooling"
 			// does not require any energy.
-			double coolingEnergy = attributes.Get("cooling energy");
+			double coolingEnergy = derivedStats.coolingEnergy;
 			if(coolingEnergy)
 			{
 				double spentEnergy = min(energy, coolingEnergy * min(1., Heat()));
@@ -4208,21 +4234,21 @@ void Ship::DoPassiveEffects(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &
 
 	// Handle ionization effects, etc.
 	if(ionization)
-		CreateSparks(visuals, "ion spark", ionization * .05);
+		CreateSparks(visuals, ION_SPARK.Get(), ionization * .05);
 	if(scrambling)
-		CreateSparks(visuals, "scramble spark", scrambling * .05);
+		CreateSparks(visuals, SCRAMBLE_SPARK.Get(), scrambling * .05);
 	if(disruption)
-		CreateSparks(visuals, "disruption spark", disruption * .1);
+		CreateSparks(visuals, DISRUPTION_SPARK.Get(), disruption * .1);
 	if(slowness)
-		CreateSparks(visuals, "slowing spark", slowness * .1);
+		CreateSparks(visuals, SLOWING_SPARK.Get(), slowness * .1);
 	if(discharge)
-		CreateSparks(visuals, "discharge spark", discharge * .1);
+		CreateSparks(visuals, DISCHARGE_SPARK.Get(), discharge * .1);
 	if(corrosion)
-		CreateSparks(visuals, "corrosion spark", corrosion * .1);
+		CreateSparks(visuals, CORROSION_SPARK.Get(), corrosion * .1);
 	if(leakage)
-		CreateSparks(visuals, "leakage spark", leakage * .1);
+		CreateSparks(visuals, LEAKAGE_SPARK.Get(), leakage * .1);
 	if(burning)
-		CreateSparks(visuals, "burning spark", burning * .1);
+		CreateSparks(visuals, BURNING_SPARK.Get(), burning * .1);
 }
 
 
@@ -4320,7 +4346,7 @@ bool Ship::DoHyperspaceLogic(vector<Visual> &visuals)
 		double sparkAmount = hyperspaceCount * Width() * Height() * .000006;
 		const map<const Effect *, int> &jumpEffects = attributes.JumpEffects();
 		if(jumpEffects.empty())
-			CreateSparks(visuals, "jump drive", sparkAmount);
+			CreateSparks(visuals, JUMP_DRIVE_SPARK.Get(), sparkAmount);
 		else
 		{
 			// Spread the amount of particle effects created among all jump effects.
@@ -4574,23 +4600,24 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 		if(commands.Turn())
 		{
 			// Check if we are able to turn.
-			double cost = attributes.Get("turning energy");
+			const ShipDerivedStats::Action &turning = derivedStats.turning;
+			double cost = turning.energy;
 			if(cost > 0. && energy < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(energy / cost, commands.Turn()));
 
-			cost = attributes.Get("turning shields");
+			cost = turning.shields;
 			if(cost > 0. && shields < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(shields / cost, commands.Turn()));
 
-			cost = attributes.Get("turning hull");
+			cost = turning.hull;
 			if(cost > 0. && hull < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(hull / cost, commands.Turn()));
 
-			cost = attributes.Get("turning fuel");
+			cost = turning.fuel;
 			if(cost > 0. && fuel < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(fuel / cost, commands.Turn()));
 
-			cost = -attributes.Get("turning heat");
+			cost = -turning.heat;
 			if(cost > 0. && heat < cost * fabs(commands.Turn()))
 				commands.SetTurn(copysign(heat / cost, commands.Turn()));
 
@@ -4603,19 +4630,19 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// of the turning energy and produce a fraction of the heat.
 				double scale = fabs(commands.Turn());
 
-				shields -= scale * attributes.Get("turning shields");
-				hull -= scale * attributes.Get("turning hull");
-				energy -= scale * attributes.Get("turning energy");
-				fuel -= scale * attributes.Get("turning fuel");
-				heat += scale * attributes.Get("turning heat");
-				discharge += scale * attributes.Get("turning discharge");
-				corrosion += scale * attributes.Get("turning corrosion");
-				ionization += scale * attributes.Get("turning ion");
-				scrambling += scale * attributes.Get("turning scramble");
-				leakage += scale * attributes.Get("turning leakage");
-				burning += scale * attributes.Get("turning burn");
-				slowness += scale * attributes.Get("turning slowing");
-				disruption += scale * attributes.Get("turning disruption");
+				shields -= scale * turning.shields;
+				hull -= scale * turning.hull;
+				energy -= scale * turning.energy;
+				fuel -= scale * turning.fuel;
+				heat += scale * turning.heat;
+				discharge += scale * turning.discharge;
+				corrosion += scale * turning.corrosion;
+				ionization += scale * turning.ionization;
+				scrambling += scale * turning.scrambling;
+				leakage += scale * turning.leakage;
+				burning += scale * turning.burning;
+				slowness += scale * turning.slowness;
+				disruption += scale * turning.disruption;
 
 				Turn(commands.Turn() * TurnRate() * slowMultiplier);
 			}
@@ -4624,29 +4651,29 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 		double thrust = 0.;
 		if(thrustCommand)
 		{
-			// Check if we are able to apply this thrust.
-			double cost = attributes.Get((thrustCommand > 0.) ?
-				"thrusting energy" : "reverse thrusting energy");
+			// Check if we are able to apply this thrust. The thrust may drop to
+			// zero along the way, and from then on the reverse thrust costs apply.
+			auto costs = [this, &thrustCommand]() -> const ShipDerivedStats::Action &
+			{
+				return (thrustCommand > 0.) ? derivedStats.thrusting : derivedStats.reverseThrusting;
+			};
+			double cost = costs().energy;
 			if(cost > 0. && energy < cost * fabs(thrustCommand))
 				thrustCommand = copysign(energy / cost, thrustCommand);
 
-			cost = attributes.Get((thrustCommand > 0.) ?
-				"thrusting shields" : "reverse thrusting shields");
+			cost = costs().shields;
 			if(cost > 0. && shields < cost * fabs(thrustCommand))
 				thrustCommand = copysign(shields / cost, thrustCommand);
 
-			cost = attributes.Get((thrustCommand > 0.) ?
-				"thrusting hull" : "reverse thrusting hull");
+			cost = costs().hull;
 			if(cost > 0. && hull < cost * fabs(thrustCommand))
 				thrustCommand = copysign(hull / cost, thrustCommand);
 
-			cost = attributes.Get((thrustCommand > 0.) ?
-				"thrusting fuel" : "reverse thrusting fuel");
+			cost = costs().fuel;
 			if(cost > 0. && fuel < cost * fabs(thrustCommand))
 				thrustCommand = copysign(fuel / cost, thrustCommand);
 
-			cost = -attributes.Get((thrustCommand > 0.) ?
-				"thrusting heat" : "reverse thrusting heat");
+			cost = -costs().heat;
 			if(cost > 0. && heat < cost * fabs(thrustCommand))
 				thrustCommand = copysign(heat / cost, thrustCommand);
 
@@ -4655,26 +4682,26 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// If a reverse thrust is commanded and the capability does not
 				// exist, ignore it (do not even slow under drag).
 				isThrusting = (thrustCommand > 0.);
-				isReversing = !isThrusting && attributes.Get("reverse thrust");
-				thrust = attributes.Get(isThrusting ? "thrust" : "reverse thrust");
+				isReversing = !isThrusting && derivedStats.reverseThrust;
+				thrust = isThrusting ? derivedStats.thrust : derivedStats.reverseThrust;
 				if(thrust)
 				{
 					double scale = fabs(thrustCommand);
-
-					shields -= scale * attributes.Get(isThrusting ? "thrusting shields" : "reverse thrusting shields");
-					hull -= scale * attributes.Get(isThrusting ? "thrusting hull" : "reverse thrusting hull");
-					energy -= scale * attributes.Get(isThrusting ? "thrusting energy" : "reverse thrusting energy");
-					fuel -= scale * attributes.Get(isThrusting ? "thrusting fuel" : "reverse thrusting fuel");
-					heat += scale * attributes.Get(isThrusting ? "thrusting heat" : "reverse thrusting heat");
-					discharge += scale * attributes.Get(isThrusting ? "thrusting discharge" : "reverse thrusting discharge");
-					corrosion += scale * attributes.Get(isThrusting ? "thrusting corrosion" : "reverse thrusting corrosion");
-					ionization += scale * attributes.Get(isThrusting ? "thrusting ion" : "reverse thrusting ion");
-					scrambling += scale * attributes.Get(isThrusting ? "thrusting scramble" :
-						"reverse thrusting scramble");
-					burning += scale * attributes.Get(isThrusting ? "thrusting burn" : "reverse thrusting burn");
-					leakage += scale * attributes.Get(isThrusting ? "thrusting leakage" : "reverse thrusting leakage");
-					slowness += scale * attributes.Get(isThrusting ? "thrusting slowing" : "reverse thrusting slowing");
-					disruption += scale * attributes.Get(isThrusting ? "thrusting disruption" : "reverse thrusting disruption");
+					const ShipDerivedStats::Action &thrusting = costs();
+
+					shields -= scale * thrusting.shields;
+					hull -= scale * thrusting.hull;
+					energy -= scale * thrusting.energy;
+					fuel -= scale * thrusting.fuel;
+					heat += scale * thrusting.heat;
+					discharge += scale * thrusting.discharge;
+					corrosion += scale * thrusting.corrosion;
+					ionization += scale * thrusting.ionization;
+					scrambling += scale * thrusting.scrambling;
+					burning += scale * thrusting.burning;
+					leakage += scale * thrusting.leakage;
+					slowness += scale * thrusting.slowness;
+					disruption += scale * thrusting.disruption;
 
 					acceleration += angle.Unit() * thrustCommand * (isThrusting ? Acceleration() : ReverseAcceleration());
 				}
@@ -4684,22 +4711,23 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				&& !CannotAct(Ship::ActionType::AFTERBURNER);
 		if(applyAfterburner)
 		{
-			thrust = attributes.Get("afterburner thrust");
-			double shieldCost = attributes.Get("afterburner shields");
-			double hullCost = attributes.Get("afterburner hull");
-			double energyCost = attributes.Get("afterburner energy");
-			double fuelCost = attributes.Get("afterburner fuel");
-			double heatCost = -attributes.Get("afterburner heat");
-
-			double dischargeCost = attributes.Get("afterburner discharge");
-			double corrosionCost = attributes.Get("afterburner corrosion");
-			double ionCost = attributes.Get("afterburner ion");
-			double scramblingCost = attributes.Get("afterburner scramble");
-			double leakageCost = attributes.Get("afterburner leakage");
-			double burningCost = attributes.Get("afterburner burn");
-
-			double slownessCost = attributes.Get("afterburner slowing");
-			double disruptionCost = attributes.Get("afterburner disruption");
+			const ShipDerivedStats::Action &afterburner = derivedStats.afterburner;
+			thrust = derivedStats.afterburnerThrust;
+			double shieldCost = afterburner.shields;
+			double hullCost = afterburner.hull;
+			double energyCost = afterburner.energy;
+			double fuelCost = afterburner.fuel;
+			double heatCost = -afterburner.heat;
+
+			double dischargeCost = afterburner.discharge;
+			double corrosionCost = afterburner.corrosion;
+			double ionCost = afterburner.ionization;
+			double scramblingCost = afterburner.scrambling;
+			double leakageCost = afterburner.leakage;
+			double burningCost = afterburner.burning;
+
+			double slownessCost = afterburner.slowness;
+			double disruptionCost = afterburner.disruption;
 
 			if(thrust && shields >= shieldCost && hull >= hullCost
 				&& energy >= energyCost && fuel >= fuelCost && heat >= heatCost)
@@ -4720,7 +4748,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				slowness += slownessCost;
 				disruption += disruptionCost;
 
-				acceleration += angle.Unit() * (1. + attributes.Get("acceleration multiplier")) * thrust / mass;
+				acceleration += angle.Unit() * (1. + derivedStats.accelerationMultiplier) * thrust / mass;
 
 				// Only create the afterburner effects if the ship is in the player's system.
 				isUsingAfterburner = !forget;
@@ -4731,7 +4759,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 	{
 		acceleration *= slowMultiplier;
 		// Acceleration multiplier needs to modify effective drag, otherwise it changes top speeds.
-		Point dragAcceleration = acceleration - velocity * dragForce * (1. + attributes.Get("acceleration multiplier"));
+		Point dragAcceleration = acceleration - velocity * dragForce * (1. + derivedStats.accelerationMultiplier);
 		// Make sure dragAcceleration has nonzero length, to avoid divide by zero.
 		if(dragAcceleration)
 		{
@@ -4888,20 +4916,7 @@ void Ship::RemoveEscort(const Ship &ship)
 
 double Ship::MinimumHull() const
 {
-	if(neverDisabled)
-		return 0.;
-
-	double maximumHull = MaxHull();
-	double absoluteThreshold = attributes.Get("absolute threshold");
-	if(absoluteThreshold > 0.)
-		return absoluteThreshold;
-
-	double thresholdPercent = attributes.Get("threshold percentage");
-	double transition = 1 / (1 + 0.0005 * maximumHull);
-	double minimumHull = maximumHull * (thresholdPercent > 0.
-		? min(thresholdPercent, 1.) : 0.1 * (1. - transition) + 0.5 * transition);
-
-	return max(0., floor(minimumHull + attributes.Get("hull threshold")));
+	return neverDisabled ? 0. : derivedStats.minimumHull;
 }
 
 
@@ -4943,13 +4958,6 @@ void Ship::CreateExplosion(vector<Visual> &visuals, bool spread)
 
 
 // Place a "spark" effect, like ionization or disruption.
-void Ship::CreateSparks(vector<Visual> &visuals, const string &name, double amount)
-{
-	CreateSparks(visuals, GameData::Effects().Get(name), amount);
-}
-
-
-
 void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double amount)
 {
 	if(forget)
@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Armament.h"
 #include "CargoHold.h"
 #include "Command.h"
+#include "EpochCounter.h"
 #include "EsUuid.h"
 #include "FireCommand.h"
 #include "Outfit.h"
@@ -29,6 +30,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Point.h"
 #include "Port.h"
 #include "ship/ShipAICache.h"
+#include "ship/ShipDerivedStats.h"
 #include "ShipJumpNavigation.h"
 
 #include <list>
@@ -212,8 +214,12 @@ public:
 	const Command &Commands() const;
 	const FireCommand &FiringCommands() const noexcept;
 	// Move this ship. A ship may create effects as it moves, in particular if
-	// it is in the process of blowing up.
-	void Move(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
+	// it is in the process of blowing up. Moving is done in two parts: the
+	// first only involves this ship and any ships it is carrying, so different
+	// ships may do it at the same time. The second involves other ships, such
+	// as targets and parents, so ships must do it one at a time.
+	void MoveSelf(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
+	void FinishMove(std::vector<Visual> &visuals);
 
 	// Launch any ships that are ready to launch.
 	void Launch(std::list<std::shared_ptr<Ship>> &ships, std::vector<Visual> &visuals);
@@ -438,8 +444,14 @@ public:
 	const Outfit &Attributes() const;
 	// Get the attributes of this ship chassis before any outfits were added.
 	const Outfit &BaseAttributes() const;
+	// Get the values derived from this ship's attributes for its per-frame update.
+	const ShipDerivedStats &DerivedStats() const;
 	// Get the list of all outfits installed in this ship.
 	const std::map<const Outfit *, int> &Outfits() const;
+	// Get a number that changes whenever this ship's model or outfits change.
+	uint64_t OutfitEpoch() const;
+	// Bump the given epoch too whenever this ship's outfits or cargo change.
+	void SetPartOf(const std::shared_ptr<EpochCounter> &fleetEpoch);
 	// Find out how many outfits of the given type this ship contains.
 	int OutfitCount(const Outfit *outfit) const;
 	// Add or remove outfits. (To remove, pass a negative number.)
@@ -500,7 +512,21 @@ public:
 	const Angle& GetJumpDriveTargetAngle() const { return jumpDriveTargetAngle; }
 
 private:
-	// Various steps of Ship::Move:
+	// What is left to be done by FinishMove() after MoveSelf().
+	enum class PendingMove {
+		// Nothing; the ship was removed or is done moving.
+		NONE,
+		// The ship is entering or leaving hyperspace, or landing or departing.
+		TRAVEL,
+		// The ship is flying normally.
+		FLY,
+		// The ship is blowing up, so it just drifts.
+		DRIFT
+	};
+
+
+private:
+	// Various steps of moving a ship:
 
 	// Check if this ship has been in a different system from the player for so
 	// long that it should be "forgotten." Also eliminate ships that have no
@@ -534,7 +560,6 @@ private:
 	// either stay over the ship, or spread out if this is the final explosion.
 	void CreateExplosion(std::vector<Visual> &visuals, bool spread = false);
 	// Place a "spark" effect, like ionization or disruption.
-	void CreateSparks(std::vector<Visual> &visuals, const std::string &name, double amount);
 	void CreateSparks(std::vector<Visual> &visuals, const Effect *effect, double amount);
 
 	// Calculate the attraction and deterrence of this ship, for pirate raids.
@@ -614,9 +639,12 @@ private:
 	// Installed outfits, cargo, etc.:
 	Outfit attributes;
 	Outfit baseAttributes;
+	// Values derived from the attributes, recalculated whenever they change.
+	ShipDerivedStats derivedStats;
 	bool addAttributes = false;
 	const Outfit *explosionWeapon = nullptr;
 	std::map<const Outfit *, int> outfits;
+	EpochCounter outfitEpoch;
 	CargoHold cargo;
 	std::list<std::shared_ptr<Flotsam>> jettisoned;
 
@@ -658,6 +686,8 @@ private:
 	int disabledRecoveryCounter = 0;
 	// Number of frames the damage overlay should be displayed, if any.
 	int damageOverlayTimer = 0;
+	PendingMove pendingMove = PendingMove::NONE;
+	bool isUsingAfterburner = false;
 	// Acceleration can be created by engines, firing weapons, or weapon impacts.
 	Point acceleration;
 
@@ -0,0 +1,132 @@
+/* SpatialIndex.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// Never use more cells than this many per item, so a few far-flung items
+	// cannot make the grid huge.
+	const double MAX_CELLS_PER_ITEM = 4.;
+}
+
+
+
+// Index the given boxes, in cells of (at least) the given size.
+void SpatialIndex::Build(const vector<Rectangle> &boxes, double cellSize)
+{
+	Clear();
+	if(boxes.empty())
+		return;
+
+	this->boxes = boxes;
+	double left = boxes.front().Left();
+	double top = boxes.front().Top();
+	double right = boxes.front().Right();
+	double bottom = boxes.front().Bottom();
+	for(const Rectangle &box : boxes)
+	{
+		left = min(left, box.Left());
+		top = min(top, box.Top());
+		right = max(right, box.Right());
+		bottom = max(bottom, box.Bottom());
+	}
+	const double area = (right - left) * (bottom - top);
+	const double maxCells = MAX_CELLS_PER_ITEM * boxes.size() + 1.;
+	this->cellSize = max(cellSize, sqrt(area / maxCells));
+	origin = Point(left, top);
+	columns = static_cast<int>((right - left) / this->cellSize) + 1;
+	rows = static_cast<int>((bottom - top) / this->cellSize) + 1;
+
+	// Count how many items are in each cell, then fill in the cells. Items are
+	// added in order, so each cell lists its items in increasing order.
+	cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+	for(const Rectangle &box : boxes)
+	{
+		int cellLeft, cellTop, cellRight, cellBottom;
+		CellRange(box, cellLeft, cellTop, cellRight, cellBottom);
+		for(int y = cellTop; y <= cellBottom; ++y)
+			for(int x = cellLeft; x <= cellRight; ++x)
+				++cellStart[x + y * columns + 1];
+	}
+	for(size_t i = 1; i < cellStart.size(); ++i)
+		cellStart[i] += cellStart[i - 1];
+
+	items.resize(cellStart.back());
+	vector<size_t> next(cellStart.begin(), cellStart.end() - 1);
+	for(size_t i = 0; i < boxes.size(); ++i)
+	{
+		int cellLeft, cellTop, cellRight, cellBottom;
+		CellRange(boxes[i], cellLeft, cellTop, cellRight, cellBottom);
+		for(int y = cellTop; y <= cellBottom; ++y)
+			for(int x = cellLeft; x <= cellRight; ++x)
+				items[next[x + y * columns]++] = i;
+	}
+}
+
+
+
+void SpatialIndex::Clear()
+{
+	columns = 0;
+	rows = 0;
+	cellStart.clear();
+	items.clear();
+	boxes.clear();
+}
+
+
+
+// Get every item whose box overlaps the given area, in increasing order.
+void SpatialIndex::Query(const Rectangle &area, vector<size_t> &result) const
+{
+	result.clear();
+	if(items.empty())
+		return;
+
+	int left, top, right, bottom;
+	CellRange(area, left, top, right, bottom);
+	for(int y = top; y <= bottom; ++y)
+		for(int x = left; x <= right; ++x)
+		{
+			const size_t cell = x + y * columns;
+			for(size_t i = cellStart[cell]; i < cellStart[cell + 1]; ++i)
+				if(boxes[items[i]].Overlaps(area))
+					result.push_back(items[i]);
+		}
+
+	// An item that spans several cells is found once in each of them.
+	sort(result.begin(), result.end());
+	result.erase(unique(result.begin(), result.end()), result.end());
+}
+
+
+
+// Get the range of cells that the given box overlaps, clamped to the grid.
+void SpatialIndex::CellRange(const Rectangle &box, int &left, int &top, int &right, int &bottom) const
+{
+	auto toCell = [](double value, int size) -> int
+	{
+		return max(0., min(size - 1., floor(value)));
+	};
+	left = toCell((box.Left() - origin.X()) / cellSize, columns);
+	right = toCell((box.Right() - origin.X()) / cellSize, columns);
+	top = toCell((box.Top() - origin.Y()) / cellSize, rows);
+	bottom = toCell((box.Bottom() - origin.Y()) / cellSize, rows);
+}
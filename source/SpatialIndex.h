@@ -0,0 +1,60 @@
+/* SpatialIndex.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPATIAL_INDEX_H_
+#define SPATIAL_INDEX_H_
+
+#include "Point.h"
+#include "Rectangle.h"
+
+#include <cstddef>
+#include <vector>
+
+
+
+// A uniform grid over a set of items with fixed bounding boxes, such as the
+// systems and links drawn on the map, for finding the ones in a given area
+// without checking every item. Each item is identified by its position in the
+// list of boxes the index was built from.
+class SpatialIndex {
+public:
+	// Index the given boxes, in cells of (at least) the given size.
+	void Build(const std::vector<Rectangle> &boxes, double cellSize);
+	void Clear();
+
+	// Get every item whose box overlaps the given area, in increasing order.
+	void Query(const Rectangle &area, std::vector<size_t> &result) const;
+
+
+private:
+	// Get the range of cells that the given box overlaps, clamped to the grid.
+	void CellRange(const Rectangle &box, int &left, int &top, int &right, int &bottom) const;
+
+
+private:
+	Point origin;
+	double cellSize = 1.;
+	int columns = 0;
+	int rows = 0;
+	// The items in cell i are entries cellStart[i] through cellStart[i + 1] - 1
+	// of items. An item is listed in every cell its box overlaps.
+	std::vector<size_t> cellStart;
+	std::vector<size_t> items;
+	std::vector<Rectangle> boxes;
+};
+
+
+
+#endif
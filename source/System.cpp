@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Angle.h"
 #include "DataNode.h"
 #include "Date.h"
+#include "Economy.h"
 #include "Fleet.h"
 #include "GameData.h"
 #include "Gamerules.h"
@@ -25,7 +26,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Hazard.h"
 #include "Minable.h"
 #include "Planet.h"
-#include "Random.h"
 #include "SpriteSet.h"
 
 #include <algorithm>
@@ -33,17 +33,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
-namespace {
-	// Dynamic economy parameters: how much of its production each system keeps
-	// and exports each day:
-	const double KEEP = .89;
-	const double EXPORT = .10;
-	// Standard deviation of the daily production of each commodity:
-	const double VOLUME = 2000.;
-	// Above this supply amount, price differences taper off:
-	const double LIMIT = 20000.;
-}
-
 const double System::DEFAULT_NEIGHBOR_DISTANCE = 100.;
 
 
@@ -376,7 +365,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 		else if(key == "starfield density")
 			starfieldDensity = child.Value(valueIndex);
 		else if(key == "trade" && child.Size() >= 3)
-			trade[value].SetBase(child.Value(valueIndex + 1));
+			trade[value] = child.Value(valueIndex + 1);
 		else if(key == "arrival")
 		{
 			if(child.Size() >= 2)
@@ -890,7 +879,7 @@ const Sprite *System::Haze() const
 int System::Trade(const string &commodity) const
 {
 	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.price;
+	return (it == trade.end()) ? 0 : it->second + Economy::PriceChange(Supply(commodity));
 }
 
 
@@ -902,44 +891,24 @@ bool System::HasTrade() const
 
 
 
-// Update the economy.
-void System::StepEconomy()
-{
-	for(auto &it : trade)
-	{
-		it.second.exports = EXPORT * it.second.supply;
-		it.second.supply *= KEEP;
-		it.second.supply += Random::Normal() * VOLUME;
-		it.second.Update();
-	}
-}
-
-
-
-void System::SetSupply(const string &commodity, double tons)
+bool System::HasTrade(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	if(it == trade.end())
-		return;
-
-	it->second.supply = tons;
-	it->second.Update();
+	return trade.count(commodity);
 }
 
 
 
+// Get this system's state in the dynamic economy.
 double System::Supply(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.supply;
+	return GameData::GetEconomy().Supply(this, commodity);
 }
 
 
 
 double System::Exports(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.exports;
+	return GameData::GetEconomy().Exports(this, commodity);
 }
 
 
@@ -1075,18 +1044,3 @@ void System::UpdateNeighbors(const Set<System> &systems, double distance)
 			neighborSet.insert(&other);
 	}
 }
-
-
-
-void System::Price::SetBase(int base)
-{
-	this->base = base;
-	this->price = base;
-}
-
-
-
-void System::Price::Update()
-{
-	price = base + static_cast<int>(-100. * erf(supply / LIMIT));
-}
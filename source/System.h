@@ -159,9 +159,8 @@ public:
 	// Get the price of the given commodity in this system.
 	int Trade(const std::string &commodity) const;
 	bool HasTrade() const;
-	// Update the economy. Returns the amount of trade goods this system exports.
-	void StepEconomy();
-	void SetSupply(const std::string &commodity, double tons);
+	bool HasTrade(const std::string &commodity) const;
+	// Get this system's state in the dynamic economy.
 	double Supply(const std::string &commodity) const;
 	double Exports(const std::string &commodity) const;
 
@@ -188,19 +187,6 @@ private:
 	void UpdateNeighbors(const Set<System> &systems, double distance);
 
 
-private:
-	class Price {
-	public:
-		void SetBase(int base);
-		void Update();
-
-		int base = 0;
-		int price = 0;
-		double supply = 0.;
-		double exports = 0.;
-	};
-
-
 private:
 	bool isDefined = false;
 	bool hasPosition = false;
@@ -269,7 +255,8 @@ private:
 	double hyperDepartureDistance = 0.;
 
 	// Commodity prices.
-	std::map<std::string, Price> trade;
+	// The base price of each commodity sold here.
+	std::map<std::string, int> trade;
 
 	// Attributes, for use in location filters.
 	std::set<std::string> attributes;
@@ -0,0 +1,151 @@
+/* Telemetry.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "Telemetry.h"
+
+#include "DataWriter.h"
+#include "Files.h"
+#include "Histogram.h"
+#include "text/Format.h"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <ctime>
+
+using namespace std;
+
+namespace {
+	const size_t PHASES = static_cast<size_t>(Telemetry::Phase::COUNT);
+	const string NAMES[PHASES] = {"calculation", "draw", "swap", "frame"};
+
+	array<Histogram, PHASES> &Histograms()
+	{
+		static array<Histogram, PHASES> histograms;
+		return histograms;
+	}
+
+	// Set when the measurements should start afresh. Only the thread adding to
+	// a histogram may change it, so each one is cleared there.
+	array<atomic<bool>, PHASES> clearRequested = {};
+
+	atomic<uint64_t> droppedFrames = 0;
+
+	// Round a duration to a tenth of a millisecond.
+	double Milliseconds(double seconds)
+	{
+		return round(seconds * 10000.) / 10.;
+	}
+}
+
+
+
+// Add how long a part of a frame took, in seconds.
+void Telemetry::Add(Phase phase, double seconds)
+{
+	const size_t i = static_cast<size_t>(phase);
+	if(clearRequested[i].load(memory_order_relaxed) && clearRequested[i].exchange(false))
+		Histograms()[i].Clear();
+	Histograms()[i].Add(seconds);
+}
+
+
+
+// Add frames that were not drawn in time.
+void Telemetry::AddDroppedFrames(int frames)
+{
+	if(frames > 0)
+		droppedFrames += frames;
+}
+
+
+
+// Begin measuring afresh. Each histogram is cleared the next time something is
+// added to it, so this may be called from any thread.
+void Telemetry::Clear()
+{
+	for(atomic<bool> &request : clearRequested)
+		request = true;
+	droppedFrames = 0;
+}
+
+
+
+const Histogram &Telemetry::Get(Phase phase)
+{
+	return Histograms()[static_cast<size_t>(phase)];
+}
+
+
+
+uint64_t Telemetry::DroppedFrames()
+{
+	return droppedFrames;
+}
+
+
+
+// Get a line describing the 50th, 95th, and 99th percentile of how long the
+// given part of a frame took, for display.
+string Telemetry::Describe(Phase phase)
+{
+	const Histogram &histogram = Get(phase);
+	return NAMES[static_cast<size_t>(phase)] + ": "
+		+ Format::Decimal(1000. * histogram.Percentile(.50), 1) + " / "
+		+ Format::Decimal(1000. * histogram.Percentile(.95), 1) + " / "
+		+ Format::Decimal(1000. * histogram.Percentile(.99), 1) + " ms";
+}
+
+
+
+// Write a summary of this session, including a description of the device
+// it was on.
+void Telemetry::Save(DataWriter &out, const string &device)
+{
+	char date[32];
+	const time_t now = time(nullptr);
+	strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+	out.Write("session", string(date));
+	out.BeginChild();
+	{
+		out.Write("device", device);
+		out.Write("frames", Get(Phase::FRAME).Count());
+		out.Write("dropped frames", DroppedFrames());
+		out.WriteComment("50th, 95th, and 99th percentile and longest time, in milliseconds:");
+		for(size_t i = 0; i < PHASES; ++i)
+		{
+			const Histogram &histogram = Histograms()[i];
+			out.Write(NAMES[i], Milliseconds(histogram.Percentile(.50)), Milliseconds(histogram.Percentile(.95)),
+				Milliseconds(histogram.Percentile(.99)), Milliseconds(histogram.Max()));
+		}
+	}
+	out.EndChild();
+}
+
+
+
+// Add a summary of everything measured since the last summary to the end of
+// the given file, unless nothing was, and then begin measuring afresh.
+void Telemetry::AppendSession(const string &path, const string &device)
+{
+	// If the last summary has not been cleared yet, no frame was measured since.
+	if(clearRequested[static_cast<size_t>(Phase::FRAME)] || !Get(Phase::FRAME).Count())
+		return;
+
+	DataWriter out;
+	Save(out, device);
+	Files::Append(path, out.SaveToString());
+	Clear();
+}
@@ -0,0 +1,71 @@
+/* Telemetry.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <cstdint>
+#include <string>
+
+class DataWriter;
+class Histogram;
+
+
+
+// Measurements of how long each part of every frame takes, kept for the whole
+// session so that the distribution of frame times (and not just the average)
+// can be shown in the CPU / GPU load display, and saved at the end of the
+// session to compare devices and builds. Each measurement is added to a
+// histogram, which is cheap enough that this is always done.
+class Telemetry {
+public:
+	// The parts of a frame that are timed. The engine's calculations are done
+	// in a separate thread, at the same time as the frame is drawn.
+	enum class Phase : int {
+		CALCULATION,
+		DRAW,
+		SWAP,
+		// The whole frame, including the time spent waiting for the next one.
+		FRAME,
+		COUNT
+	};
+
+
+public:
+	// Add how long a part of a frame took, in seconds.
+	static void Add(Phase phase, double seconds);
+	// Add frames that were not drawn in time.
+	static void AddDroppedFrames(int frames);
+	// Begin measuring afresh. This may be called from any thread, but the
+	// measurements are only cleared once each part of a frame is next timed.
+	static void Clear();
+
+	static const Histogram &Get(Phase phase);
+	static uint64_t DroppedFrames();
+	// Get a line describing the 50th, 95th, and 99th percentile of how long the
+	// given part of a frame took, for display.
+	static std::string Describe(Phase phase);
+
+	// Write a summary of this session, including a description of the device
+	// it was on.
+	static void Save(DataWriter &out, const std::string &device);
+	// Add a summary of everything measured since the last summary to the end of
+	// the given file, unless nothing was, and then begin measuring afresh. This
+	// may be called from any thread.
+	static void AppendSession(const std::string &path, const std::string &device);
+};
+
+
+
+#endif
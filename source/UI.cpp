@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "UI.h"
 
+#include "AllocationCounter.h"
 #include "Angle.h"
 #include "Color.h"
 #include "Command.h"
@@ -47,6 +48,7 @@ namespace
 // of them handles it. If none do, this returns false.
 bool UI::Handle(const SDL_Event &event)
 {
+	AllocationCounter::Scope allocationScope("interface: events");
 	bool handled = false;
 	SDL_GameControllerAxis axisTriggered = SDL_CONTROLLER_AXIS_INVALID;
 	SDL_GameControllerAxis axisUnTriggered = SDL_CONTROLLER_AXIS_INVALID;
@@ -282,6 +284,7 @@ bool UI::Handle(const SDL_Event &event)
 // Step all the panels forward (advance animations, move objects, etc.).
 void UI::StepAll()
 {
+	AllocationCounter::Scope allocationScope("interface: step");
 	// Handle any queued push or pop commands.
 	PushOrPop();
 
@@ -295,6 +298,7 @@ void UI::StepAll()
 // Draw all the panels.
 void UI::DrawAll()
 {
+	AllocationCounter::Scope allocationScope("interface: draw");
 	// First, clear all the clickable zones. New ones will be added in the
 	// course of drawing the screen.
 	for(const shared_ptr<Panel> &it : stack)
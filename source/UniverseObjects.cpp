@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "UniverseObjects.h"
 
+#include "AllocationCounter.h"
 #include "DataFile.h"
 #include "DataNode.h"
 #include "Files.h"
@@ -83,6 +84,7 @@ double UniverseObjects::GetProgress() const
 
 void UniverseObjects::FinishLoading()
 {
+	AllocationCounter::Scope allocationScope("loading: finishing");
 	for(auto &&it : planets)
 		it.second.FinishLoading(wormholes);
 
@@ -323,6 +325,7 @@ void UniverseObjects::LoadFile(const string &path, bool debugMode)
 	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
 		return;
 
+	AllocationCounter::Scope allocationScope("loading: objects");
 	DataFile data(path);
 	if(debugMode)
 		Logger::LogError("Parsing: " + path);
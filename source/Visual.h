@@ -45,8 +45,13 @@ public:
 
 
 private:
+	const Effect *effect = nullptr;
 	Angle spin;
 	int lifetime = 0;
+
+	// Once a visual has been created, it is moved into a ParticleSystem,
+	// which stores the same information for many visuals more compactly.
+	friend class ParticleSystem;
 };
 
 
@@ -0,0 +1,306 @@
+/* ZipArchive.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ZipArchive.h"
+
+#include "File.h"
+#include "Logger.h"
+
+#include <SDL2/SDL_rwops.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// Record signatures and sizes, from the PKWARE APPNOTE.
+	const uint32_t END_OF_DIRECTORY = 0x06054b50;
+	const uint32_t DIRECTORY_ENTRY = 0x02014b50;
+	const uint32_t LOCAL_HEADER = 0x04034b50;
+	const size_t END_OF_DIRECTORY_SIZE = 22;
+	const size_t DIRECTORY_ENTRY_SIZE = 46;
+	const size_t LOCAL_HEADER_SIZE = 30;
+	// The end of directory record may be followed by a comment of up to 64 kB.
+	const size_t MAX_COMMENT_SIZE = 65535;
+
+	const uint16_t STORED = 0;
+	const uint16_t DEFLATE = 8;
+	const uint16_t FLAG_ENCRYPTED = 1;
+
+	// All zip fields are little-endian, regardless of the host.
+	uint16_t Read2(const string &data, size_t pos)
+	{
+		return static_cast<uint8_t>(data[pos]) | static_cast<uint8_t>(data[pos + 1]) << 8;
+	}
+
+	uint32_t Read4(const string &data, size_t pos)
+	{
+		return Read2(data, pos) | static_cast<uint32_t>(Read2(data, pos + 2)) << 16;
+	}
+
+	// Read exactly the given number of bytes from the given position.
+	bool ReadAt(SDL_RWops *file, uint64_t pos, size_t size, string &out)
+	{
+		out.resize(size);
+		if(SDL_RWseek(file, pos, RW_SEEK_SET) < 0)
+			return false;
+		return !size || SDL_RWread(file, &out[0], 1, size) == size;
+	}
+
+	// Make sure a (non-root) directory name ends in a '/'.
+	void AddSlash(string &directory)
+	{
+		if(!directory.empty() && directory.back() != '/')
+			directory += '/';
+	}
+}
+
+
+
+ZipArchive::ZipArchive(const string &path)
+	: path(path)
+{
+	LoadDirectory();
+}
+
+
+
+bool ZipArchive::IsValid() const
+{
+	return isValid;
+}
+
+
+
+const string &ZipArchive::Path() const
+{
+	return path;
+}
+
+
+
+bool ZipArchive::HasFile(const string &name) const
+{
+	return files.count(name);
+}
+
+
+
+bool ZipArchive::HasDirectory(string name) const
+{
+	AddSlash(name);
+	return directories.count(name);
+}
+
+
+
+vector<string> ZipArchive::List(string directory, bool recursive) const
+{
+	AddSlash(directory);
+
+	vector<string> list;
+	for(auto it = files.lower_bound(directory); it != files.end(); ++it)
+	{
+		const string &name = it->first;
+		if(name.compare(0, directory.size(), directory))
+			break;
+		if(recursive || name.find('/', directory.size()) == string::npos)
+			list.push_back(name);
+	}
+	return list;
+}
+
+
+
+vector<string> ZipArchive::ListDirectories(string directory) const
+{
+	AddSlash(directory);
+
+	vector<string> list;
+	for(auto it = directories.upper_bound(directory); it != directories.end(); ++it)
+	{
+		const string &name = *it;
+		if(name.compare(0, directory.size(), directory))
+			break;
+		if(name.find('/', directory.size()) == name.size() - 1)
+			list.push_back(name);
+	}
+	return list;
+}
+
+
+
+string ZipArchive::Read(const string &name) const
+{
+	auto it = files.find(name);
+	if(it == files.end())
+		return string();
+	const Entry &entry = it->second;
+
+	File file(path);
+	string header;
+	string data;
+	if(!file || !ReadAt(file, entry.offset, LOCAL_HEADER_SIZE, header) || Read4(header, 0) != LOCAL_HEADER)
+	{
+		Logger::LogError("Error: \"" + path + "\" is corrupt; unable to read \"" + name + "\".");
+		return string();
+	}
+	// The local header repeats the name, but its extra field may differ from
+	// the one in the central directory.
+	uint64_t start = entry.offset + LOCAL_HEADER_SIZE + Read2(header, 26) + Read2(header, 28);
+	if(!ReadAt(file, start, entry.compressedSize, data))
+	{
+		Logger::LogError("Error: \"" + path + "\" is truncated; unable to read \"" + name + "\".");
+		return string();
+	}
+
+	if(entry.method == DEFLATE)
+	{
+		string compressed = std::move(data);
+		// Older versions of zlib need one byte past the end of a raw stream.
+		compressed += '\0';
+		data.resize(entry.size);
+
+		z_stream stream{};
+		// A negative window size means this is a raw deflate stream, with no zlib header.
+		if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+		{
+			Logger::LogError("Error: unable to initialize zlib.");
+			return string();
+		}
+		stream.next_in = reinterpret_cast<Bytef *>(&compressed[0]);
+		stream.avail_in = compressed.size();
+		stream.next_out = reinterpret_cast<Bytef *>(&data[0]);
+		stream.avail_out = data.size();
+		int status = inflate(&stream, Z_FINISH);
+		inflateEnd(&stream);
+		if(status != Z_STREAM_END || stream.avail_out)
+		{
+			Logger::LogError("Error: unable to decompress \"" + name + "\" in \"" + path + "\".");
+			return string();
+		}
+	}
+	else if(entry.size != entry.compressedSize)
+	{
+		Logger::LogError("Error: \"" + name + "\" in \"" + path + "\" has an invalid size.");
+		return string();
+	}
+
+	if(crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef *>(data.data()), data.size()) != entry.crc)
+	{
+		Logger::LogError("Error: checksum mismatch for \"" + name + "\" in \"" + path + "\".");
+		return string();
+	}
+	return data;
+}
+
+
+
+void ZipArchive::LoadDirectory()
+{
+	File file(path);
+	if(!file)
+		return;
+
+	// The end of directory record is at the very end of the file, unless the
+	// archive has a comment, so search backwards for its signature.
+	Sint64 fileSize = SDL_RWsize(file);
+	if(fileSize < static_cast<Sint64>(END_OF_DIRECTORY_SIZE))
+	{
+		Logger::LogError("Error: \"" + path + "\" is too small to be a zip file.");
+		return;
+	}
+	size_t tailSize = min<uint64_t>(fileSize, END_OF_DIRECTORY_SIZE + MAX_COMMENT_SIZE);
+	string tail;
+	if(!ReadAt(file, fileSize - tailSize, tailSize, tail))
+		return;
+
+	size_t end = string::npos;
+	for(size_t i = tailSize - END_OF_DIRECTORY_SIZE + 1; i-- > 0; )
+		if(Read4(tail, i) == END_OF_DIRECTORY)
+		{
+			end = i;
+			break;
+		}
+	if(end == string::npos)
+	{
+		Logger::LogError("Error: \"" + path + "\" is not a zip file.");
+		return;
+	}
+
+	uint16_t count = Read2(tail, end + 10);
+	uint32_t directorySize = Read4(tail, end + 12);
+	uint32_t directoryOffset = Read4(tail, end + 16);
+	uint64_t endOffset = fileSize - tailSize + end;
+	// Zip64 archives, for files over 4 GB, mark these fields as all ones.
+	if(directoryOffset == 0xFFFFFFFF || static_cast<uint64_t>(directoryOffset) + directorySize > endOffset)
+	{
+		Logger::LogError("Error: \"" + path + "\" has an unsupported or corrupt central directory.");
+		return;
+	}
+
+	string directory;
+	if(!ReadAt(file, directoryOffset, directorySize, directory))
+		return;
+
+	directories.insert(string());
+	size_t pos = 0;
+	for(uint16_t i = 0; i < count; ++i)
+	{
+		if(pos + DIRECTORY_ENTRY_SIZE > directory.size() || Read4(directory, pos) != DIRECTORY_ENTRY)
+		{
+			Logger::LogError("Error: \"" + path + "\" has a corrupt central directory.");
+			files.clear();
+			directories.clear();
+			return;
+		}
+		uint16_t flags = Read2(directory, pos + 8);
+		Entry entry;
+		entry.method = Read2(directory, pos + 10);
+		entry.crc = Read4(directory, pos + 16);
+		entry.compressedSize = Read4(directory, pos + 20);
+		entry.size = Read4(directory, pos + 24);
+		entry.offset = Read4(directory, pos + 42);
+		size_t nameSize = Read2(directory, pos + 28);
+		size_t extraSize = Read2(directory, pos + 30);
+		size_t commentSize = Read2(directory, pos + 32);
+		string name = directory.substr(pos + DIRECTORY_ENTRY_SIZE, nameSize);
+		pos += DIRECTORY_ENTRY_SIZE + nameSize + extraSize + commentSize;
+
+		// Some archivers on Windows still use backslashes as separators.
+		replace(name.begin(), name.end(), '\\', '/');
+		// Never let an entry refer to anything outside of the archive's own tree.
+		if(name.empty() || name.front() == '/' || ('/' + name + '/').find("/../") != string::npos)
+			continue;
+
+		// Record every directory leading up to this entry, since archives are
+		// not required to include entries for directories.
+		for(size_t slash = name.find('/'); slash != string::npos; slash = name.find('/', slash + 1))
+			directories.insert(name.substr(0, slash + 1));
+		if(name.back() == '/')
+			continue;
+
+		if(flags & FLAG_ENCRYPTED)
+			Logger::LogError("Warning: skipping encrypted file \"" + name + "\" in \"" + path + "\".");
+		else if(entry.method != STORED && entry.method != DEFLATE)
+			Logger::LogError("Warning: skipping \"" + name + "\" in \"" + path
+				+ "\", which uses an unsupported compression method.");
+		else
+			files.emplace(std::move(name), entry);
+	}
+	isValid = true;
+}
@@ -0,0 +1,83 @@
+/* ZipArchive.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ZIP_ARCHIVE_H_
+#define ZIP_ARCHIVE_H_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+
+
+// A read-only view of a zip file. The central directory is parsed once, when
+// the archive is opened, into an index of every file and directory it holds,
+// so that listing and lookups never touch the disk again. Files are read by
+// opening a fresh handle to the archive each time, so any number of threads
+// may read from the same archive at once. Only "stored" and "deflate" entries
+// are supported, which covers every zip tool in common use.
+class ZipArchive {
+public:
+	explicit ZipArchive(const std::string &path);
+
+	// Check whether the archive was opened and its directory parsed.
+	bool IsValid() const;
+	const std::string &Path() const;
+
+	// All paths are relative to the root of the archive, use '/' separators,
+	// and directories may be given with or without a trailing '/'. The root
+	// directory is the empty string.
+	bool HasFile(const std::string &name) const;
+	bool HasDirectory(std::string name) const;
+	// Get the files in the given directory (and, if recursive, in all of its
+	// subdirectories), in sorted order.
+	std::vector<std::string> List(std::string directory, bool recursive = false) const;
+	// Get the directories directly inside the given one, each ending in '/'.
+	std::vector<std::string> ListDirectories(std::string directory) const;
+
+	// Read and decompress the given file. Returns an empty string, and logs an
+	// error, if the entry is missing or cannot be decompressed.
+	std::string Read(const std::string &name) const;
+
+
+private:
+	struct Entry {
+		uint64_t offset = 0;
+		uint32_t compressedSize = 0;
+		uint32_t size = 0;
+		uint32_t crc = 0;
+		uint16_t method = 0;
+	};
+
+
+private:
+	void LoadDirectory();
+
+
+private:
+	std::string path;
+	bool isValid = false;
+
+	std::map<std::string, Entry> files;
+	// Every directory in the archive, whether or not it has its own entry,
+	// stored with a trailing '/'.
+	std::set<std::string> directories;
+};
+
+
+
+#endif
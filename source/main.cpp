@@ -15,12 +15,14 @@ You should have received a copy of the GNU General Public License along with
 this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "AllocationCounter.h"
 #include "Audio.h"
 #include "Command.h"
 #include "Conversation.h"
 #include "ConversationPanel.h"
 #include "DataFile.h"
 #include "DataNode.h"
+#include "DataWriter.h"
 #include "Engine.h"
 #include "Files.h"
 #include "CrashState.h"
@@ -30,18 +32,22 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "GameLoadingPanel.h"
 #include "GameWindow.h"
+#include "Histogram.h"
 #include "Logger.h"
 #include "MainPanel.h"
+#include "MaskManager.h"
 #include "MenuPanel.h"
 #include "Panel.h"
 #include "PlayerInfo.h"
 #include "Plugins.h"
 #include "Preferences.h"
 #include "PrintData.h"
+#include "Replay.h"
 #include "Screen.h"
 #include "SpriteSet.h"
 #include "SpriteShader.h"
 #include "TaskQueue.h"
+#include "Telemetry.h"
 #include "Test.h"
 #include "TestContext.h"
 #include "TouchScreen.h"
@@ -51,9 +57,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <SDL.h>
 #include <SDL_events.h>
 #include <SDL_scancode.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
 
 #include <cassert>
 #include <future>
@@ -73,7 +85,10 @@ using namespace std;
 void PrintHelp();
 void PrintVersion();
 void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversation,
-	const string &testToRun, bool debugMode);
+	const string &testToRun, const shared_ptr<Replay> &replay, string recordPath, bool debugMode);
+void BeginReplay(PlayerInfo &player, UI &menuPanels, UI &gamePanels, const shared_ptr<Replay> &replay);
+void PrintReplayTimes(const Replay &replay);
+void SaveAllocations(const string &path);
 Conversation LoadConversation();
 void PrintTestsTable();
 int EventFilter(void* userdata, SDL_Event* event);
@@ -81,6 +96,28 @@ int EventFilter(void* userdata, SDL_Event* event);
 void InitConsole();
 #endif
 
+namespace {
+	// Set when the app comes back from the background, so that the game loop
+	// does not count the time it spent there as part of a frame.
+	atomic<bool> isResumed = false;
+
+	// Whether to keep a record of how smoothly the game ran. Mobile apps are
+	// rarely quit normally, so the record is also written whenever the app is
+	// sent to the background or terminated, which may happen on another thread.
+	bool isTelemetrySaved = false;
+	mutex telemetryMutex;
+
+	void SaveTelemetry()
+	{
+		if(!isTelemetrySaved)
+			return;
+
+		lock_guard<mutex> lock(telemetryMutex);
+		Telemetry::AppendSession(Files::Config() + "performance.txt", string(SDL_GetPlatform()) + " "
+			+ to_string(GameWindow::Width()) + "x" + to_string(GameWindow::Height()));
+	}
+}
+
 
 
 // Entry point for the EndlessSky executable
@@ -98,6 +135,8 @@ int main(int argc, char *argv[])
 	bool printData = false;
 	bool noTestMute = false;
 	string testToRunName;
+	string recordPath;
+	string replayPath;
 
 	// Whether the game has encountered errors while loading.
 	bool hasErrors = false;
@@ -134,16 +173,35 @@ int main(int argc, char *argv[])
 			printTests = true;
 		else if(arg == "--nomute")
 			noTestMute = true;
+		else if(arg == "--record" && *++it)
+			recordPath = *it;
+		else if(arg == "--replay" && *++it)
+			replayPath = *it;
 	}
 	printData = PrintData::IsPrintDataArgument(argv);
 	Files::Init(argv);
 
+	// Load the recording to play back, if any.
+	shared_ptr<Replay> replay;
+	if(!replayPath.empty())
+	{
+		replay = make_shared<Replay>();
+		if(!replay->FromString(Files::Read(replayPath)))
+		{
+			Logger::LogError("\"" + replayPath + "\" is not a recording.");
+			return 1;
+		}
+	}
+
 	// Config now set. It is safe to access the config now
 	CrashState::Init(!testToRunName.empty());
 	CrashState::Set(CrashState::LOADED);
 
 	// Whether we are running an integration test.
 	const bool isTesting = !testToRunName.empty();
+	// Whether the game is running without a player, for a test or a replay.
+	const bool isAutomated = isTesting || replay;
+	isTelemetrySaved = !isAutomated;
 	try {
 		// Load plugin preferences before game data if any.
 		Plugins::LoadSettings();
@@ -154,7 +212,7 @@ int main(int argc, char *argv[])
 		// Begin loading the game data.
 		bool isConsoleOnly = loadOnly || printTests || printData;
 		auto dataFuture = GameData::BeginLoad(queue, isConsoleOnly, debugMode,
-			isConsoleOnly || (isTesting && !debugMode));
+			isConsoleOnly || (isAutomated && !debugMode));
 
 		// If we are not using the UI, or performing some automated task, we should load
 		// all data now.
@@ -223,12 +281,12 @@ int main(int argc, char *argv[])
 		SDL_SetHint(SDL_HINT_ACCELEROMETER_AS_JOYSTICK, "0"); // this shows up as bonus joystick
 		
 
-		if(!GameWindow::Init(isTesting && !debugMode))
+		if(!GameWindow::Init(isAutomated && !debugMode))
 			return 1;
 
 		GameData::LoadSettings();
 
-		if(!isTesting || debugMode)
+		if(!isAutomated || debugMode)
 		{
 			GameData::LoadShaders();
 
@@ -238,11 +296,17 @@ int main(int argc, char *argv[])
 
 		Audio::Init(GameData::Sources());
 
-		if(isTesting && !noTestMute)
+		if(isAutomated && !noTestMute)
 			Audio::SetVolume(0);
 
 		// This is the main loop where all the action begins.
-		GameLoop(player, queue, conversation, testToRunName, debugMode);
+		GameLoop(player, queue, conversation, testToRunName, replay, recordPath, debugMode);
+
+		// Keep a record of how smoothly the game ran in this session.
+		SaveTelemetry();
+		// In debug builds, also record how much each part of the game allocated.
+		if(AllocationCounter::IsEnabled())
+			SaveAllocations(Files::Config() + "allocations.txt");
 	}
 	catch(Test::known_failure_tag)
 	{
@@ -288,9 +352,15 @@ int EventFilter(void* userdata, SDL_Event* event)
 	{
 		Audio::Pause();
 	}
+	else if (event->type == SDL_APP_WILLENTERBACKGROUND || event->type == SDL_APP_TERMINATING)
+	{
+		// The app may be killed at any time once it is in the background.
+		SaveTelemetry();
+	}
 	else if (event->type == SDL_APP_DIDENTERFOREGROUND)
 	{
 		Audio::Resume();
+		isResumed = true;
 	}
 
 	return 1;
@@ -300,7 +370,7 @@ int EventFilter(void* userdata, SDL_Event* event)
 
 
 void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversation,
-		const string &testToRunName, bool debugMode)
+		const string &testToRunName, const shared_ptr<Replay> &replay, string recordPath, bool debugMode)
 {
 	// SDL BUG? Calling SetEventFilter seems to drop the pending
 	// SDL_CONTROLLERDEVICEADDED event. This is why I'm calling
@@ -343,7 +413,7 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 	if(!testToRunName.empty())
 		testContext = TestContext(GameData::Tests().Get(testToRunName));
 
-	const bool isHeadless = (testContext.CurrentTest() && !debugMode);
+	const bool isHeadless = ((testContext.CurrentTest() || replay) && !debugMode);
 
 	auto ProcessEvents = [&menuPanels, &gamePanels, &player, &cursorTime, &toggleTimeout, &debugMode, &isPaused,
 			&isFastForward]
@@ -476,7 +546,7 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 	};
 
 	// Game loop when running the game normally.
-	if(!testContext.CurrentTest())
+	if(!testContext.CurrentTest() && !replay)
 	{
 		while(!menuPanels.IsDone())
 		{
@@ -510,6 +580,17 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 			// Tell all the panels to step forward, then draw them.
 			((!isPaused && menuPanels.IsEmpty()) ? gamePanels : menuPanels).StepAll();
 
+			// Record the player's next flight. Loading or starting a pilot replaces
+			// the main panel, so keep asking whichever engine is current to record
+			// it until one of them has actually begun.
+			if(!recordPath.empty() && !gamePanels.IsEmpty())
+			{
+				Engine &engine = static_cast<MainPanel *>(gamePanels.Root().get())->GetEngine();
+				engine.Record(recordPath);
+				if(engine.IsRecording())
+					recordPath.clear();
+			}
+
 			// Caps lock slows the frame rate in debug mode.
 			// Slowing eases in and out over a couple of frames.
 			if((mod & KMOD_CAPS) && inFlight && debugMode)
@@ -540,30 +621,66 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 
 			// Events in this frame may have cleared out the menu, in which case
 			// we should draw the game panels instead:
+			FrameTimer drawTimer;
 			(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
 			if(isFastForward)
 				SpriteShader::Draw(SpriteSet::Get("ui/fast forward"), Screen::TopLeft() + Point(10., 10.));
+			Telemetry::Add(Telemetry::Phase::DRAW, drawTimer.Time());
 
+			FrameTimer swapTimer;
 			GameWindow::Step();
+			Telemetry::Add(Telemetry::Phase::SWAP, swapTimer.Time());
 
-			// Lock the game loop to 60 FPS.
-			timer.Wait();
+			// Lock the game loop to 60 FPS. If the app was in the background during
+			// this frame, the loop was blocked the whole time, so start timing frames
+			// afresh instead of counting that time as dropped frames.
+			if(isResumed.exchange(false))
+			{
+				timer.Reset();
+				timer.Wait();
+			}
+			else
+			{
+				Telemetry::AddDroppedFrames(timer.Wait());
+				Telemetry::Add(Telemetry::Phase::FRAME,
+					chrono::duration<double>(chrono::steady_clock::now() - start).count());
+			}
 
 			// If the player ended this frame in-game, count the elapsed time as played time.
 			if(menuPanels.IsEmpty())
 				player.AddPlayTime(chrono::steady_clock::now() - start);
 		}
 	}
-	// Game loop when running the game as part of an integration test.
+	// Game loop when running the game as part of an integration test, or to
+	// play back a recording.
 	else
 	{
 		int integrationStepCounter = 0;
+		bool isReplayStarted = false;
 		while(!menuPanels.IsDone())
 		{
 			ProcessEvents();
 
+			// Play back the recording once the game data is loaded. It ends when
+			// all of its steps have been run, or when anything that was not
+			// recorded (such as a dialog or the planet panel) needs the player.
+			if(dataFinishedLoading && replay)
+			{
+				MainPanel *mainPanel = static_cast<MainPanel *>(gamePanels.Root().get());
+				if(!isReplayStarted)
+				{
+					BeginReplay(player, menuPanels, gamePanels, replay);
+					isReplayStarted = true;
+				}
+				else if(mainPanel->GetEngine().IsReplayDone() || !gamePanels.IsTop(mainPanel))
+				{
+					mainPanel->GetEngine().Wait();
+					PrintReplayTimes(*replay);
+					menuPanels.Quit();
+				}
+			}
 			// Handle any integration test steps.
-			if(dataFinishedLoading)
+			else if(dataFinishedLoading)
 			{
 				// Run a single integration step every 30 frames.
 				integrationStepCounter = (integrationStepCounter + 1) % 30;
@@ -600,9 +717,13 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 
 				// Events in this frame may have cleared out the menu, in which case
 				// we should draw the game panels instead:
+				FrameTimer drawTimer;
 				(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+				Telemetry::Add(Telemetry::Phase::DRAW, drawTimer.Time());
 
+				FrameTimer swapTimer;
 				GameWindow::Step();
+				Telemetry::Add(Telemetry::Phase::SWAP, swapTimer.Time());
 
 				// When we perform automated testing, then we run the game by default as quickly as possible.
 				// Except when not in headless mode so that the user can follow along.
@@ -618,6 +739,77 @@ void GameLoop(PlayerInfo &player, TaskQueue &queue, const Conversation &conversa
 
 
 
+// Load the saved game that a recording begins with, and take off from it.
+void BeginReplay(PlayerInfo &player, UI &menuPanels, UI &gamePanels, const shared_ptr<Replay> &replay)
+{
+	// The saved game is only needed until it has been loaded.
+	const string path = Files::Config() + "replay playback.txt";
+	Files::Write(path, replay->SaveData());
+
+	menuPanels.Reset();
+	gamePanels.Reset();
+	gamePanels.CanSave(false);
+	player.Load(path);
+	Files::Delete(path);
+	GameData::GetMaskManager().ScaleMasks();
+
+	MainPanel *mainPanel = new MainPanel(player);
+	gamePanels.Push(mainPanel);
+	mainPanel->GetEngine().Play(replay);
+	mainPanel->OnCallback();
+}
+
+
+
+// Print how long the engine took to calculate the steps of a recording.
+void PrintReplayTimes(const Replay &replay)
+{
+	vector<double> times = replay.StepTimes();
+	cout << "Played back " << times.size() << " of " << replay.Steps() << " steps." << endl;
+	if(times.empty())
+		return;
+
+	sort(times.begin(), times.end());
+	auto milliseconds = [&times](double fraction)
+	{
+		return 1000. * times[min(times.size() - 1, static_cast<size_t>(fraction * times.size()))];
+	};
+	const double total = accumulate(times.begin(), times.end(), 0.);
+	cout << "Total: " << total << " s" << endl;
+	cout << "Mean: " << 1000. * total / times.size() << " ms" << endl;
+	cout << "Median: " << milliseconds(.5) << " ms" << endl;
+	cout << "95th percentile: " << milliseconds(.95) << " ms" << endl;
+	cout << "99th percentile: " << milliseconds(.99) << " ms" << endl;
+	cout << "Max: " << 1000. * times.back() << " ms" << endl;
+
+	// Also give the 50th, 95th, and 99th percentile of each part of a frame
+	// that was timed while playing it back.
+	for(int i = 0; i < static_cast<int>(Telemetry::Phase::COUNT); ++i)
+	{
+		const Telemetry::Phase phase = static_cast<Telemetry::Phase>(i);
+		if(Telemetry::Get(phase).Count())
+			cout << Telemetry::Describe(phase) << endl;
+	}
+}
+
+
+
+// Write out the number of allocations made with each tag in this session, and
+// how many bytes they requested, most allocations first.
+void SaveAllocations(const string &path)
+{
+	vector<AllocationCounter::Tally> tallies = AllocationCounter::Tallies();
+	sort(tallies.begin(), tallies.end(), [](const AllocationCounter::Tally &a, const AllocationCounter::Tally &b)
+		{ return a.count > b.count; });
+
+	DataWriter out(path);
+	out.WriteComment("Allocations and bytes allocated with each tag:");
+	for(const AllocationCounter::Tally &tally : tallies)
+		out.Write(string(tally.tag), tally.count, tally.bytes);
+}
+
+
+
 void PrintHelp()
 {
 	cerr << endl;
@@ -632,6 +824,10 @@ void PrintHelp()
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory." << endl;
 	cerr << "    --nomute: don't mute the game while running tests." << endl;
+	cerr << "    --record <file>: record the inputs of the next flight, from take-off to landing," << endl;
+	cerr << "        and save them when the player lands." << endl;
+	cerr << "    --replay <file>: play back a recorded flight as quickly as possible, then exit." << endl;
+	cerr << "        Use a separate --config directory, since the recorded pilot is loaded." << endl;
 	PrintData::Help();
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
@@ -0,0 +1,320 @@
+/* ShipDerivedStats.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ShipDerivedStats.h"
+
+#include "../Outfit.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <set>
+#include <string>
+
+using namespace std;
+
+namespace {
+	// The names of the attributes that a hull or shield repair is calculated
+	// from. The rate and its multiplier are the names of those attributes, and
+	// the prefix is what the names of the cost attributes start with.
+	class RepairKeys {
+	public:
+		RepairKeys(const string &rate, const string &multiplier, const string &prefix)
+			: rate(rate), delayedRate("delayed " + rate), multiplier(multiplier),
+			energy(prefix + " energy"), delayedEnergy("delayed " + energy), energyMultiplier(energy + " multiplier"),
+			fuel(prefix + " fuel"), delayedFuel("delayed " + fuel), fuelMultiplier(fuel + " multiplier"),
+			heat(prefix + " heat"), delayedHeat("delayed " + heat), heatMultiplier(heat + " multiplier") {}
+
+		const string rate;
+		const string delayedRate;
+		const string multiplier;
+		const string energy;
+		const string delayedEnergy;
+		const string energyMultiplier;
+		const string fuel;
+		const string delayedFuel;
+		const string fuelMultiplier;
+		const string heat;
+		const string delayedHeat;
+		const string heatMultiplier;
+	};
+
+	// The names of a status effect resistance attribute and its costs.
+	class ResistanceKeys {
+	public:
+		explicit ResistanceKeys(const string &name)
+			: resistance(name), energy(name + " energy"), fuel(name + " fuel"), heat(name + " heat") {}
+
+		const string resistance;
+		const string energy;
+		const string fuel;
+		const string heat;
+	};
+
+	// The names of the cost attributes of an action, given their prefix, e.g. "turning".
+	class ActionKeys {
+	public:
+		explicit ActionKeys(const string &prefix)
+			: shields(prefix + " shields"), hull(prefix + " hull"), energy(prefix + " energy"),
+			fuel(prefix + " fuel"), heat(prefix + " heat"), discharge(prefix + " discharge"),
+			corrosion(prefix + " corrosion"), ionization(prefix + " ion"), scrambling(prefix + " scramble"),
+			leakage(prefix + " leakage"), burning(prefix + " burn"), slowness(prefix + " slowing"),
+			disruption(prefix + " disruption") {}
+
+		const string shields;
+		const string hull;
+		const string energy;
+		const string fuel;
+		const string heat;
+		const string discharge;
+		const string corrosion;
+		const string ionization;
+		const string scrambling;
+		const string leakage;
+		const string burning;
+		const string slowness;
+		const string disruption;
+	};
+
+	// The attributes that are only read by name, without building the name.
+	// Every attribute Calibrate() reads must be here or in the keys above.
+	const char *const NAMED_KEYS[] = {
+		"piercing protection", "piercing resistance", "high shield permeability", "low shield permeability",
+		"shield protection", "cloak shield protection", "hull protection", "cloak hull protection",
+		"energy protection", "heat protection", "fuel protection", "discharge protection",
+		"corrosion protection", "ion protection", "burn protection", "leak protection",
+		"slowing protection", "scramble protection", "disruption protection", "force protection",
+		"absolute threshold", "threshold percentage", "hull threshold",
+		"shields", "shield multiplier", "hull", "hull multiplier", "energy capacity", "fuel capacity",
+		"heat dissipation", "overheat damage threshold", "overheat damage rate",
+		"ramscoop", "solar collection", "solar heat", "energy generation", "energy consumption",
+		"fuel generation", "heat generation", "cooling inefficiency", "cooling", "active cooling",
+		"cooling energy", "fuel consumption", "fuel energy", "fuel heat",
+		"thrust", "reverse thrust", "afterburner thrust", "acceleration multiplier"
+	};
+
+	// The names of the attributes that are built from other names, built once
+	// so that calibrating a ship does not need to allocate any strings.
+	class Keys {
+	public:
+		Keys()
+		{
+			all.insert(begin(NAMED_KEYS), end(NAMED_KEYS));
+			for(const RepairKeys *repair : {&hull, &shields})
+				all.insert({repair->rate, repair->delayedRate, repair->multiplier,
+					repair->energy, repair->delayedEnergy, repair->energyMultiplier,
+					repair->fuel, repair->delayedFuel, repair->fuelMultiplier,
+					repair->heat, repair->delayedHeat, repair->heatMultiplier});
+			for(const ResistanceKeys *resistance : {&ion, &scramble, &disruption, &slowing,
+					&discharge, &corrosion, &leak, &burn})
+				all.insert({resistance->resistance, resistance->energy, resistance->fuel, resistance->heat});
+			for(const ActionKeys *action : {&turning, &thrusting, &reverseThrusting, &afterburner})
+				all.insert({action->shields, action->hull, action->energy, action->fuel, action->heat,
+					action->discharge, action->corrosion, action->ionization, action->scrambling,
+					action->leakage, action->burning, action->slowness, action->disruption});
+		}
+
+		const RepairKeys hull{"hull repair rate", "hull repair multiplier", "hull"};
+		const RepairKeys shields{"shield generation", "shield generation multiplier", "shield"};
+
+		const ResistanceKeys ion{"ion resistance"};
+		const ResistanceKeys scramble{"scramble resistance"};
+		const ResistanceKeys disruption{"disruption resistance"};
+		const ResistanceKeys slowing{"slowing resistance"};
+		const ResistanceKeys discharge{"discharge resistance"};
+		const ResistanceKeys corrosion{"corrosion resistance"};
+		const ResistanceKeys leak{"leak resistance"};
+		const ResistanceKeys burn{"burn resistance"};
+
+		const ActionKeys turning{"turning"};
+		const ActionKeys thrusting{"thrusting"};
+		const ActionKeys reverseThrusting{"reverse thrusting"};
+		const ActionKeys afterburner{"afterburner"};
+
+		// Every attribute that any of the derived stats depend on.
+		set<string, less<>> all;
+	};
+
+	const Keys &GetKeys()
+	{
+		static const Keys keys;
+		return keys;
+	}
+
+	// Get the repair rate and costs for the hull or shields.
+	ShipDerivedStats::Repair GetRepair(const Outfit &attributes, const RepairKeys &keys, bool isDelayed)
+	{
+		ShipDerivedStats::Repair repair;
+		repair.rate = (attributes.Get(keys.rate)
+			+ (isDelayed ? 0 : attributes.Get(keys.delayedRate)))
+			* (1. + attributes.Get(keys.multiplier));
+		repair.energy = (attributes.Get(keys.energy)
+			+ (isDelayed ? 0 : attributes.Get(keys.delayedEnergy)))
+			* (1. + attributes.Get(keys.energyMultiplier)) / repair.rate;
+		repair.fuel = (attributes.Get(keys.fuel)
+			+ (isDelayed ? 0 : attributes.Get(keys.delayedFuel)))
+			* (1. + attributes.Get(keys.fuelMultiplier)) / repair.rate;
+		repair.heat = (attributes.Get(keys.heat)
+			+ (isDelayed ? 0 : attributes.Get(keys.delayedHeat)))
+			* (1. + attributes.Get(keys.heatMultiplier)) / repair.rate;
+		return repair;
+	}
+
+	// Get the resistance to a status effect, e.g. "ion resistance", and its costs.
+	ShipDerivedStats::Resistance GetResistance(const Outfit &attributes, const ResistanceKeys &keys)
+	{
+		ShipDerivedStats::Resistance resistance;
+		resistance.resistance = attributes.Get(keys.resistance);
+		resistance.energy = attributes.Get(keys.energy) / resistance.resistance;
+		resistance.fuel = attributes.Get(keys.fuel) / resistance.resistance;
+		resistance.heat = attributes.Get(keys.heat) / resistance.resistance;
+		return resistance;
+	}
+
+	// Get the protection from each type of damage.
+	ShipDerivedStats::Protection GetProtection(const Outfit &attributes)
+	{
+		ShipDerivedStats::Protection protection;
+		protection.piercingProtection = attributes.Get("piercing protection");
+		protection.piercingResistance = attributes.Get("piercing resistance");
+		protection.highShieldPermeability = attributes.Get("high shield permeability");
+		protection.lowShieldPermeability = attributes.Get("low shield permeability");
+		protection.shields = attributes.Get("shield protection");
+		protection.cloakShields = attributes.Get("cloak shield protection");
+		protection.hull = attributes.Get("hull protection");
+		protection.cloakHull = attributes.Get("cloak hull protection");
+		protection.energy = attributes.Get("energy protection");
+		protection.heat = attributes.Get("heat protection");
+		protection.fuel = attributes.Get("fuel protection");
+		protection.discharge = attributes.Get("discharge protection");
+		protection.corrosion = attributes.Get("corrosion protection");
+		protection.ion = attributes.Get("ion protection");
+		protection.burn = attributes.Get("burn protection");
+		protection.leak = attributes.Get("leak protection");
+		protection.slowing = attributes.Get("slowing protection");
+		protection.scramble = attributes.Get("scramble protection");
+		protection.disruption = attributes.Get("disruption protection");
+		protection.force = attributes.Get("force protection");
+		return protection;
+	}
+
+	// Get the hull below which a ship with the given attributes is disabled.
+	double GetMinimumHull(const Outfit &attributes, double maximumHull)
+	{
+		double absoluteThreshold = attributes.Get("absolute threshold");
+		if(absoluteThreshold > 0.)
+			return absoluteThreshold;
+
+		double thresholdPercent = attributes.Get("threshold percentage");
+		double transition = 1 / (1 + 0.0005 * maximumHull);
+		double minimumHull = maximumHull * (thresholdPercent > 0.
+			? min(thresholdPercent, 1.) : 0.1 * (1. - transition) + 0.5 * transition);
+
+		return max(0., floor(minimumHull + attributes.Get("hull threshold")));
+	}
+
+	// Get the costs of an action.
+	ShipDerivedStats::Action GetAction(const Outfit &attributes, const ActionKeys &keys)
+	{
+		ShipDerivedStats::Action action;
+		action.shields = attributes.Get(keys.shields);
+		action.hull = attributes.Get(keys.hull);
+		action.energy = attributes.Get(keys.energy);
+		action.fuel = attributes.Get(keys.fuel);
+		action.heat = attributes.Get(keys.heat);
+		action.discharge = attributes.Get(keys.discharge);
+		action.corrosion = attributes.Get(keys.corrosion);
+		action.ionization = attributes.Get(keys.ionization);
+		action.scrambling = attributes.Get(keys.scrambling);
+		action.leakage = attributes.Get(keys.leakage);
+		action.burning = attributes.Get(keys.burning);
+		action.slowness = attributes.Get(keys.slowness);
+		action.disruption = attributes.Get(keys.disruption);
+		return action;
+	}
+}
+
+
+
+// Recalculate everything from the given (ship) attributes.
+void ShipDerivedStats::Calibrate(const Outfit &attributes)
+{
+	const Keys &keys = GetKeys();
+	hullDuringDelay = GetRepair(attributes, keys.hull, true);
+	hull = GetRepair(attributes, keys.hull, false);
+	shieldsDuringDelay = GetRepair(attributes, keys.shields, true);
+	shields = GetRepair(attributes, keys.shields, false);
+
+	ion = GetResistance(attributes, keys.ion);
+	scramble = GetResistance(attributes, keys.scramble);
+	disruption = GetResistance(attributes, keys.disruption);
+	slowing = GetResistance(attributes, keys.slowing);
+	discharge = GetResistance(attributes, keys.discharge);
+	corrosion = GetResistance(attributes, keys.corrosion);
+	leak = GetResistance(attributes, keys.leak);
+	burn = GetResistance(attributes, keys.burn);
+
+	protection = GetProtection(attributes);
+
+	maxShields = attributes.Get("shields") * (1 + attributes.Get("shield multiplier"));
+	maxHull = attributes.Get("hull") * (1 + attributes.Get("hull multiplier"));
+	minimumHull = GetMinimumHull(attributes, maxHull);
+	energyCapacity = attributes.Get("energy capacity");
+	fuelCapacity = attributes.Get("fuel capacity");
+
+	heatDissipation = .001 * attributes.Get("heat dissipation");
+	overheatDamageThreshold = attributes.Get("overheat damage threshold");
+	overheatDamageRate = attributes.Get("overheat damage rate");
+
+	ramscoop = attributes.Get("ramscoop");
+	solarCollection = attributes.Get("solar collection");
+	solarHeat = attributes.Get("solar heat");
+	netEnergy = attributes.Get("energy generation") - attributes.Get("energy consumption");
+	fuelGeneration = attributes.Get("fuel generation");
+	heatGeneration = attributes.Get("heat generation");
+	// This is an S-curve where the efficiency is 100% if you have no outfits
+	// that create "cooling inefficiency", and as that value increases the
+	// efficiency stays high for a while, then drops off, then approaches 0.
+	double x = attributes.Get("cooling inefficiency");
+	coolingEfficiency = 2. + 2. / (1. + exp(x / -2.)) - 4. / (1. + exp(x / -4.));
+	cooling = coolingEfficiency * attributes.Get("cooling");
+	activeCooling = coolingEfficiency * attributes.Get("active cooling");
+	coolingEnergy = attributes.Get("cooling energy");
+	fuelConsumption = attributes.Get("fuel consumption");
+	fuelEnergy = attributes.Get("fuel energy");
+	fuelHeat = attributes.Get("fuel heat");
+
+	turning = GetAction(attributes, keys.turning);
+	thrusting = GetAction(attributes, keys.thrusting);
+	reverseThrusting = GetAction(attributes, keys.reverseThrusting);
+	afterburner = GetAction(attributes, keys.afterburner);
+	thrust = attributes.Get("thrust");
+	reverseThrust = attributes.Get("reverse thrust");
+	afterburnerThrust = attributes.Get("afterburner thrust");
+	accelerationMultiplier = attributes.Get("acceleration multiplier");
+}
+
+
+
+// Check if any of the given outfit's attributes are ones that the derived
+// stats are calculated from. If not, adding or removing it changes nothing.
+bool ShipDerivedStats::IsAffectedBy(const Outfit &outfit)
+{
+	const set<string, less<>> &all = GetKeys().all;
+	for(const auto &it : outfit.Attributes())
+		if(it.second && all.count(it.first))
+			return true;
+	return false;
+}
@@ -0,0 +1,163 @@
+/* ShipDerivedStats.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHIP_DERIVED_STATS_H_
+#define SHIP_DERIVED_STATS_H_
+
+class Outfit;
+
+
+
+// A snapshot of the values a ship's per-frame update derives from its
+// attributes, such as repair rates with their multipliers already applied and
+// the cost of each point repaired. These only change when the ship's outfits
+// do, so they are calculated then instead of being looked up every frame.
+class ShipDerivedStats {
+public:
+	// How much hull or shields can be repaired in one frame, and how much
+	// energy, fuel, and heat each point repaired costs.
+	class Repair {
+	public:
+		double rate = 0.;
+		double energy = 0.;
+		double fuel = 0.;
+		double heat = 0.;
+	};
+
+	// How much of a status effect is resisted in one frame, and how much
+	// energy, fuel, and heat each point resisted costs.
+	class Resistance {
+	public:
+		double resistance = 0.;
+		double energy = 0.;
+		double fuel = 0.;
+		double heat = 0.;
+	};
+
+	// How well the ship is protected from each type of damage, and how easily
+	// damage gets through its shields.
+	class Protection {
+	public:
+		double piercingProtection = 0.;
+		double piercingResistance = 0.;
+		double highShieldPermeability = 0.;
+		double lowShieldPermeability = 0.;
+		double shields = 0.;
+		double cloakShields = 0.;
+		double hull = 0.;
+		double cloakHull = 0.;
+		double energy = 0.;
+		double heat = 0.;
+		double fuel = 0.;
+		double discharge = 0.;
+		double corrosion = 0.;
+		double ion = 0.;
+		double burn = 0.;
+		double leak = 0.;
+		double slowing = 0.;
+		double scramble = 0.;
+		double disruption = 0.;
+		double force = 0.;
+	};
+
+	// The costs and side effects of one frame of turning, thrusting, or
+	// firing the afterburner.
+	class Action {
+	public:
+		double shields = 0.;
+		double hull = 0.;
+		double energy = 0.;
+		double fuel = 0.;
+		double heat = 0.;
+		double discharge = 0.;
+		double corrosion = 0.;
+		double ionization = 0.;
+		double scrambling = 0.;
+		double leakage = 0.;
+		double burning = 0.;
+		double slowness = 0.;
+		double disruption = 0.;
+	};
+
+
+public:
+	ShipDerivedStats() = default;
+
+	// Recalculate everything from the given (ship) attributes.
+	void Calibrate(const Outfit &attributes);
+	// Check if any of the given outfit's attributes are ones that the derived
+	// stats are calculated from. If not, adding or removing it changes nothing.
+	static bool IsAffectedBy(const Outfit &outfit);
+
+
+public:
+	// Repairs while the delay after taking damage is still counting down, and
+	// once it is over and the "delayed" repairs also apply.
+	Repair hullDuringDelay;
+	Repair hull;
+	Repair shieldsDuringDelay;
+	Repair shields;
+
+	Resistance ion;
+	Resistance scramble;
+	Resistance disruption;
+	Resistance slowing;
+	Resistance discharge;
+	Resistance corrosion;
+	Resistance leak;
+	Resistance burn;
+
+	Protection protection;
+
+	double maxShields = 0.;
+	double maxHull = 0.;
+	// The hull below which the ship is disabled, unless it can never be.
+	double minimumHull = 0.;
+	double energyCapacity = 0.;
+	double fuelCapacity = 0.;
+
+	double heatDissipation = 0.;
+	double overheatDamageThreshold = 0.;
+	double overheatDamageRate = 0.;
+
+	double ramscoop = 0.;
+	double solarCollection = 0.;
+	double solarHeat = 0.;
+	// Energy generation minus energy consumption.
+	double netEnergy = 0.;
+	double fuelGeneration = 0.;
+	double heatGeneration = 0.;
+	double coolingEfficiency = 0.;
+	// Cooling and active cooling, already scaled by the cooling efficiency.
+	double cooling = 0.;
+	double activeCooling = 0.;
+	double coolingEnergy = 0.;
+	double fuelConsumption = 0.;
+	double fuelEnergy = 0.;
+	double fuelHeat = 0.;
+
+	Action turning;
+	Action thrusting;
+	Action reverseThrusting;
+	Action afterburner;
+	double thrust = 0.;
+	double reverseThrust = 0.;
+	double afterburnerThrust = 0.;
+	double accelerationMultiplier = 0.;
+};
+
+
+
+#endif
@@ -270,6 +270,48 @@ namespace {
 
 
 
+Format::Template::Template(const string &source)
+	: source(source)
+{
+	// A key runs from a '<' to the first '>' after it. If no '>' follows a '<',
+	// none follows any later '<' either.
+	for(size_t left = source.find('<'); left != string::npos; left = source.find('<', left + 1))
+	{
+		size_t right = source.find('>', left);
+		if(right == string::npos)
+			break;
+		candidates.emplace_back(left, source.substr(left, right + 1 - left));
+	}
+}
+
+
+
+string Format::Template::Replace(const map<string, string> &keys) const
+{
+	string target;
+	target.reserve(source.length());
+
+	// Once a key has been substituted, any keys that overlap it are skipped.
+	size_t start = 0;
+	for(const auto &key : candidates)
+	{
+		if(key.first < start)
+			continue;
+		auto found = keys.find(key.second);
+		if(found == keys.end())
+			continue;
+
+		target.append(source, start, key.first - start);
+		target.append(found->second);
+		start = key.first + key.second.length();
+	}
+
+	target.append(source, start, string::npos);
+	return target;
+}
+
+
+
 // Convert the given number into abbreviated format with a suffix like
 // "M" for million, "B" for billion, or "T" for trillion. Any number
 // above 1 quadrillion is instead shown in scientific notation.
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <functional>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -32,6 +33,25 @@ public:
 	// name.
 	using ConditionGetter = std::function<int64_t(const std::string &source, size_t start, size_t size)>;
 
+	// A string containing "<key>" substitutions, scanned once so that it can be
+	// filled in many times with different sets of keys without searching it
+	// for angle brackets or building the key strings again each time.
+	class Template {
+	public:
+		Template() = default;
+		explicit Template(const std::string &source);
+
+		// Get the result of Format::Replace(source, keys).
+		std::string Replace(const std::map<std::string, std::string> &keys) const;
+
+
+	private:
+		std::string source;
+		// Everything that looks like a key, in order of where it begins in the
+		// source. These may overlap, e.g. "<a <b>" holds both "<a <b>" and "<b>".
+		std::vector<std::pair<size_t, std::string>> candidates;
+	};
+
 
 public:
 	// Convert the given number into abbreviated format with a suffix like
@@ -64,7 +84,8 @@ public:
 	// string can have suffixes like "M", "B", etc.
 	static double Parse(const std::string &str);
 	// Replace a set of "keys," which must be strings in the form "<name>", with
-	// a new set of strings, and return the result.
+	// a new set of strings, and return the result. Use a Template instead if
+	// the same source will be filled in more than once.
 	static std::string Replace(const std::string &source, const std::map<std::string, std::string> &keys);
 	// Recursively expand substitutions in all key/value pairs. Will detect
 	// infinite recursion; offending substitutions will not be expanded.
@@ -18,10 +18,24 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DisplayText.h"
 #include "Font.h"
 
+#include <cstdint>
+#include <algorithm>
 #include <cstring>
+#include <functional>
+#include <mutex>
+#include <string_view>
 
 using namespace std;
 
+namespace {
+	// How many recently wrapped texts to remember. This should be enough for
+	// every block of text that is visible at once.
+	const size_t CACHE_SIZE = 64;
+
+	mutex cacheMutex;
+	WrappedText::CacheStats cacheStats;
+}
+
 
 
 WrappedText::WrappedText(const Font &font)
@@ -125,18 +139,14 @@ void WrappedText::SetParagraphBreak(int height)
 // always begin at (0, 0).
 void WrappedText::Wrap(const string &str)
 {
-	SetText(str.data(), str.length());
-
-	Wrap();
+	Wrap(str.data(), str.length());
 }
 
 
 
 void WrappedText::Wrap(const char *str)
 {
-	SetText(str, strlen(str));
-
-	Wrap();
+	Wrap(str, strlen(str));
 }
 
 
@@ -144,7 +154,7 @@ void WrappedText::Wrap(const char *str)
 // Get the height of the wrapped text.
 int WrappedText::Height() const
 {
-	return height;
+	return layout ? layout->height : 0;
 }
 
 
@@ -152,7 +162,7 @@ int WrappedText::Height() const
 // Return the width of the longest line of the wrapped text.
 int WrappedText::LongestLineWidth() const
 {
-	return longestLineWidth;
+	return layout ? layout->longestLineWidth : 0;
 }
 
 
@@ -160,8 +170,10 @@ int WrappedText::LongestLineWidth() const
 // Draw the text.
 void WrappedText::Draw(const Point &topLeft, const Color &color) const
 {
-	if(words.empty())
+	if(!layout || layout->words.empty())
 		return;
+	const string &text = layout->text;
+	const vector<Word> &words = layout->words;
 	
 	scrollY.Step();
 
@@ -222,8 +234,8 @@ void WrappedText::SetScroll(int offsetY)
 {
 	if(offsetY < 0)
 		scrollY = 0;
-	else if(offsetY > height - visibleHeight)
-		scrollY = height - visibleHeight;
+	else if(offsetY > Height() - visibleHeight)
+		scrollY = Height() - visibleHeight;
 	else
 		scrollY = offsetY;
 }
@@ -244,25 +256,121 @@ Point WrappedText::Word::Pos() const
 
 
 
-void WrappedText::SetText(const char *it, size_t length)
+// Get the statistics of the layout cache shared by all instances.
+WrappedText::CacheStats WrappedText::GetCacheStats()
 {
-	// Clear any previous word-wrapping data. It becomes invalid as soon as the
-	// underlying text buffer changes.
-	words.clear();
-
-	// Reallocate that buffer.
-	text.assign(it, length);
+	lock_guard<mutex> lock(cacheMutex);
+	return cacheStats;
 }
 
 
 
-void WrappedText::Wrap()
+// Find the layout of the given text in the cache, or compute it if it is not
+// there. The cache is small enough to search in order, and finding a layout in
+// it does not allocate anything. Text that changes every frame never finds its
+// layout, so a miss reuses the storage of the least recently used layout if no
+// one else is still drawing it.
+void WrappedText::Wrap(const char *str, size_t length)
 {
-	height = 0;
-	longestLineWidth = 0;
-
-	if(text.empty() || !font)
+	class Entry {
+	public:
+		size_t hash;
+		const Font *font;
+		int wrapWidth;
+		int tabWidth;
+		int lineHeight;
+		int paragraphBreak;
+		Alignment alignment;
+		string source;
+		shared_ptr<Layout> layout;
+		uint64_t lastUse;
+	};
+	static vector<Entry> cache;
+	static uint64_t useCount = 0;
+
+	if(!length || !font)
+	{
+		layout.reset();
 		return;
+	}
+
+	const string_view source(str, length);
+	const size_t hash = std::hash<string_view>()(source);
+	auto matches = [&](const Entry &entry) -> bool
+	{
+		return entry.layout && entry.hash == hash && entry.font == font && entry.wrapWidth == wrapWidth
+			&& entry.tabWidth == tabWidth && entry.lineHeight == lineHeight
+			&& entry.paragraphBreak == paragraphBreak && entry.alignment == alignment
+			&& entry.source == source;
+	};
+
+	auto isOlder = [](const Entry &a, const Entry &b) -> bool
+	{
+		return a.lastUse < b.lastUse;
+	};
+
+	shared_ptr<Layout> result;
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		for(Entry &entry : cache)
+			if(matches(entry))
+			{
+				++cacheStats.hits;
+				entry.lastUse = ++useCount;
+				layout = entry.layout;
+				return;
+			}
+		++cacheStats.misses;
+
+		// Take over the layout that is about to be evicted, unless some other
+		// WrappedText still refers to it. Its entry is then empty and will be
+		// the next one to be replaced.
+		if(cache.size() == CACHE_SIZE)
+		{
+			Entry &oldest = *min_element(cache.begin(), cache.end(), isOlder);
+			if(oldest.layout.use_count() == 1)
+			{
+				result = std::move(oldest.layout);
+				oldest.lastUse = 0;
+			}
+		}
+	}
+
+	// Wrap the text outside the lock, since that is the slow part.
+	if(result)
+	{
+		result->words.clear();
+		result->height = 0;
+		result->longestLineWidth = 0;
+	}
+	else
+		result = make_shared<Layout>();
+	result->text.assign(str, length);
+	Wrap(*result);
+	layout = result;
+
+	lock_guard<mutex> lock(cacheMutex);
+	Entry &entry = (cache.size() < CACHE_SIZE) ? cache.emplace_back()
+		: *min_element(cache.begin(), cache.end(), isOlder);
+	entry.hash = hash;
+	entry.font = font;
+	entry.wrapWidth = wrapWidth;
+	entry.tabWidth = tabWidth;
+	entry.lineHeight = lineHeight;
+	entry.paragraphBreak = paragraphBreak;
+	entry.alignment = alignment;
+	// Assign the text in place, so the evicted entry's buffer can be reused.
+	entry.source.assign(source);
+	entry.layout = std::move(result);
+	entry.lastUse = ++useCount;
+}
+
+
+
+void WrappedText::Wrap(Layout &wrapped) const
+{
+	string &text = wrapped.text;
+	vector<Word> &words = wrapped.words;
 
 	// Do this as a finite state machine.
 	Word word;
@@ -300,7 +408,7 @@ void WrappedText::Wrap()
 				word.x = 0;
 
 				// Adjust the spacing of words in the now-complete line.
-				AdjustLine(lineBegin, lineWidth, false);
+				AdjustLine(wrapped, lineBegin, lineWidth, false);
 			}
 			// Store this word, then advance the x position to the end of it.
 			words.push_back(word);
@@ -317,7 +425,7 @@ void WrappedText::Wrap()
 			word.x = 0;
 
 			// Adjust the word spacings on the now-completed line.
-			AdjustLine(lineBegin, lineWidth, true);
+			AdjustLine(wrapped, lineBegin, lineWidth, true);
 			currentLineHasWords = false;
 		}
 		// Otherwise, whitespace just adds to the x position.
@@ -344,7 +452,7 @@ void WrappedText::Wrap()
 			word.x = 0;
 
 			// Adjust the spacing of words in the now-complete line.
-			AdjustLine(lineBegin, lineWidth, false);
+			AdjustLine(wrapped, lineBegin, lineWidth, false);
 		}
 		// Store this word, then advance the x position to the end of it.
 		words.push_back(word);
@@ -357,20 +465,21 @@ void WrappedText::Wrap()
 		word.y += lineHeight + paragraphBreak;
 
 	// Adjust the spacing of words in the final line of text.
-	AdjustLine(lineBegin, lineWidth, true);
+	AdjustLine(wrapped, lineBegin, lineWidth, true);
 
-	height = word.y;
+	wrapped.height = word.y;
 }
 
 
 
-void WrappedText::AdjustLine(size_t &lineBegin, int &lineWidth, bool isEnd)
+void WrappedText::AdjustLine(Layout &wrapped, size_t &lineBegin, int &lineWidth, bool isEnd) const
 {
+	vector<Word> &words = wrapped.words;
 	int wordCount = static_cast<int>(words.size() - lineBegin);
 	int extraSpace = wrapWidth - lineWidth;
 
-	if(lineWidth > longestLineWidth)
-		longestLineWidth = lineWidth;
+	if(lineWidth > wrapped.longestLineWidth)
+		wrapped.longestLineWidth = lineWidth;
 
 	// Figure out how much space is left over. Depending on the alignment, we
 	// will add that space to the left, to the right, to both sides, or to the
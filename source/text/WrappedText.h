@@ -22,6 +22,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../Point.h"
 #include "truncate.hpp"
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,8 +33,19 @@ class Font;
 
 
 // Class for calculating word positions in wrapped text. You can specify various
-// parameters of the formatting, including text alignment.
+// parameters of the formatting, including text alignment. Panels often wrap the
+// same text again every frame, so recently computed layouts are kept in a cache
+// shared by all instances, keyed by the text and every formatting parameter.
 class WrappedText {
+public:
+	// How often the layout cache has been used or had to wrap the text anew.
+	class CacheStats {
+	public:
+		int64_t hits = 0;
+		int64_t misses = 0;
+	};
+
+
 public:
 	WrappedText() = default;
 	explicit WrappedText(const Font &font);
@@ -86,13 +99,18 @@ public:
 	int Scroll() { return scrollY; }
 	void DoScroll(int dY) { SetScroll(scrollY + dY); }
 	bool CanScrollUp() const { return scrollY > 0; }
-	bool CanScrollDown() const { return visibleHeight != -1 && scrollY < height - visibleHeight; }
+	bool CanScrollDown() const { return visibleHeight != -1 && scrollY < Height() - visibleHeight; }
+
+	// Get the statistics of the layout cache shared by all instances.
+	static CacheStats GetCacheStats();
 
 
 private:
-	void SetText(const char *it, size_t length);
-	void Wrap();
-	void AdjustLine(size_t &lineBegin, int &lineWidth, bool isEnd);
+	class Layout;
+
+	void Wrap(const char *str, size_t length);
+	void Wrap(Layout &wrapped) const;
+	void AdjustLine(Layout &wrapped, size_t &lineBegin, int &lineWidth, bool isEnd) const;
 	int Space(char c) const;
 
 
@@ -113,6 +131,17 @@ private:
 		friend class WrappedText;
 	};
 
+	// The text, with a '\0' after each word, and where each word is drawn.
+	// Layouts are never changed while they are shared. Only the cache reuses the
+	// storage of a layout that nothing else refers to any more.
+	class Layout {
+	public:
+		std::string text;
+		std::vector<Word> words;
+		int height = 0;
+		int longestLineWidth = 0;
+	};
+
 
 private:
 	const Font *font = nullptr;
@@ -125,13 +154,9 @@ private:
 	Alignment alignment = Alignment::JUSTIFIED;
 	Truncate truncate = Truncate::NONE;
 
-	std::string text;
-	std::vector<Word> words;
-	int height = 0;
+	std::shared_ptr<const Layout> layout;
 	int visibleHeight = -1;
 	mutable Animate<int> scrollY;
-	
-	int longestLineWidth = 0;
 };
 
 
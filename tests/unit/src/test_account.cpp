@@ -49,6 +49,16 @@ SCENARIO( "Creating an Account" , "[Account][Creation]" ) {
 				REQUIRE( account.TotalDebt() == 10000 );
 			}
 		}
+		WHEN( "anything in the account changes" ) {
+			const uint64_t epoch = account.Epoch();
+			const Account copy = account;
+			account.AddCredits(100);
+			THEN( "its epoch changes too" ) {
+				REQUIRE( account.Epoch() != epoch );
+				REQUIRE( copy.Epoch() == epoch );
+				REQUIRE( Account().Epoch() != epoch );
+			}
+		}
 	}
 }
 // #endregion unit tests
@@ -0,0 +1,203 @@
+/* test_allocationCounter.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/AllocationCounter.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/BatchDrawList.h"
+#include "../../../source/Body.h"
+#include "../../../source/DrawList.h"
+#include "../../../source/ImageBuffer.h"
+#include "../../../source/Radar.h"
+#include "../../../source/Screen.h"
+#include "../../../source/Sprite.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// The objects in a battle: ships drawn in the draw lists and on the radar, and
+// projectiles and visuals drawn in the batch draw lists.
+class Battle {
+public:
+	explicit Battle(const Sprite *sprite)
+	{
+		for(int i = 0; i < 3000; ++i)
+		{
+			Point position((i * 37) % 1800 - 900, (i * 53) % 1000 - 500);
+			if(i < 200)
+				ships.emplace_back(sprite, position, Point(1., 2.), Angle(i * 7.));
+			else if(i < 1600)
+				projectiles.emplace_back(sprite, position, Point(-3., 4.), Angle(i * 7.));
+			else
+				visuals.emplace_back(sprite, position);
+		}
+	}
+
+	// Fill one set of lists the way the engine does at the end of each step.
+	void Fill(DrawList &draw, BatchDrawList &batchDraw, Radar &radar, int step) const
+	{
+		draw.Clear(step);
+		batchDraw.Clear(step);
+		radar.Clear();
+
+		const Point center(step % 10, 0.);
+		draw.SetCenter(center);
+		batchDraw.SetCenter(center);
+		radar.SetCenter(center);
+		for(const Body &ship : ships)
+		{
+			draw.Add(ship);
+			radar.Add(Radar::HOSTILE, ship.Position(), 5., 3.);
+		}
+		for(const Body &projectile : projectiles)
+			batchDraw.Add(projectile, .5f);
+		for(const Body &visual : visuals)
+			batchDraw.AddVisual(visual);
+	}
+
+
+private:
+	std::vector<Body> ships;
+	std::vector<Body> projectiles;
+	std::vector<Body> visuals;
+};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Counting heap allocations", "[AllocationCounter]" ) {
+	GIVEN( "a build that counts allocations" ) {
+		if(!AllocationCounter::IsEnabled())
+		{
+			WARN( "Allocations are only counted in debug builds." );
+			return;
+		}
+
+		THEN( "every allocation is counted" ) {
+			const uint64_t before = AllocationCounter::Count();
+			auto single = std::make_unique<int>(1);
+			auto array = std::make_unique<int[]>(10);
+			CHECK( AllocationCounter::Count() - before == 2 );
+		}
+		THEN( "reusing memory is not counted" ) {
+			std::vector<int> values(100);
+			const uint64_t before = AllocationCounter::Count();
+			values.clear();
+			values.resize(100);
+			CHECK( AllocationCounter::Count() == before );
+		}
+	}
+}
+
+SCENARIO( "Tallying allocations by tag", "[AllocationCounter]" ) {
+	GIVEN( "a build that counts allocations" ) {
+		if(!AllocationCounter::IsEnabled())
+		{
+			WARN( "Allocations are only counted in debug builds." );
+			return;
+		}
+
+		THEN( "allocations are given the tag of the innermost scope" ) {
+			const AllocationCounter::Tally outerBefore = AllocationCounter::Get("test: outer");
+			const AllocationCounter::Tally innerBefore = AllocationCounter::Get("test: inner");
+			{
+				AllocationCounter::Scope outer("test: outer");
+				auto first = std::make_unique<char[]>(100);
+				{
+					AllocationCounter::Scope inner("test: inner");
+					auto second = std::make_unique<char[]>(30);
+				}
+				auto third = std::make_unique<char[]>(20);
+			}
+			auto untagged = std::make_unique<char[]>(1000);
+
+			const AllocationCounter::Tally outer = AllocationCounter::Get("test: outer");
+			const AllocationCounter::Tally inner = AllocationCounter::Get("test: inner");
+			CHECK( outer.count - outerBefore.count == 2 );
+			CHECK( outer.bytes - outerBefore.bytes == 120 );
+			CHECK( inner.count - innerBefore.count == 1 );
+			CHECK( inner.bytes - innerBefore.bytes == 30 );
+		}
+		THEN( "a scope can switch between tags" ) {
+			const AllocationCounter::Tally firstBefore = AllocationCounter::Get("test: first phase");
+			const AllocationCounter::Tally secondBefore = AllocationCounter::Get("test: second phase");
+			{
+				AllocationCounter::Scope scope("test: first phase");
+				auto first = std::make_unique<int>(1);
+				scope.Set("test: second phase");
+				auto second = std::make_unique<int>(2);
+				auto third = std::make_unique<int>(3);
+			}
+			CHECK( AllocationCounter::Get("test: first phase").count - firstBefore.count == 1 );
+			CHECK( AllocationCounter::Get("test: second phase").count - secondBefore.count == 2 );
+		}
+		THEN( "every tag that has been used is listed" ) {
+			{
+				AllocationCounter::Scope scope("test: listed");
+			}
+			const std::vector<AllocationCounter::Tally> tallies = AllocationCounter::Tallies();
+			REQUIRE( !tallies.empty() );
+			CHECK( std::string(tallies.front().tag) == "untagged" );
+			CHECK( std::count_if(tallies.begin(), tallies.end(), [](const AllocationCounter::Tally &tally)
+				{ return std::string(tally.tag) == "test: listed"; }) == 1 );
+			CHECK( AllocationCounter::Get("test: never used").count == 0 );
+		}
+	}
+}
+
+SCENARIO( "Filling the draw lists for a battle", "[AllocationCounter][DrawList][BatchDrawList]" ) {
+	GIVEN( "the double-buffered lists the engine draws from" ) {
+		if(!AllocationCounter::IsEnabled())
+		{
+			WARN( "Allocations are only counted in debug builds." );
+			return;
+		}
+
+		// Give the sprite frames without any image data, so nothing is uploaded.
+		Sprite sprite("test/battle");
+		ImageBuffer frames(4);
+		sprite.AddFrames(frames, false);
+		Screen::SetRaw(1920, 1080);
+		const Battle battle(&sprite);
+
+		DrawList draw[2];
+		BatchDrawList batchDraw[2];
+		Radar radar[2];
+		// Warm up, so that every list has grown to its full size.
+		for(int step = 0; step < 2; ++step)
+			battle.Fill(draw[step % 2], batchDraw[step % 2], radar[step % 2], step);
+
+		THEN( "no more memory is allocated in later steps" ) {
+			const uint64_t before = AllocationCounter::Count();
+			for(int step = 2; step < 100; ++step)
+				battle.Fill(draw[step % 2], batchDraw[step % 2], radar[step % 2], step);
+			CHECK( AllocationCounter::Count() == before );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
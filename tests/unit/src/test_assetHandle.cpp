@@ -0,0 +1,68 @@
+/* test_assetHandle.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/AssetHandle.h"
+
+// Include the assets that the handles refer to.
+#include "../../../source/Audio.h"
+#include "../../../source/Effect.h"
+#include "../../../source/GameData.h"
+#include "../../../source/Sound.h"
+
+namespace { // test namespace
+
+// #region mock data
+const AssetHandle<Effect> TEST_EFFECT("test asset handle effect");
+const AssetHandle<Sound> TEST_SOUND("test asset handle sound");
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Binding asset handles", "[AssetHandle]" ) {
+	GIVEN( "handles declared at namespace scope" ) {
+		THEN( "they remember their names" ) {
+			CHECK( TEST_EFFECT.Name() == "test asset handle effect" );
+			CHECK( TEST_SOUND.Name() == "test asset handle sound" );
+		}
+		THEN( "binding them finds the same assets as looking them up by name" ) {
+			AssetHandle<Effect>::BindAll();
+			AssetHandle<Sound>::BindAll();
+			REQUIRE( TEST_EFFECT.Get() );
+			CHECK( TEST_EFFECT.Get() == GameData::Effects().Get("test asset handle effect") );
+			REQUIRE( TEST_SOUND.Get() );
+			CHECK( TEST_SOUND.Get() == Audio::Get("test asset handle sound") );
+		}
+	}
+	GIVEN( "a handle that has been destroyed" ) {
+		{
+			const AssetHandle<Effect> temporary("test asset handle temporary");
+			AssetHandle<Effect>::BindAll();
+			CHECK( temporary.Get() == GameData::Effects().Get("test asset handle temporary") );
+		}
+		THEN( "binding the remaining handles does not touch it" ) {
+			AssetHandle<Effect>::BindAll();
+			CHECK( TEST_EFFECT.Get() == GameData::Effects().Get("test asset handle effect") );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
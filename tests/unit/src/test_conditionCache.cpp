@@ -0,0 +1,165 @@
+/* test_conditionCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ConditionCache.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/ConditionSet.h"
+#include "../../../source/ConditionsStore.h"
+#include "../../../source/Mission.h"
+#include "../../../source/PlayerInfo.h"
+#include "../../../source/Random.h"
+#include "../../../source/Ship.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+const std::vector<std::string> NAMES = {"a", "b", "c", "d", "e"};
+
+std::vector<ConditionSet> MakeSets()
+{
+	std::vector<ConditionSet> sets;
+	for(const char *text : {
+			"to offer\n\thas a\n\tnot b",
+			"to offer\n\tc + d > 5",
+			"to offer\n\tor\n\t\thas a\n\t\te == 2",
+			"to offer\n\tx = a * 2\n\tx >= 2",
+			"to offer\n\t( b - c ) * 3 <= d",
+			"to offer\n\thas \"derived: e\"",
+			"to offer\n\tnever",
+		})
+		sets.emplace_back(AsDataNode(text));
+	return sets;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Caching the results of ConditionSets", "[ConditionCache]" ) {
+	GIVEN( "a store with primary and derived conditions" ) {
+		ConditionsStore store;
+		int64_t derivedValue = 0;
+		store.GetProviderPrefixed("derived: ").SetGetFunction([&derivedValue](const std::string &) {
+			return derivedValue; });
+		const std::vector<ConditionSet> sets = MakeSets();
+		ConditionCache cache;
+
+		THEN( "the cached results always match testing every set again" ) {
+			std::mt19937 rng(1234);
+			std::uniform_int_distribution<size_t> name(0, NAMES.size() - 1);
+			std::uniform_int_distribution<int> action(0, 4);
+			std::uniform_int_distribution<int> value(-2, 6);
+			for(int round = 0; round < 500; ++round)
+			{
+				switch(action(rng))
+				{
+					case 0:
+						store.Set(NAMES[name(rng)], value(rng));
+						break;
+					case 1:
+						store.Add(NAMES[name(rng)], value(rng));
+						break;
+					case 2:
+						store.Erase(NAMES[name(rng)]);
+						break;
+					case 3:
+						store[NAMES[name(rng)]] = value(rng);
+						break;
+					default:
+						// Derived conditions change without the store knowing.
+						derivedValue = value(rng);
+				}
+				cache.Update(store);
+				for(const ConditionSet &set : sets)
+					REQUIRE( cache.Test(set, store) == set.Test(store) );
+			}
+		}
+	}
+	GIVEN( "a set whose result has been cached" ) {
+		ConditionsStore store{{"a", 1}};
+		const ConditionSet set(AsDataNode("to offer\n\thas a"));
+		ConditionCache cache;
+		cache.Update(store);
+		REQUIRE( cache.Test(set, store) );
+
+		THEN( "writes to unrelated conditions keep the cached result" ) {
+			store.Set("b", 1);
+			cache.Update(store);
+			CHECK( cache.Test(set, store) );
+			CHECK( store.Changes().empty() );
+		}
+		THEN( "the store stops tracking changes once it is cleared" ) {
+			store.Clear();
+			CHECK_FALSE( store.IsTrackingChanges() );
+			cache.Update(store);
+			CHECK_FALSE( cache.Test(set, store) );
+		}
+	}
+}
+
+SCENARIO( "Offering a mission through the cache", "[ConditionCache][Mission]" ) {
+	GIVEN( "a mission that is offered 30% of the time" ) {
+		const Mission mission(AsDataNode("mission \"Random Offer\"\n\tboarding\n\tto offer\n\t\trandom < 30"));
+		PlayerInfo player;
+		const auto ship = std::make_shared<Ship>();
+		ConditionCache cache;
+		cache.Update(player.Conditions());
+
+		THEN( "each check draws one random number, so it is offered with the same probability" ) {
+			const int TRIALS = 1000;
+			Random::Seed(30);
+			int offers = 0;
+			for(int i = 0; i < TRIALS; ++i)
+				offers += mission.CanOffer(player, ship, &cache);
+
+			Random::Seed(30);
+			int expected = 0;
+			for(int i = 0; i < TRIALS; ++i)
+				expected += (Random::Int(100) < 30);
+
+			CHECK( offers == expected );
+			CHECK( offers > TRIALS / 4 );
+			CHECK( offers < TRIALS * 7 / 20 );
+		}
+	}
+}
+
+SCENARIO( "Listing the conditions a ConditionSet uses", "[ConditionSet][ReferencedConditions]" ) {
+	GIVEN( "a set with nested and complex expressions" ) {
+		const ConditionSet set(AsDataNode("to offer\n\tx = a * 2\n\tor\n\t\thas b\n\t\t( c + 4 ) > d"));
+		THEN( "every condition name on either side is found, but no numbers" ) {
+			CHECK( set.ReferencedConditions() == std::set<std::string>{"a", "b", "c", "d", "x"} );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
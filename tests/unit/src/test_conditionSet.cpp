@@ -27,16 +27,141 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/ConditionsStore.h"
 
 // ... and any system includes needed for the test file.
+#include "../../../source/Random.h"
+
 #include <cstdint>
+#include <limits>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace { // test namespace
 using Conditions = std::map<std::string, int64_t>;
 // #region mock data
+// Generates random arithmetic expressions as ConditionSet tokens, along with
+// the value they should have, computed the way one would by hand.
+class ExpressionFuzzer {
+public:
+	explicit ExpressionFuzzer(const ConditionsStore &store) : store(store) {}
+
+	// Generate an expression and return its tokens.
+	std::vector<std::string> Generate(int depth)
+	{
+		std::vector<std::string> tokens;
+		AddSum(tokens, depth);
+		return tokens;
+	}
+
+	// Evaluate the tokens with the usual precedence, reading left to right.
+	int64_t Evaluate(const std::vector<std::string> &tokens)
+	{
+		size_t index = 0;
+		return Sum(tokens, index);
+	}
+
+
+private:
+	void AddSum(std::vector<std::string> &tokens, int depth)
+	{
+		int terms = 1 + Random::Int(3);
+		for(int i = 0; i < terms; ++i)
+		{
+			if(i)
+				tokens.emplace_back(Random::Int(2) ? "+" : "-");
+			AddProduct(tokens, depth);
+		}
+	}
+
+	void AddProduct(std::vector<std::string> &tokens, int depth)
+	{
+		static const std::vector<std::string> OPERATORS = {"*", "/", "%"};
+		int factors = 1 + Random::Int(3);
+		for(int i = 0; i < factors; ++i)
+		{
+			if(!i)
+				AddFactor(tokens, depth);
+			else
+			{
+				tokens.emplace_back(OPERATORS[Random::Int(OPERATORS.size())]);
+				// Never divide by zero, since that would make later steps overflow.
+				if(tokens.back() == "*")
+					AddFactor(tokens, depth);
+				else
+					tokens.emplace_back(std::to_string(1 + Random::Int(9)));
+			}
+		}
+	}
+
+	void AddFactor(std::vector<std::string> &tokens, int depth)
+	{
+		static const std::vector<std::string> ATOMS = {"a", "b", "c", "unset", "random", "0", "7", "12"};
+		if(depth > 0 && !Random::Int(3))
+		{
+			tokens.emplace_back("(");
+			AddSum(tokens, depth - 1);
+			tokens.emplace_back(")");
+		}
+		else
+			tokens.emplace_back(ATOMS[Random::Int(ATOMS.size())]);
+	}
+
+	int64_t Sum(const std::vector<std::string> &tokens, size_t &index)
+	{
+		int64_t value = Product(tokens, index);
+		while(index < tokens.size() && (tokens[index] == "+" || tokens[index] == "-"))
+		{
+			bool add = tokens[index++] == "+";
+			int64_t other = Product(tokens, index);
+			value = add ? value + other : value - other;
+		}
+		return value;
+	}
 
+	int64_t Product(const std::vector<std::string> &tokens, size_t &index)
+	{
+		int64_t value = Factor(tokens, index);
+		while(index < tokens.size() && (tokens[index] == "*" || tokens[index] == "/" || tokens[index] == "%"))
+		{
+			std::string op = tokens[index++];
+			int64_t other = Factor(tokens, index);
+			if(op == "*")
+				value *= other;
+			else if(op == "/")
+				value /= other;
+			else
+				value %= other;
+		}
+		return value;
+	}
 
+	int64_t Factor(const std::vector<std::string> &tokens, size_t &index)
+	{
+		const std::string &token = tokens[index++];
+		if(token == "(")
+		{
+			int64_t value = Sum(tokens, index);
+			++index;
+			return value;
+		}
+		if(token == "random")
+			return Random::Int(100);
+		if(token.front() >= '0' && token.front() <= '9')
+			return std::stoll(token);
+		return store.Get(token);
+	}
 
+
+private:
+	const ConditionsStore &store;
+};
+
+std::string Join(const std::vector<std::string> &tokens)
+{
+	std::string result;
+	for(const std::string &token : tokens)
+		result += (result.empty() ? "" : " ") + token;
+	return result;
+}
 // #endregion mock data
 
 
@@ -181,6 +306,69 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 		}
 	}
 }
+
+SCENARIO( "Evaluating arithmetic in conditions", "[ConditionSet][Usage]" ) {
+	GIVEN( "a set of conditions" ) {
+		auto store = ConditionsStore{{"a", 3}, {"b", -5}, {"c", 40}};
+
+		THEN( "operators have the usual precedence" ) {
+			const auto set = ConditionSet{AsDataNode("and\n"
+				"\tx = a + b * c\n"
+				"\ty = ( a + b ) * c\n"
+				"\tz = c / a % 5 - 2 - 1\n"
+				"\tw = c / 0")};
+			set.Apply(store);
+			CHECK( store.Get("x") == -197 );
+			CHECK( store.Get("y") == -80 );
+			CHECK( store.Get("z") == 0 );
+			CHECK( store.Get("w") == std::numeric_limits<int64_t>::max() );
+		}
+		THEN( "temporary conditions are used when testing" ) {
+			const auto set = ConditionSet{AsDataNode("and\n"
+				"\ttemp = a * 2\n"
+				"\ttemp + 1 == 7")};
+			CHECK( set.Test(store) );
+			CHECK_FALSE( store.Get("temp") );
+		}
+		THEN( "derived conditions are read when they change" ) {
+			int64_t derived = 1;
+			store.GetProviderNamed("derived").SetGetFunction([&derived](const std::string &) { return derived; });
+			const auto set = ConditionSet{AsDataNode("and\n\tderived * 2 > 3")};
+			CHECK_FALSE( set.Test(store) );
+			derived = 2;
+			CHECK( set.Test(store) );
+		}
+		THEN( "conditions that are added or removed later are found" ) {
+			const auto set = ConditionSet{AsDataNode("and\n\tlater + a == 4")};
+			CHECK_FALSE( set.Test(store) );
+			store.Set("later", 1);
+			CHECK( set.Test(store) );
+			store.Erase("later");
+			CHECK_FALSE( set.Test(store) );
+		}
+		THEN( "random expressions have the same value as when evaluated by hand" ) {
+			ExpressionFuzzer fuzzer(store);
+			for(int i = 0; i < 500; ++i)
+			{
+				const std::vector<std::string> tokens = fuzzer.Generate(2);
+				const std::string expression = Join(tokens);
+				INFO( expression );
+
+				const auto set = ConditionSet{AsDataNode("and\n\tresult = " + expression)};
+				Random::Seed(i);
+				const int64_t expected = fuzzer.Evaluate(tokens);
+				Random::Seed(i);
+				set.Apply(store);
+				REQUIRE( store.Get("result") == expected );
+
+				const std::string compare = expression + " == " + std::to_string(expected);
+				const auto test = ConditionSet{AsDataNode("and\n\t" + compare)};
+				Random::Seed(i);
+				REQUIRE( test.Test(store) );
+			}
+		}
+	}
+}
 // #endregion unit tests
 
 
@@ -629,6 +629,121 @@ SCENARIO( "Providing multiple derived conditions", "[ConditionStore][DerivedMult
 	}
 }
 
+SCENARIO( "Caching derived conditions", "[ConditionStore][DerivedCache]" )
+{
+	GIVEN( "A conditionsStore and a cached prefixed provider" )
+	{
+		auto store = ConditionsStore();
+		int calls = 0;
+		int64_t value = 10;
+		uint64_t epoch = 1;
+		auto &&provider = store.GetProviderPrefixed("net worth: ");
+		provider.SetGetFunction([&calls, &value](const std::string &name) { ++calls; return value; });
+		provider.SetSetFunction([&value](const std::string &name, int64_t newValue) {
+			value = newValue;
+			return true;
+		});
+		provider.SetCacheEpoch([&epoch]() { return epoch; });
+		WHEN( "a condition is read repeatedly within one epoch" )
+		{
+			REQUIRE( store.Get("net worth: A") == 10 );
+			value = 20;
+			THEN( "the value is only computed once per condition" )
+			{
+				REQUIRE( store.Get("net worth: A") == 10 );
+				REQUIRE( store["net worth: A"] == 10 );
+				REQUIRE( store.Get("net worth: B") == 20 );
+				REQUIRE( calls == 2 );
+				REQUIRE( provider.GetCacheStats().hits == 2 );
+				REQUIRE( provider.GetCacheStats().misses == 2 );
+				REQUIRE( store.GetCacheStats().hits == 2 );
+			}
+		}
+		WHEN( "the epoch changes" )
+		{
+			REQUIRE( store.Get("net worth: A") == 10 );
+			value = 20;
+			epoch = 2;
+			THEN( "the value is computed again" )
+			{
+				REQUIRE( store.Get("net worth: A") == 20 );
+				REQUIRE( calls == 2 );
+			}
+		}
+		WHEN( "a condition is written through the store" )
+		{
+			REQUIRE( store.Get("net worth: A") == 10 );
+			REQUIRE( store.Set("net worth: A", 30) );
+			THEN( "the cached value is forgotten" )
+			{
+				REQUIRE( store.Get("net worth: A") == 30 );
+				store["net worth: A"] += 5;
+				REQUIRE( store.Get("net worth: A") == 35 );
+			}
+		}
+		WHEN( "the epoch is 0" )
+		{
+			epoch = 0;
+			THEN( "nothing is cached" )
+			{
+				REQUIRE( store.Get("net worth: A") == 10 );
+				value = 20;
+				REQUIRE( store.Get("net worth: A") == 20 );
+				REQUIRE( provider.GetCacheStats().hits == 0 );
+			}
+		}
+	}
+}
+
+SCENARIO( "Reading conditions through slots", "[ConditionStore][Slots]" )
+{
+	GIVEN( "A conditionsStore with primary and derived conditions" )
+	{
+		auto store = ConditionsStore{{"a", 1}, {"b", 2}};
+		store.GetProviderPrefixed("ships: ").SetGetFunction([](const std::string &name) { return name.size(); });
+		const ConditionsStore::Slot a = ConditionsStore::GetSlot("a");
+		const ConditionsStore::Slot c = ConditionsStore::GetSlot("c");
+		const ConditionsStore::Slot ships = ConditionsStore::GetSlot("ships: Shuttle");
+		THEN( "each name has a single slot" )
+		{
+			REQUIRE( ConditionsStore::GetSlot("a") == a );
+			REQUIRE( a != c );
+			REQUIRE( ConditionsStore::SlotName(ships) == "ships: Shuttle" );
+		}
+		THEN( "reading a slot gives the same value as reading the name" )
+		{
+			REQUIRE( store.Get(a) == 1 );
+			REQUIRE( store.Get(c) == 0 );
+			REQUIRE( store.Get(ships) == 14 );
+		}
+		WHEN( "conditions are changed, added and removed" )
+		{
+			REQUIRE( store.Get(a) == 1 );
+			REQUIRE( store.Get(c) == 0 );
+			store["a"] = 5;
+			store.Set("c", 3);
+			THEN( "the slots see the changes" )
+			{
+				REQUIRE( store.Get(a) == 5 );
+				REQUIRE( store.Get(c) == 3 );
+				store.Erase("c");
+				REQUIRE( store.Get(c) == 0 );
+			}
+		}
+		WHEN( "the store is copied" )
+		{
+			REQUIRE( store.Get(a) == 1 );
+			auto copy = store;
+			store.Erase("a");
+			THEN( "each copy reads its own conditions" )
+			{
+				REQUIRE( store.Get(a) == 0 );
+				REQUIRE( copy.Get(a) == 1 );
+			}
+		}
+	}
+}
+
 
 // #endregion unit tests
 
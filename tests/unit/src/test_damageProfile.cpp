@@ -0,0 +1,271 @@
+/* test_damageProfile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/DamageProfile.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/DamageDealt.h"
+#include "../../../source/Mask.h"
+#include "../../../source/Outfit.h"
+#include "../../../source/Ship.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// The damage a ship takes, as calculated by looking up every attribute of the
+// ship as it is needed, the way DamageProfile used to.
+class ReferenceDamage {
+public:
+	ReferenceDamage(const Weapon &weapon, const Point &position, const Ship &ship, bool blast)
+	{
+		const Outfit &attributes = ship.Attributes();
+		double scaling = 1.;
+		if(blast && weapon.IsDamageScaled())
+		{
+			double blastRadius = std::max(1., weapon.BlastRadius());
+			double radiusRatio = weapon.TriggerRadius() / blastRadius;
+			double k = !radiusRatio ? 1. : (1. + .25 * radiusRatio * radiusRatio);
+			double rSquared = 1. / (blastRadius * blastRadius);
+			double distance = std::max(0., position.Distance(ship.Position()) - ship.GetMask().Radius());
+			double finalR = distance * distance * rSquared;
+			scaling *= k / ((1. + finalR * finalR) * (1. + finalR * finalR));
+		}
+
+		double shieldFraction = 0.;
+		auto ScaleType = [&](double shieldBlocked, double hullBlocked, double protection)
+		{
+			double blocked = (1. - shieldBlocked) * (shieldFraction) + (1. - hullBlocked) * (1. - shieldFraction);
+			return scaling * blocked / (1. + protection);
+		};
+
+		double shields = ship.ShieldLevel();
+		if(shields > 0.)
+		{
+			double piercing = std::max(0., std::min(1., weapon.Piercing() / (1. + attributes.Get("piercing protection"))
+				- attributes.Get("piercing resistance")));
+			double highPermeability = attributes.Get("high shield permeability");
+			double lowPermeability = attributes.Get("low shield permeability");
+			double permeability = 0.;
+			if(highPermeability || lowPermeability)
+			{
+				double shieldPortion = shields / ship.MaxShields();
+				permeability = std::max((highPermeability * shieldPortion) +
+					(lowPermeability * (1. - shieldPortion)), 0.);
+			}
+			shieldFraction = (1. - std::min(piercing + permeability, 1.)) /
+				(1. + ship.DisruptionLevel() * .01);
+
+			shield = (weapon.ShieldDamage()
+				+ weapon.RelativeShieldDamage() * ship.MaxShields())
+				* ScaleType(0., 0., attributes.Get("shield protection")
+				+ (ship.IsCloaked() ? attributes.Get("cloak shield protection") : 0.));
+			if(shield > shields)
+				shieldFraction = std::min(shieldFraction, shields / shield);
+		}
+
+		shield *= shieldFraction;
+		double totalHullProtection = (ScaleType(1., 0., attributes.Get("hull protection") +
+			(ship.IsCloaked() ? attributes.Get("cloak hull protection") : 0.)));
+		hull = (weapon.HullDamage()
+			+ weapon.RelativeHullDamage() * ship.MaxHull())
+			* totalHullProtection;
+		double hullLeft = ship.HullUntilDisabled();
+		if(hull > hullLeft)
+		{
+			double hullFraction = hullLeft / hull;
+			hull *= hullFraction;
+			hull += (weapon.DisabledDamage()
+				+ weapon.RelativeDisabledDamage() * ship.MaxHull())
+				* totalHullProtection
+				* (1. - hullFraction);
+		}
+		energy = (weapon.EnergyDamage()
+			+ weapon.RelativeEnergyDamage() * attributes.Get("energy capacity"))
+			* ScaleType(.5, 0., attributes.Get("energy protection"));
+		heat = (weapon.HeatDamage()
+			+ weapon.RelativeHeatDamage() * ship.MaximumHeat())
+			* ScaleType(.5, 0., attributes.Get("heat protection"));
+		fuel = (weapon.FuelDamage()
+			+ weapon.RelativeFuelDamage() * attributes.Get("fuel capacity"))
+			* ScaleType(.5, 0., attributes.Get("fuel protection"));
+
+		discharge = weapon.DischargeDamage() * ScaleType(0., .5, attributes.Get("discharge protection"));
+		corrosion = weapon.CorrosionDamage() * ScaleType(1., 0., attributes.Get("corrosion protection"));
+		ion = weapon.IonDamage() * ScaleType(.5, 0., attributes.Get("ion protection"));
+		burn = weapon.BurnDamage() * ScaleType(.5, 0., attributes.Get("burn protection"));
+		leak = weapon.LeakDamage() * ScaleType(1., 0., attributes.Get("leak protection"));
+		slowing = weapon.SlowingDamage() * ScaleType(.5, 0., attributes.Get("slowing protection"));
+		scrambling = weapon.ScramblingDamage() * ScaleType(.5, 0., attributes.Get("scramble protection"));
+		disruption = weapon.DisruptionDamage() * ScaleType(0., .5, attributes.Get("disruption protection"));
+
+		double hitForce = weapon.HitForce() * ScaleType(0., 0., attributes.Get("force protection"));
+		if(hitForce)
+		{
+			Point d = ship.Position() - position;
+			double distance = d.Length();
+			if(distance)
+				force = (hitForce / distance) * d;
+		}
+	}
+
+	// Check that the given damage is exactly the same as this.
+	bool Matches(const DamageDealt &damage) const
+	{
+		return damage.Shield() == shield && damage.Hull() == hull && damage.Energy() == energy
+			&& damage.Heat() == heat && damage.Fuel() == fuel && damage.Discharge() == discharge
+			&& damage.Corrosion() == corrosion && damage.Ion() == ion && damage.Burn() == burn
+			&& damage.Leak() == leak && damage.Slowing() == slowing && damage.Scrambling() == scrambling
+			&& damage.Disruption() == disruption && damage.HitForce().X() == force.X()
+			&& damage.HitForce().Y() == force.Y();
+	}
+
+
+private:
+	double shield = 0.;
+	double hull = 0.;
+	double energy = 0.;
+	double heat = 0.;
+	double fuel = 0.;
+	double discharge = 0.;
+	double corrosion = 0.;
+	double ion = 0.;
+	double burn = 0.;
+	double leak = 0.;
+	double slowing = 0.;
+	double scrambling = 0.;
+	double disruption = 0.;
+	Point force;
+};
+
+// A weapon that deals every kind of damage in a blast.
+Outfit MakeBlastWeapon()
+{
+	Outfit weapon;
+	weapon.Load(AsDataNode("outfit \"Blaster\"\n\tweapon\n\t\t\"blast radius\" 80\n\t\t\"trigger radius\" 20"
+		"\n\t\t\"shield damage\" 120\n\t\t\"hull damage\" 90\n\t\t\"disabled damage\" 30"
+		"\n\t\t\"relative shield damage\" .02\n\t\t\"relative hull damage\" .01\n\t\t\"energy damage\" 40"
+		"\n\t\t\"relative energy damage\" .05\n\t\t\"heat damage\" 300\n\t\t\"fuel damage\" 2"
+		"\n\t\t\"ion damage\" 3\n\t\t\"scrambling damage\" 2\n\t\t\"disruption damage\" 4"
+		"\n\t\t\"slowing damage\" 1\n\t\t\"discharge damage\" 5\n\t\t\"corrosion damage\" 6"
+		"\n\t\t\"leak damage\" .5\n\t\t\"burn damage\" 7\n\t\t\"hit force\" 200\n\t\t\"piercing\" .25"));
+	return weapon;
+}
+
+// Outfits giving ships different kinds of protection. The ships that have them
+// installed point to them, so they must outlive those ships.
+std::vector<Outfit> MakeOutfits()
+{
+	const std::vector<std::string> nodes = {
+		"outfit \"Hull\"\n\thull 1000\n\t\"hull protection\" .2\n\t\"heat protection\" .5",
+		"outfit \"Shield Generator\"\n\tshields 800\n\t\"shield protection\" .3\n\t\"piercing protection\" .4",
+		"outfit \"Plating\"\n\thull 300\n\t\"hull multiplier\" .1\n\t\"threshold percentage\" .3",
+		"outfit \"Permeable\"\n\tshields 200\n\t\"high shield permeability\" .1\n\t\"low shield permeability\" .6",
+		"outfit \"Battery\"\n\t\"energy capacity\" 2000\n\t\"energy protection\" .1\n\t\"ion protection\" .3",
+		"outfit \"Tank\"\n\t\"fuel capacity\" 400\n\t\"fuel protection\" .8\n\t\"leak protection\" .2",
+		"outfit \"Dampener\"\n\t\"force protection\" 1.5\n\t\"piercing resistance\" .1\n\t\"burn protection\" .4",
+		"outfit \"Ward\"\n\t\"discharge protection\" .2\n\t\"corrosion protection\" .3\n\t\"slowing protection\" .6"
+			"\n\t\"scramble protection\" .7\n\t\"disruption protection\" .9",
+	};
+	std::vector<Outfit> outfits(nodes.size());
+	for(size_t i = 0; i < nodes.size(); ++i)
+		outfits[i].Load(AsDataNode(nodes[i]));
+	return outfits;
+}
+
+// Make ships with different outfits, scattered around the origin.
+std::vector<std::shared_ptr<Ship>> MakeShips(const std::vector<Outfit> &outfits, int count)
+{
+	std::vector<std::shared_ptr<Ship>> ships;
+	for(int i = 0; i < count; ++i)
+	{
+		auto ship = std::make_shared<Ship>();
+		for(size_t j = 0; j < outfits.size(); ++j)
+			if((i >> j) & 1)
+				ship->AddOutfit(&outfits[j], 1 + i % 3);
+		ship->Recharge();
+		ship->SetPosition(Point(i * 7. - 100., (i % 5) * 13.));
+		ships.push_back(ship);
+	}
+	return ships;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Calculating blast damage", "[DamageProfile]" ) {
+	GIVEN( "a blast weapon and ships with many kinds of protection" ) {
+		const Outfit weapon = MakeBlastWeapon();
+		const std::vector<Outfit> outfits = MakeOutfits();
+		const Point origin(3., -4.);
+		const DamageProfile profile(Projectile::ImpactInfo(weapon, origin, 0.));
+		const std::vector<std::shared_ptr<Ship>> ships = MakeShips(outfits, 40);
+		std::vector<Ship *> targets;
+		for(const auto &ship : ships)
+			targets.push_back(ship.get());
+		const Ship *hit = targets[5];
+
+		THEN( "each ship takes exactly the damage it used to" ) {
+			for(const Ship *ship : targets)
+			{
+				CHECK( ReferenceDamage(weapon, origin, *ship, true).Matches(profile.CalculateDamage(*ship)) );
+				CHECK( ReferenceDamage(weapon, origin, *ship, false).Matches(profile.CalculateDamage(*ship, true)) );
+			}
+		}
+		THEN( "calculating the damage to all ships at once gives the same results" ) {
+			std::vector<DamageDealt> damage;
+			profile.CalculateDamage(targets, hit, damage);
+			REQUIRE( damage.size() == targets.size() );
+			for(size_t i = 0; i < targets.size(); ++i)
+				CHECK( ReferenceDamage(weapon, origin, *targets[i], targets[i] != hit).Matches(damage[i]) );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark DamageProfile::CalculateDamage", "[!benchmark][DamageProfile]" ) {
+	const Outfit weapon = MakeBlastWeapon();
+	const std::vector<Outfit> outfits = MakeOutfits();
+	const DamageProfile profile(Projectile::ImpactInfo(weapon, Point(), 0.));
+	const std::vector<std::shared_ptr<Ship>> ships = MakeShips(outfits, 200);
+	std::vector<Ship *> targets;
+	for(const auto &ship : ships)
+		targets.push_back(ship.get());
+	std::vector<DamageDealt> damage;
+
+	BENCHMARK( "A blast hitting 200 ships" ) {
+		profile.CalculateDamage(targets, nullptr, damage);
+		return damage.size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
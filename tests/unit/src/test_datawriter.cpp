@@ -21,9 +21,35 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // ... and any system includes needed for the test file.
 #include "../../../source/DataNode.h"
 
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+
 namespace { // test namespace
 
 // #region mock data
+std::string ReadAll(const std::string &path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Write a few hundred lines of nested data.
+void WriteLines(DataWriter &writer)
+{
+	for(int i = 0; i < 100; ++i)
+	{
+		writer.Write("ship", "Ship number " + std::to_string(i));
+		writer.BeginChild();
+		writer.Write("position", i * 1.5, i * -2.75);
+		writer.Write("crew", i);
+		writer.EndChild();
+	}
+}
 // #endregion mock data
 
 
@@ -184,8 +210,105 @@ TEST_CASE( "DataWriter::Write", "[datawriter][write]" ) {
 		}
 	}
 }
+TEST_CASE( "DataWriter::WriteToken", "[datawriter][writetoken]" ) {
+	// The output must be identical to what an ostream with a precision of 8 produces.
+	auto expected = [](const auto &value) {
+		std::ostringstream out;
+		out.precision(8);
+		out << value;
+		return out.str();
+	};
+	auto written = [](const auto &value) {
+		DataWriter writer;
+		writer.WriteToken(value);
+		return writer.SaveToString();
+	};
+	GIVEN( "integers" ) {
+		THEN( "they are written like an ostream would" ) {
+			for(int value : {0, 1, -1, 42, 1000000, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()})
+				CHECK( written(value) == expected(value) );
+			for(int64_t value : {int64_t(0), int64_t(-987654321012), std::numeric_limits<int64_t>::max(),
+					std::numeric_limits<int64_t>::min()})
+				CHECK( written(value) == expected(value) );
+			CHECK( written(std::numeric_limits<uint64_t>::max()) == expected(std::numeric_limits<uint64_t>::max()) );
+			CHECK( written(true) == expected(true) );
+			CHECK( written(false) == expected(false) );
+		}
+	}
+	GIVEN( "floating point numbers" ) {
+		THEN( "they are written like an ostream would" ) {
+			for(double value : {0., -0., 1., -1.5, 0.1, 1. / 3., 123456789., 12345678., 1e-5, 1.23456789e-7, 6.02e23,
+					-2.5e-300, 1e300, 99999999.5, 0.000123456789, std::numeric_limits<double>::max(),
+					std::numeric_limits<double>::min(), std::numeric_limits<double>::infinity()})
+				CHECK( written(value) == expected(value) );
+			for(float value : {0.f, 0.1f, 3.14159265f, -1e10f, 16777217.f})
+				CHECK( written(value) == expected(value) );
+		}
+	}
+	GIVEN( "a mix of tokens" ) {
+		DataWriter writer;
+		writer.Write("ship", "Bulk Freighter", 3, 0.25, -7.125);
+		THEN( "they are separated by single spaces" ) {
+			CHECK( writer.SaveToString() == "ship \"Bulk Freighter\" 3 0.25 -7.125\n" );
+		}
+	}
+}
+
+SCENARIO( "Flushing a DataWriter to its file as it grows", "[datawriter][flush]" ) {
+	GIVEN( "a DataWriter with a flush threshold" ) {
+		const std::string path = (std::filesystem::temp_directory_path() / "es-test-datawriter.txt").string();
+		std::filesystem::remove(path);
+		DataWriter expected;
+		WriteLines(expected);
+		const std::string contents = expected.SaveToString();
+		{
+			DataWriter writer(path, 256);
+			WriteLines(writer);
+			THEN( "it never holds much more than that in memory" ) {
+				REQUIRE( contents.size() > 4 * 256 );
+				CHECK( writer.SaveToString().size() < 256 );
+			}
+		}
+		THEN( "the file is the same as writing it all at once" ) {
+			CHECK( ReadAll(path) == contents );
+		}
+		std::filesystem::remove(path);
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark DataWriter", "[!benchmark][datawriter]" ) {
+	// Something shaped like a large saved game: many ships with many attributes.
+	auto writeSave = [] {
+		DataWriter writer;
+		writer.Write("pilot", "Bobbi", "Bughunter");
+		writer.Write("date", 16, 11, 3013);
+		for(int ship = 0; ship < 300; ++ship)
+		{
+			writer.Write("ship", "Heavy Shuttle");
+			writer.BeginChild();
+			writer.Write("name", "Shuttle number " + std::to_string(ship));
+			writer.Write("attributes");
+			writer.BeginChild();
+			for(int attribute = 0; attribute < 40; ++attribute)
+				writer.Write("attribute_" + std::to_string(attribute), attribute * 17.125 + ship / 3.);
+			writer.EndChild();
+			for(int outfit = 0; outfit < 30; ++outfit)
+				writer.Write("outfit", "Outfit with a long name", outfit);
+			writer.Write("position", ship * 1.5, ship * -2.75);
+			writer.EndChild();
+		}
+		return writer.SaveToString();
+	};
+	BENCHMARK( "DataWriter with a large synthetic save" ) {
+		return writeSave();
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
@@ -0,0 +1,137 @@
+/* test_depreciation.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Depreciation.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Outfit.h"
+#include "../../../source/Ship.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Outfits of different prices, for equipping ships with. The ships and records
+// made from them point to them, so they must outlive those.
+std::vector<Outfit> MakeOutfits()
+{
+	std::vector<Outfit> outfits(12);
+	for(size_t i = 0; i < outfits.size(); ++i)
+		outfits[i].Load(AsDataNode("outfit \"Part " + std::to_string(i) + "\"\n\tcost "
+			+ std::to_string(1000 * (i + 1))));
+	return outfits;
+}
+
+// Ships whose models are not in the game data, so each ship is its own model.
+std::shared_ptr<Ship> MakeShip(const std::vector<Outfit> &outfits, int i)
+{
+	auto ship = std::make_shared<Ship>(AsDataNode("ship \"Model " + std::to_string(i) + "\"\n\tattributes\n\t\tcost "
+		+ std::to_string(10000 * (1 + i % 5))));
+	for(int j = 0; j < 8; ++j)
+		ship->AddOutfit(&outfits[(i + j * 3) % outfits.size()], 1 + (i + j) % 4);
+	return ship;
+}
+
+std::vector<std::shared_ptr<Ship>> MakeFleet(const std::vector<Outfit> &outfits, int count)
+{
+	std::vector<std::shared_ptr<Ship>> fleet;
+	for(int i = 0; i < count; ++i)
+		fleet.push_back(MakeShip(outfits, i));
+	return fleet;
+}
+
+// The depreciation records of a fleet that bought its outfits over time.
+Depreciation MakeRecords(const std::vector<Outfit> &outfits)
+{
+	Depreciation records;
+	records.Init({}, 0);
+	for(int day = 0; day < 500; day += 25)
+		for(const Outfit &outfit : outfits)
+			records.Buy(&outfit, day);
+	return records;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Valuing a changing fleet", "[Depreciation]" ) {
+	GIVEN( "a fleet whose value has been calculated before" ) {
+		const std::vector<Outfit> outfits = MakeOutfits();
+		auto fleet = MakeFleet(outfits, 20);
+		Depreciation depreciation = MakeRecords(outfits);
+		REQUIRE( depreciation.FleetValue(fleet, 600) == depreciation.Value(fleet, 600) );
+		REQUIRE( depreciation.Value(fleet, 600) > depreciation.Value(fleet, 600, true) );
+
+		WHEN( "outfits are added and removed" ) {
+			fleet[3]->AddOutfit(&outfits[0], 5);
+			fleet[7]->AddOutfit(fleet[7]->Outfits().begin()->first, -1);
+			THEN( "the value is the same as counting the fleet again" ) {
+				CHECK( depreciation.FleetValue(fleet, 600) == depreciation.Value(fleet, 600) );
+			}
+		}
+		WHEN( "ships join and leave the fleet" ) {
+			fleet.erase(fleet.begin() + 2);
+			fleet.push_back(MakeShip(outfits, 100));
+			THEN( "the value is the same as counting the fleet again" ) {
+				CHECK( depreciation.FleetValue(fleet, 700) == depreciation.Value(fleet, 700) );
+				fleet.clear();
+				CHECK( depreciation.FleetValue(fleet, 700) == 0 );
+			}
+		}
+		WHEN( "other selections of ships are valued in between" ) {
+			const std::vector<std::shared_ptr<Ship>> selected(fleet.begin() + 5, fleet.begin() + 8);
+			const int64_t selectedValue = depreciation.Value(selected, 600);
+			fleet[6]->AddOutfit(&outfits[1], 2);
+			THEN( "the fleet's value is still the same as counting it again" ) {
+				CHECK( depreciation.Value(selected, 600) > selectedValue );
+				CHECK( depreciation.FleetValue(fleet, 600) == depreciation.Value(fleet, 600) );
+				CHECK( depreciation.Value(selected, 600, true) < depreciation.Value(selected, 600) );
+				CHECK( depreciation.FleetValue(fleet, 600) == depreciation.Value(fleet, 600) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Depreciation::Value", "[!benchmark][depreciation]" ) {
+	const std::vector<Outfit> outfits = MakeOutfits();
+	const auto fleet = MakeFleet(outfits, 300);
+	const Depreciation depreciation = MakeRecords(outfits);
+
+	BENCHMARK( "Valuing a 300 ship fleet every day for 1000 days" ) {
+		int64_t total = 0;
+		for(int day = 0; day < 1000; ++day)
+			total += depreciation.FleetValue(fleet, day);
+		return total;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
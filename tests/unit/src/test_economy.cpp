@@ -0,0 +1,195 @@
+/* test_economy.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Economy.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Planet.h"
+#include "../../../source/Random.h"
+#include "../../../source/System.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+std::vector<Trade::Commodity> MakeCommodities()
+{
+	std::vector<Trade::Commodity> commodities;
+	for(const char *name : {"Food", "Clothing", "Metal", "Plastic", "Equipment", "Medical",
+			"Industrial", "Electronics", "Heavy Metals", "Luxury Goods"})
+		commodities.push_back(Trade::Commodity{name, 100, 1000, {}});
+	return commodities;
+}
+
+// Fill the given set with a galaxy of linked systems. Every system is linked to
+// the next one, so the galaxy is connected, plus a few others further away, and
+// trades in most but not all of the commodities.
+void MakeGalaxy(Set<System> &systems, int count, const std::vector<Trade::Commodity> &commodities)
+{
+	Set<Planet> planets;
+	for(int i = 0; i < count; ++i)
+	{
+		std::string node = "system \"System " + std::to_string(i) + "\"\n\tpos 0 0";
+		for(size_t c = 0; c < commodities.size(); ++c)
+			if((i + c) % 7)
+				node += "\n\ttrade \"" + commodities[c].name + "\" " + std::to_string(200 + 50 * c);
+		systems.Get("System " + std::to_string(i))->Load(AsDataNode(node), planets);
+	}
+	for(int i = 0; i < count; ++i)
+	{
+		System *system = systems.Get("System " + std::to_string(i));
+		system->Link(systems.Get("System " + std::to_string((i + 1) % count)));
+		if(i % 3 == 0)
+			system->Link(systems.Get("System " + std::to_string((i * 37 + 11) % count)));
+	}
+}
+
+// The economy as it used to be stepped, one system and one commodity at a time.
+class ReferenceEconomy {
+public:
+	explicit ReferenceEconomy(const Set<System> &systems) : systems(systems) {}
+
+	void Step(const std::vector<Trade::Commodity> &commodities)
+	{
+		std::map<std::string, bool> isCommodity;
+		for(const Trade::Commodity &commodity : commodities)
+			isCommodity[commodity.name] = true;
+
+		for(const auto &it : systems)
+			for(const auto &cit : isCommodity)
+				if(it.second.HasTrade(cit.first))
+				{
+					double &value = supply[&it.second][cit.first];
+					exports[&it.second][cit.first] = .10 * value;
+					value *= .89;
+					value += Random::Normal() * 2000.;
+				}
+
+		for(const auto &it : systems)
+			for(const Trade::Commodity &commodity : commodities)
+			{
+				const System &system = it.second;
+				if(!system.HasTrade(commodity.name))
+					continue;
+				double value = supply[&system][commodity.name];
+				for(const System *neighbor : system.Links())
+				{
+					double scale = neighbor->Links().size();
+					if(scale)
+						value += exports[neighbor][commodity.name] / scale;
+				}
+				supply[&system][commodity.name] = value;
+			}
+	}
+
+	std::map<const System *, std::map<std::string, double>> supply;
+	std::map<const System *, std::map<std::string, double>> exports;
+
+
+private:
+	const Set<System> &systems;
+};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Stepping the dynamic economy", "[Economy]" ) {
+	const std::vector<Trade::Commodity> commodities = MakeCommodities();
+	Set<System> systems;
+	MakeGalaxy(systems, 60, commodities);
+	Economy economy;
+	economy.Update(systems, commodities);
+	const System *first = systems.Get("System 0");
+
+	GIVEN( "a galaxy of linked systems" ) {
+		THEN( "only traded commodities can have a supply" ) {
+			economy.SetSupply(first, "Clothing", 1000.);
+			economy.SetSupply(first, "Food", 1000.);
+			economy.SetSupply(first, "Unobtainium", 1000.);
+			CHECK( economy.Supply(first, "Clothing") == 1000. );
+			CHECK( economy.Supply(first, "Food") == 0. );
+			CHECK( economy.Supply(first, "Unobtainium") == 0. );
+		}
+		THEN( "stepping matches updating each system in turn" ) {
+			ReferenceEconomy reference(systems);
+			Random::Seed(1234);
+			for(int day = 0; day < 20; ++day)
+				reference.Step(commodities);
+			Random::Seed(1234);
+			economy.Step(20);
+
+			for(const auto &it : systems)
+				for(const Trade::Commodity &commodity : commodities)
+				{
+					const double expected = reference.supply[&it.second][commodity.name];
+					CHECK( economy.Supply(&it.second, commodity.name) == Approx(expected).margin(1e-6) );
+				}
+		}
+		THEN( "the supply is kept when the layout changes" ) {
+			economy.SetSupply(first, "Clothing", 1234.);
+			systems.Get("System 0")->Link(systems.Get("System 30"));
+			economy.Update(systems, commodities);
+			CHECK( economy.Supply(first, "Clothing") == 1234. );
+			economy.Reset();
+			CHECK( economy.Supply(first, "Clothing") == 0. );
+		}
+	}
+}
+
+SCENARIO( "Converting supply into prices", "[Economy]" ) {
+	GIVEN( "an amount of a commodity on hand" ) {
+		THEN( "a larger supply means a lower price" ) {
+			CHECK( Economy::PriceChange(0.) == 0 );
+			CHECK( Economy::PriceChange(20000.) < 0 );
+			CHECK( Economy::PriceChange(-20000.) > 0 );
+			CHECK( Economy::PriceChange(1e9) == -100 );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Economy::Step", "[!benchmark][economy]" ) {
+	// A galaxy more than ten times the size of the one the game ships with.
+	const std::vector<Trade::Commodity> commodities = MakeCommodities();
+	Set<System> systems;
+	MakeGalaxy(systems, 5000, commodities);
+	Economy economy;
+	economy.Update(systems, commodities);
+
+	BENCHMARK( "One day in a 5000 system galaxy" ) {
+		economy.Step();
+	};
+	BENCHMARK( "Thirty days in a 5000 system galaxy" ) {
+		economy.Step(30);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
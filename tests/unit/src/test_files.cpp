@@ -0,0 +1,141 @@
+/* test_files.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Files.h"
+
+// ... and any system includes needed for the test file.
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace { // test namespace
+
+// #region mock data
+std::string ReadAll(const std::string &path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::string TestPath()
+{
+	return (std::filesystem::temp_directory_path() / "es-test-atomic-write.txt").string();
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Writing a file atomically", "[Files][WriteAtomic]" ) {
+	const std::string path = TestPath();
+	std::filesystem::remove(path);
+
+	GIVEN( "no existing file" ) {
+		THEN( "the file is created with the given contents" ) {
+			REQUIRE( Files::WriteAtomic(path, "pilot Bobbi Bughunter\n") );
+			CHECK( ReadAll(path) == "pilot Bobbi Bughunter\n" );
+			CHECK_FALSE( std::filesystem::exists(path + ".tmp") );
+		}
+	}
+	GIVEN( "an existing file" ) {
+		REQUIRE( Files::WriteAtomic(path, "old contents\n") );
+		THEN( "the file is replaced with the new contents" ) {
+			REQUIRE( Files::WriteAtomic(path, "new contents\n") );
+			CHECK( ReadAll(path) == "new contents\n" );
+		}
+	}
+
+#ifndef _WIN32
+	GIVEN( "a writer that is killed in the middle of a save" ) {
+		const std::string oldContents(1 << 12, 'o');
+		const std::string newContents(1 << 16, 'n');
+		THEN( "the file holds either the previous or the new contents, never a mix" ) {
+			for(int delay = 0; delay < 200; delay += 50)
+			{
+				REQUIRE( Files::WriteAtomic(path, oldContents) );
+				pid_t child = fork();
+				REQUIRE( child >= 0 );
+				if(!child)
+				{
+					Files::WriteAtomic(path, newContents);
+					_exit(0);
+				}
+				usleep(delay);
+				kill(child, SIGKILL);
+				waitpid(child, nullptr, 0);
+
+				const std::string contents = ReadAll(path);
+				CHECK( (contents == oldContents || contents == newContents) );
+			}
+		}
+		std::filesystem::remove(path + ".tmp");
+	}
+#endif
+
+	std::filesystem::remove(path);
+}
+
+SCENARIO( "Appending to a file", "[Files][Append]" ) {
+	const std::string path = (std::filesystem::temp_directory_path() / "es-test-append.txt").string();
+	std::filesystem::remove(path);
+
+	GIVEN( "no existing file" ) {
+		THEN( "the file is created with the given contents" ) {
+			Files::Append(path, "session one\n");
+			CHECK( ReadAll(path) == "session one\n" );
+		}
+	}
+	GIVEN( "an existing file" ) {
+		Files::Append(path, "session one\n");
+		THEN( "the data is added after its contents" ) {
+			Files::Append(path, "session two\n");
+			CHECK( ReadAll(path) == "session one\nsession two\n" );
+		}
+	}
+
+	std::filesystem::remove(path);
+}
+
+SCENARIO( "Listing a directory from a manifest", "[Files][AddManifest]" ) {
+	GIVEN( "a manifest for a directory that does not exist on disk" ) {
+		const std::string root = (std::filesystem::temp_directory_path() / "es-test-manifest").string();
+		Files::AddManifest(root, {"data/human/ships.txt", "data/map.txt", "images/icon.png", "plugin.txt"});
+		THEN( "recursive listings come from the manifest" ) {
+			CHECK( Files::RecursiveList(root) == std::vector<std::string>{root + "/data/human/ships.txt",
+				root + "/data/map.txt", root + "/images/icon.png", root + "/plugin.txt"} );
+			CHECK( Files::RecursiveList(root + "/data/") == std::vector<std::string>{
+				root + "/data/human/ships.txt", root + "/data/map.txt"} );
+			CHECK( Files::RecursiveList(root + "/data/human") == std::vector<std::string>{
+				root + "/data/human/ships.txt"} );
+			CHECK( Files::RecursiveList(root + "/sounds/").empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,100 @@
+/* test_histogram.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Histogram.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Finding percentiles of durations", "[Histogram]" ) {
+	GIVEN( "an empty histogram" ) {
+		Histogram histogram;
+		THEN( "every percentile is zero" ) {
+			CHECK( histogram.Count() == 0 );
+			CHECK( histogram.Percentile(.5) == 0. );
+			CHECK( histogram.Max() == 0. );
+		}
+	}
+
+	GIVEN( "durations from 1 to 1000 milliseconds" ) {
+		Histogram histogram;
+		for(int i = 1000; i > 0; --i)
+			histogram.Add(i * .001);
+		REQUIRE( histogram.Count() == 1000 );
+
+		THEN( "each percentile is within the precision of the buckets" ) {
+			CHECK( histogram.Percentile(.5) == Approx(.5).epsilon(.035) );
+			CHECK( histogram.Percentile(.95) == Approx(.95).epsilon(.035) );
+			CHECK( histogram.Percentile(.99) == Approx(.99).epsilon(.035) );
+			CHECK( histogram.Max() == Approx(1.).epsilon(.035) );
+			CHECK( histogram.Percentile(0.) == Approx(.001).epsilon(.035) );
+		}
+		THEN( "percentiles never decrease" ) {
+			double previous = 0.;
+			for(int i = 0; i <= 100; ++i)
+			{
+				const double value = histogram.Percentile(i * .01);
+				CHECK( value >= previous );
+				previous = value;
+			}
+		}
+		WHEN( "it is cleared" ) {
+			histogram.Clear();
+			THEN( "it is empty" ) {
+				CHECK( histogram.Count() == 0 );
+				CHECK( histogram.Max() == 0. );
+			}
+		}
+	}
+
+	GIVEN( "a few very short or very long durations" ) {
+		Histogram histogram;
+		histogram.Add(0.);
+		histogram.Add(-1.);
+		histogram.Add(.000003);
+		histogram.Add(1e9);
+		THEN( "short durations are counted exactly" ) {
+			CHECK( histogram.Percentile(.25) < .000001 );
+			CHECK( histogram.Percentile(.75) == Approx(.0000035) );
+		}
+		THEN( "long durations are counted in the last bucket" ) {
+			CHECK( histogram.Max() > 15. );
+			CHECK( histogram.Max() < 20. );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Histogram::Add", "[!benchmark][histogram]" ) {
+	Histogram histogram;
+	BENCHMARK( "Adding 1000 frame times" ) {
+		for(int i = 0; i < 1000; ++i)
+			histogram.Add(.016 + i * .00001);
+		return histogram.Count();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
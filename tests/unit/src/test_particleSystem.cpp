@@ -0,0 +1,149 @@
+/* test_particleSystem.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ParticleSystem.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Effect.h"
+#include "../../../source/Random.h"
+#include "../../../source/Visual.h"
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+const Effect &Spark()
+{
+	static Effect effect;
+	if(effect.Name().empty())
+		effect.Load(AsDataNode("effect \"spark\"\n\tlifetime 20\n\t\"random lifetime\" 40"
+			"\n\t\"random velocity\" 3\n\t\"random angle\" 180\n\t\"random spin\" 10"));
+	return effect;
+}
+
+std::vector<Visual> MakeVisuals(int count)
+{
+	std::vector<Visual> visuals;
+	for(int i = 0; i < count; ++i)
+		visuals.emplace_back(Spark(), Point(Random::Real() * 1000., Random::Real() * 1000.),
+			Point(Random::Real(), Random::Real()), Angle::Random());
+	return visuals;
+}
+
+// The position and facing of every effect, in a consistent order.
+using State = std::vector<std::tuple<double, double, double>>;
+
+State GetState(const std::vector<Visual> &visuals)
+{
+	State state;
+	for(const Visual &visual : visuals)
+		state.emplace_back(visual.Position().X(), visual.Position().Y(), visual.Facing().Degrees());
+	std::sort(state.begin(), state.end());
+	return state;
+}
+
+State GetState(const ParticleSystem &particles)
+{
+	State state;
+	for(size_t i = 0; i < particles.Size(); ++i)
+		state.emplace_back(particles.Position(i).X(), particles.Position(i).Y(), particles.Facing(i).Degrees());
+	std::sort(state.begin(), state.end());
+	return state;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Stepping a particle system", "[ParticleSystem]" ) {
+	GIVEN( "an empty particle system" ) {
+		ParticleSystem particles;
+		THEN( "stepping it does nothing" ) {
+			particles.Step();
+			CHECK( particles.Size() == 0 );
+		}
+	}
+	GIVEN( "a particle system made from visuals" ) {
+		Random::Seed(45);
+		std::vector<Visual> visuals = MakeVisuals(500);
+		ParticleSystem particles;
+		particles.Add(visuals, 0);
+		REQUIRE( particles.Size() == visuals.size() );
+
+		THEN( "the particles move and expire just like the visuals" ) {
+			for(int step = 0; step < 70; ++step)
+			{
+				for(Visual &visual : visuals)
+					visual.Move();
+				visuals.erase(std::remove_if(visuals.begin(), visuals.end(),
+					[](const Visual &visual) { return visual.ShouldBeRemoved(); }), visuals.end());
+				particles.Step();
+
+				REQUIRE( particles.Size() == visuals.size() );
+				REQUIRE( GetState(particles) == GetState(visuals) );
+			}
+			CHECK( particles.Size() == 0 );
+		}
+		THEN( "more particles can be added as others expire" ) {
+			for(int step = 0; step < 30; ++step)
+				particles.Step();
+			const size_t remaining = particles.Size();
+			CHECK( remaining < visuals.size() );
+			particles.Add(MakeVisuals(10), 30);
+			CHECK( particles.Size() == remaining + 10 );
+			particles.Clear();
+			CHECK( particles.Size() == 0 );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ParticleSystem::Step", "[!benchmark][particlesystem]" ) {
+	// Effects that live long enough that most of them survive the benchmark.
+	static Effect effect;
+	effect.Load(AsDataNode("effect \"smoke\"\n\tlifetime 100000\n\t\"random velocity\" 3\n\t\"random spin\" 10"));
+	std::vector<Visual> visuals;
+	for(int i = 0; i < 100000; ++i)
+		visuals.emplace_back(effect, Point(), Point(), Angle::Random());
+
+	ParticleSystem particles;
+	particles.Add(visuals, 0);
+	BENCHMARK( "Step 100,000 particles" ) {
+		particles.Step();
+	};
+	BENCHMARK( "Move and prune 100,000 visuals" ) {
+		for(Visual &visual : visuals)
+			visual.Move();
+		visuals.erase(std::remove_if(visuals.begin(), visuals.end(),
+			[](const Visual &visual) { return visual.ShouldBeRemoved(); }), visuals.end());
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
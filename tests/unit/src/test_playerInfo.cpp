@@ -0,0 +1,348 @@
+/* test_playerInfo.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/PlayerInfo.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+// Include a helper for capturing & asserting on logged output.
+#include "output-capture.hpp"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/CargoHold.h"
+#include "../../../source/ConditionsStore.h"
+#include "../../../source/Conversation.h"
+#include "../../../source/Date.h"
+#include "../../../source/Files.h"
+#include "../../../source/GameData.h"
+#include "../../../source/GameEvent.h"
+#include "../../../source/Mission.h"
+#include "../../../source/NPC.h"
+#include "../../../source/Outfit.h"
+#include "../../../source/Ship.h"
+#include "../../../source/ShipEvent.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+// A pilot landed on a planet, with the system and planet defined by the save's
+// own changes, so that no game data has to be loaded. Loading it reverts the
+// game data to how it was before any pilot was loaded, and adds the changes.
+// Reverting the game data again afterwards removes them.
+const std::string SAVE = R"(pilot Test Pilot
+date 16 11 3013
+system "Test System"
+planet "Test Planet"
+start "Test Start"
+	system "Test System"
+	planet "Test Planet"
+changes
+	system "Test System"
+		pos 0 0
+		object "Test Planet"
+	planet "Test Planet"
+)";
+
+// The same pilot, with two active missions, a job on the job board, and a
+// mission that is being offered. Each NPC appends its own digit to the "order"
+// condition whenever one of its triggers runs.
+const std::string NPC_SAVE = SAVE + R"(	government "Test Government"
+mission "Alpha"
+	destination "Test Planet"
+	npc
+		government "Test Government"
+		ship "Test Ship"
+			name "Alpha One"
+		on encounter
+			"order" = "order" * 10 + 1
+	npc
+		government "Test Government"
+		ship "Test Ship"
+			name "Alpha Two"
+		on encounter
+			"order" = "order" * 10 + 2
+		on destroy
+			"order" = "order" * 10 + 7
+mission "Bravo"
+	destination "Test Planet"
+	npc
+		government "Test Government"
+		ship "Test Ship"
+			name "Bravo One"
+		on encounter
+			"order" = "order" * 10 + 3
+		on destroy
+			"order" = "order" * 10 + 8
+"available job" "Charlie"
+	job
+	destination "Test Planet"
+	npc
+		government "Test Government"
+		ship "Test Ship"
+			name "Charlie One"
+		on encounter
+			"order" = "order" * 10 + 4
+"available mission" "Delta"
+	destination "Test Planet"
+	npc
+		government "Test Government"
+		ship "Test Ship"
+			name "Delta One"
+		on encounter
+			"order" = "order" * 10 + 5
+)";
+
+// Load the given pilot into the given player. Loading warns about all the
+// game data the save refers to but that was never loaded.
+void LoadLandedPilot(PlayerInfo &player, const std::string &save = SAVE)
+{
+	OutputSink warnings(std::cerr);
+	const std::string path = (std::filesystem::temp_directory_path() / "es-test-pilot.txt").string();
+	std::ofstream(path) << save;
+	player.Load(path);
+	std::filesystem::remove(path);
+}
+
+// Find the mission with the given name in the given list.
+const Mission *FindMission(const std::list<Mission> &missions, const std::string &name)
+{
+	for(const Mission &mission : missions)
+		if(mission.Identifier() == name)
+			return &mission;
+	return nullptr;
+}
+
+// Get the first ship of the given NPC of the given mission.
+std::shared_ptr<Ship> NPCShip(const Mission &mission, int npcIndex)
+{
+	auto it = mission.NPCs().begin();
+	std::advance(it, npcIndex);
+	return it->Ships().front();
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Cached fleet conditions follow changes to the fleet", "[PlayerInfo][ConditionsStore]" ) {
+	GIVEN( "a pilot who is landed" ) {
+		PlayerInfo player;
+		LoadLandedPilot(player);
+		REQUIRE( player.GetPlanet() );
+		const Ship shipModel(AsDataNode("ship \"Test Ship\""));
+		const Ship *model = &shipModel;
+		// The outfit is not in the game data, so conditions that look outfits up
+		// by name never find it. Those are only checked to be recounted.
+		Outfit testOutfit;
+		testOutfit.Load(AsDataNode("outfit \"Test Outfit\"\n\t\"cargo space\" 10"));
+		const Outfit *outfit = &testOutfit;
+		ConditionsStore &conditions = player.Conditions();
+		REQUIRE( conditions.Get("total ships (all)") == 0 );
+
+		THEN( "buying a ship counts it" ) {
+			player.BuyShip(model, "Bought");
+			CHECK( conditions.Get("total ships (all)") == 1 );
+		}
+		THEN( "being given a ship counts it" ) {
+			player.GiftShip(model, "Gifted", "");
+			CHECK( conditions.Get("total ships (all)") == 1 );
+		}
+		THEN( "installing an outfit counts it" ) {
+			player.BuyShip(model, "Bought");
+			REQUIRE( conditions.Get("cargo space") == 0 );
+			player.Ships().back()->AddOutfit(outfit, 2);
+			CHECK( conditions.Get("cargo space") == 20 );
+		}
+		THEN( "changing any cargo recounts it, but only looking at the cargo does not" ) {
+			player.BuyShip(model, "Bought");
+			// Looking at the storage for the first time creates it.
+			player.Storage();
+			const ConditionsStore::DerivedProvider &provider = conditions.GetProviderPrefixed("outfit (cargo): ");
+			int64_t misses = provider.GetCacheStats().misses;
+			auto isRecounted = [&conditions, &provider, &misses]()
+			{
+				conditions.Get("outfit (cargo): Test Outfit");
+				const int64_t before = misses;
+				misses = provider.GetCacheStats().misses;
+				return misses != before;
+			};
+			REQUIRE( isRecounted() );
+			player.Cargo();
+			player.Storage();
+			CHECK_FALSE( isRecounted() );
+
+			player.Cargo().Add(outfit, 3);
+			CHECK( isRecounted() );
+			player.Storage().Add(outfit, 4);
+			CHECK( isRecounted() );
+			player.Ships().back()->Cargo().Add(outfit, 5);
+			CHECK( isRecounted() );
+			CHECK_FALSE( isRecounted() );
+		}
+
+		GameData::Revert();
+	}
+}
+
+SCENARIO( "Saving a pilot in the background", "[PlayerInfo][Save]" ) {
+	GIVEN( "a pilot loaded from the saves folder" ) {
+		// Saving also writes to the config folder, so point it at an empty one.
+		// The resource folder must exist too, though nothing is read from it.
+		const std::filesystem::path root = std::filesystem::temp_directory_path() / "es-test-save";
+		std::filesystem::remove_all(root);
+		for(const char *folder : {"data", "images", "sounds", "config"})
+			std::filesystem::create_directories(root / folder);
+		std::ofstream(root / "credits.txt");
+		const std::string resources = root.string();
+		const std::string config = (root / "config").string();
+		const char *const argv[] = {"tests", "-r", resources.c_str(), "-c", config.c_str(), nullptr};
+		Files::Init(argv);
+
+		const std::string path = Files::Saves() + "Test Pilot.txt";
+		std::ofstream(path) << SAVE;
+		PlayerInfo player;
+		{
+			OutputSink warnings(std::cerr);
+			player.Load(path);
+		}
+		REQUIRE( player.Identifier() == "Test Pilot" );
+
+		WHEN( "it is changed and saved" ) {
+			player.Conditions().Set("saved condition", 42);
+			player.Save();
+			player.WaitForSave();
+			THEN( "the save file loads back with the change" ) {
+				PlayerInfo loaded;
+				OutputSink warnings(std::cerr);
+				loaded.Load(path);
+				CHECK( loaded.FirstName() == "Test" );
+				CHECK( loaded.LastName() == "Pilot" );
+				CHECK( loaded.GetDate() == player.GetDate() );
+				CHECK( loaded.Conditions().Get("saved condition") == 42 );
+				CHECK( Files::Read(Files::Config() + "recent.txt") == path + '\n' );
+			}
+		}
+
+		GameData::Revert();
+		std::filesystem::remove_all(root);
+	}
+}
+
+SCENARIO( "Pending events happen in the order of their dates", "[PlayerInfo][GameEvent]" ) {
+	GIVEN( "events that append their own digit to a condition" ) {
+		PlayerInfo player;
+		LoadLandedPilot(player);
+		auto makeEvent = [](int digit)
+		{
+			return GameEvent(AsDataNode("event\n\t\"order\" = \"order\" * 10 + " + std::to_string(digit)));
+		};
+		const Date today = player.GetDate();
+		const ConditionsStore &conditions = player.Conditions();
+
+		WHEN( "they are added out of order, with some on the same day" ) {
+			player.AddEvent(makeEvent(4), today + 3);
+			player.AddEvent(makeEvent(2), today + 2);
+			player.AddEvent(makeEvent(1), today + 1);
+			player.AddEvent(makeEvent(3), today + 2);
+			player.AddEvent(makeEvent(5), today + 3);
+			THEN( "each day applies that day's events, in the order they were added" ) {
+				OutputSink warnings(std::cerr);
+				player.IncrementDate();
+				CHECK( conditions.Get("order") == 1 );
+				player.IncrementDate();
+				CHECK( conditions.Get("order") == 123 );
+				player.IncrementDate();
+				CHECK( conditions.Get("order") == 12345 );
+				player.IncrementDate();
+				CHECK( conditions.Get("order") == 12345 );
+			}
+		}
+
+		GameData::Revert();
+	}
+}
+
+SCENARIO( "Ship events reach the NPCs the ships belong to", "[PlayerInfo][NPC]" ) {
+	GIVEN( "a pilot with NPCs in active, available, and offered missions" ) {
+		PlayerInfo player;
+		LoadLandedPilot(player, NPC_SAVE);
+		const Mission *alpha = FindMission(player.Missions(), "Alpha");
+		const Mission *bravo = FindMission(player.Missions(), "Bravo");
+		const Mission *charlie = FindMission(player.AvailableJobs(), "Charlie");
+		REQUIRE( alpha );
+		REQUIRE( bravo );
+		REQUIRE( charlie );
+		const std::shared_ptr<Ship> alphaOne = NPCShip(*alpha, 0);
+		const std::shared_ptr<Ship> alphaTwo = NPCShip(*alpha, 1);
+		const std::shared_ptr<Ship> bravoOne = NPCShip(*bravo, 0);
+		const std::shared_ptr<Ship> charlieOne = NPCShip(*charlie, 0);
+		REQUIRE( alphaOne->GetGovernment() );
+
+		const ConditionsStore &conditions = player.Conditions();
+		auto send = [&player](const std::shared_ptr<Ship> &ship, int type)
+		{
+			player.HandleEvent(ShipEvent(nullptr, ship, type), nullptr);
+		};
+
+		THEN( "each NPC only gets the events for its own ships, in order" ) {
+			send(bravoOne, ShipEvent::ENCOUNTER);
+			send(alphaTwo, ShipEvent::ENCOUNTER);
+			send(alphaOne, ShipEvent::ENCOUNTER);
+			CHECK( conditions.Get("order") == 321 );
+		}
+		THEN( "accepting a job routes events to its NPCs" ) {
+			send(charlieOne, ShipEvent::ENCOUNTER);
+			REQUIRE( conditions.Get("order") == 0 );
+			send(alphaOne, ShipEvent::ENCOUNTER);
+			player.AcceptJob(*charlie, nullptr);
+			send(charlieOne, ShipEvent::ENCOUNTER);
+			send(bravoOne, ShipEvent::ENCOUNTER);
+			CHECK( conditions.Get("order") == 143 );
+		}
+		THEN( "removing a mission stops routing events to its NPCs" ) {
+			send(alphaTwo, ShipEvent::ENCOUNTER);
+			player.RemoveMission(Mission::ABORT, *alpha, nullptr);
+			send(alphaTwo, ShipEvent::DESTROY);
+			send(alphaOne, ShipEvent::ENCOUNTER);
+			send(bravoOne, ShipEvent::DESTROY);
+			CHECK( conditions.Get("order") == 28 );
+		}
+		THEN( "accepting an offered mission routes events to its NPCs" ) {
+			REQUIRE_FALSE( FindMission(player.Missions(), "Delta") );
+			send(alphaOne, ShipEvent::ENCOUNTER);
+			player.MissionCallback(Conversation::ACCEPT);
+			const Mission *delta = FindMission(player.Missions(), "Delta");
+			REQUIRE( delta );
+			send(NPCShip(*delta, 0), ShipEvent::ENCOUNTER);
+			send(alphaTwo, ShipEvent::DESTROY);
+			CHECK( conditions.Get("order") == 157 );
+		}
+
+		GameData::Revert();
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,129 @@
+/* test_replay.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Replay.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+Replay MakeReplay()
+{
+	Replay replay;
+	replay.Begin(0x123456789ABCDEF0ull, "pilot Bobbi Bughunter\ndate 16 11 3013\n");
+
+	Replay::Frame keys;
+	keys.step = 3;
+	keys.keys = Command::FORWARD | Command::PRIMARY;
+	keys.command = keys.keys;
+	replay.Add(keys);
+
+	Replay::Frame mouse;
+	mouse.step = 200;
+	mouse.command.SetTurn(-.5);
+	mouse.isMouseTurning = true;
+	mouse.mouse = Point(-120.5, 33.25);
+	replay.Add(mouse);
+
+	Replay::Frame click;
+	click.step = 201;
+	click.hasPointer = true;
+	click.pointer.doClickNextStep = true;
+	click.pointer.hasShift = true;
+	click.pointer.isRightClick = true;
+	click.pointer.groupSelect = 4;
+	click.pointer.clickPoint = Point(10., -20.);
+	click.pointer.clickBox = Rectangle(Point(1., 2.), Point(30., 40.));
+	replay.Add(click);
+
+	replay.SetSteps(500);
+	return replay;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Recording the player's inputs", "[Replay]" ) {
+	GIVEN( "a recording with a few inputs" ) {
+		const Replay replay = MakeReplay();
+		REQUIRE( replay.Steps() == 500 );
+
+		THEN( "steps without inputs are empty" ) {
+			CHECK( replay.Get(1).IsEmpty() );
+			CHECK( replay.Get(1).step == 1 );
+			CHECK_FALSE( replay.Get(3).IsEmpty() );
+			CHECK( replay.Get(100).IsEmpty() );
+			CHECK_FALSE( replay.Get(200).IsEmpty() );
+			CHECK( replay.Get(499).IsEmpty() );
+		}
+
+		WHEN( "it is converted to binary and back" ) {
+			const std::string data = replay.ToString();
+			Replay copy;
+			REQUIRE( copy.FromString(data) );
+
+			THEN( "the seed, save, and steps are the same" ) {
+				CHECK( copy.Seed() == replay.Seed() );
+				CHECK( copy.SaveData() == replay.SaveData() );
+				CHECK( copy.Steps() == replay.Steps() );
+			}
+			THEN( "the inputs are the same" ) {
+				const Replay::Frame keys = copy.Get(3);
+				CHECK( keys.keys == (Command::FORWARD | Command::PRIMARY) );
+				CHECK( keys.command == keys.keys );
+				CHECK_FALSE( keys.isMouseTurning );
+				CHECK_FALSE( keys.hasPointer );
+
+				const Replay::Frame mouse = copy.Get(200);
+				CHECK( mouse.command.Turn() == -.5 );
+				CHECK( mouse.isMouseTurning );
+				CHECK( mouse.mouse.X() == -120.5 );
+				CHECK( mouse.mouse.Y() == 33.25 );
+
+				const Replay::Frame click = copy.Get(201);
+				REQUIRE( click.hasPointer );
+				CHECK( click.pointer == replay.Get(201).pointer );
+				CHECK( click.pointer.groupSelect == 4 );
+				CHECK( click.pointer.isFingerDown == -1 );
+				CHECK( click.pointer != Replay::Pointer() );
+			}
+			THEN( "it takes only a few bytes for each input" ) {
+				CHECK( data.size() < replay.SaveData().size() + 200 );
+			}
+		}
+
+		WHEN( "the data is not a recording" ) {
+			Replay copy = MakeReplay();
+			std::string data = replay.ToString();
+			data.pop_back();
+			THEN( "it is not loaded" ) {
+				CHECK_FALSE( copy.FromString(data) );
+				CHECK( copy.Steps() == 0 );
+				CHECK( copy.SaveData().empty() );
+				CHECK_FALSE( copy.FromString("pilot Bobbi Bughunter\n") );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -19,7 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Set.h"
 
 // ... and any system includes needed for the test file.
+#include <map>
 #include <string>
+#include <vector>
 
 namespace { // test namespace
 // #region mock data
@@ -27,6 +29,14 @@ class T {
 public:
 	int a = 1;
 };
+
+std::vector<std::string> MakeNames(int count)
+{
+	std::vector<std::string> names;
+	for(int i = 0; i < count; ++i)
+		names.push_back("Outfit " + std::to_string(i * 7919 % count));
+	return names;
+}
 // #endregion mock data
 
 
@@ -169,8 +179,103 @@ SCENARIO( "A Set can be reverted to an earlier state", "[Set]" ) {
 		}
 	}
 }
+
+SCENARIO( "A Set keeps its entries in place as it grows", "[Set]" ) {
+	GIVEN( "a Set<T> with many entries" ) {
+		const auto names = MakeNames(1000);
+		auto s = Set<T>{};
+		std::vector<const T *> pointers;
+		for(const auto &name : names)
+		{
+			s.Get(name)->a = name.size();
+			pointers.push_back(s.Find(name));
+		}
+		REQUIRE( s.size() == 1000 );
+
+		THEN( "every entry can still be found at its original address" ) {
+			for(size_t i = 0; i < names.size(); ++i)
+			{
+				CHECK( s.Has(names[i]) );
+				CHECK( s.Find(names[i]) == pointers[i] );
+				CHECK( s.Get(names[i]) == pointers[i] );
+			}
+			CHECK_FALSE( s.Has("Outfit 1000") );
+			CHECK( s.find("Outfit 1000") == s.end() );
+		}
+		THEN( "iterating visits the entries in order of their names" ) {
+			auto sorted = std::map<std::string, int>{};
+			for(const auto &name : names)
+				sorted[name] = name.size();
+			auto it = sorted.begin();
+			for(const auto &entry : s)
+			{
+				REQUIRE( it != sorted.end() );
+				CHECK( entry.first == it->first );
+				CHECK( entry.second.a == it->second );
+				++it;
+			}
+			CHECK( it == sorted.end() );
+		}
+		WHEN( "the Set is copied or moved" ) {
+			auto copy = s;
+			auto moved = std::move(s);
+			THEN( "the copy has its own entries" ) {
+				CHECK( copy.Find(names[10]) != pointers[10] );
+				CHECK( copy.Find(names[10])->a == pointers[10]->a );
+			}
+			THEN( "the moved-to Set has the original entries" ) {
+				CHECK( moved.Find(names[10]) == pointers[10] );
+			}
+			THEN( "the moved-from Set is empty" ) {
+				CHECK( s.empty() );
+				CHECK_FALSE( s.Has(names[10]) );
+			}
+		}
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Set lookups", "[!benchmark][set]" ) {
+	// Roughly how many outfits, ships, and other named objects the game data has.
+	const auto names = MakeNames(5000);
+	auto s = Set<T>{};
+	auto reference = std::map<std::string, T>{};
+	for(const auto &name : names)
+	{
+		s.Get(name);
+		reference[name];
+	}
+
+	BENCHMARK( "Set::Find, 5000 entries" ) {
+		int sum = 0;
+		for(const auto &name : names)
+			sum += s.Find(name)->a;
+		return sum;
+	};
+	BENCHMARK( "std::map::find, 5000 entries" ) {
+		int sum = 0;
+		for(const auto &name : names)
+			sum += reference.find(name)->second.a;
+		return sum;
+	};
+	BENCHMARK( "Set::Get, 5000 new entries" ) {
+		auto loaded = Set<T>{};
+		for(const auto &name : names)
+			loaded.Get(name);
+		return loaded.size();
+	};
+	BENCHMARK( "std::map::operator[], 5000 new entries" ) {
+		auto loaded = std::map<std::string, T>{};
+		for(const auto &name : names)
+			loaded[name];
+		return loaded.size();
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
@@ -0,0 +1,206 @@
+/* test_shipDerivedStats.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ship/ShipDerivedStats.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Outfit.h"
+#include "../../../source/Ship.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Attributes that the derived stats are calculated from.
+const std::vector<std::string> ATTRIBUTES = {
+	"hull repair rate", "delayed hull repair rate", "hull repair multiplier", "hull energy", "delayed hull fuel",
+	"shield generation", "delayed shield generation", "shield energy", "shield heat multiplier",
+	"ion resistance", "ion resistance energy", "burn resistance", "burn resistance heat",
+	"shields", "shield multiplier", "hull", "energy capacity", "fuel capacity", "heat dissipation",
+	"energy generation", "energy consumption", "cooling", "active cooling", "cooling inefficiency",
+	"turning energy", "turning heat", "thrust", "thrusting energy", "reverse thrust",
+	"reverse thrusting fuel", "afterburner thrust", "afterburner heat", "acceleration multiplier"
+};
+
+// Outfits that each change a few random attributes, plus some that, like
+// ammunition, change none that the derived stats use. A ship that has them
+// installed points to them, so they must outlive it.
+std::vector<Outfit> MakeOutfits()
+{
+	std::mt19937 rng(41);
+	std::uniform_int_distribution<size_t> attribute(0, ATTRIBUTES.size() - 1);
+	std::uniform_real_distribution<double> value(0., 10.);
+	std::vector<Outfit> outfits(24);
+	for(size_t i = 0; i < outfits.size(); ++i)
+	{
+		std::string node = "outfit \"Part " + std::to_string(i) + "\"";
+		if(i < 20)
+			for(int j = 0; j < 4; ++j)
+				node += "\n\t\"" + ATTRIBUTES[attribute(rng)] + "\" " + std::to_string(value(rng));
+		else
+			node += "\n\tmass " + std::to_string(value(rng)) + "\n\t\"outfit space\" -1";
+		outfits[i].Load(AsDataNode(node));
+	}
+	return outfits;
+}
+
+// Check if two stats are the same, counting costs per point of a rate of zero,
+// which are not a number, as the same.
+bool Same(double cached, double expected)
+{
+	return cached == expected || (std::isnan(cached) && std::isnan(expected));
+}
+
+// Check that the cached stats match what the ship's update used to calculate
+// from its attributes every frame, before they were cached.
+void CheckFormulas(const Ship &ship)
+{
+	const Outfit &attributes = ship.Attributes();
+	const ShipDerivedStats &stats = ship.DerivedStats();
+
+	const double hullAvailable = (attributes.Get("hull repair rate") + attributes.Get("delayed hull repair rate"))
+		* (1. + attributes.Get("hull repair multiplier"));
+	REQUIRE( Same(stats.hull.rate, hullAvailable) );
+	REQUIRE( Same(stats.hull.energy, (attributes.Get("hull energy") + attributes.Get("delayed hull energy"))
+		* (1. + attributes.Get("hull energy multiplier")) / hullAvailable) );
+	REQUIRE( Same(stats.hull.fuel, (attributes.Get("hull fuel") + attributes.Get("delayed hull fuel"))
+		* (1. + attributes.Get("hull fuel multiplier")) / hullAvailable) );
+	const double hullDuringDelay = attributes.Get("hull repair rate") * (1. + attributes.Get("hull repair multiplier"));
+	REQUIRE( Same(stats.hullDuringDelay.rate, hullDuringDelay) );
+	REQUIRE( Same(stats.hullDuringDelay.energy, attributes.Get("hull energy")
+		* (1. + attributes.Get("hull energy multiplier")) / hullDuringDelay) );
+
+	const double shieldsAvailable = (attributes.Get("shield generation")
+		+ attributes.Get("delayed shield generation")) * (1. + attributes.Get("shield generation multiplier"));
+	REQUIRE( Same(stats.shields.rate, shieldsAvailable) );
+	REQUIRE( Same(stats.shields.energy, (attributes.Get("shield energy") + attributes.Get("delayed shield energy"))
+		* (1. + attributes.Get("shield energy multiplier")) / shieldsAvailable) );
+	REQUIRE( Same(stats.shields.heat, (attributes.Get("shield heat") + attributes.Get("delayed shield heat"))
+		* (1. + attributes.Get("shield heat multiplier")) / shieldsAvailable) );
+
+	const double ionResistance = attributes.Get("ion resistance");
+	REQUIRE( Same(stats.ion.resistance, ionResistance) );
+	REQUIRE( Same(stats.ion.energy, attributes.Get("ion resistance energy") / ionResistance) );
+	const double burnResistance = attributes.Get("burn resistance");
+	REQUIRE( Same(stats.burn.heat, attributes.Get("burn resistance heat") / burnResistance) );
+
+	REQUIRE( Same(stats.maxShields, attributes.Get("shields") * (1 + attributes.Get("shield multiplier"))) );
+	REQUIRE( Same(stats.maxHull, attributes.Get("hull") * (1 + attributes.Get("hull multiplier"))) );
+	REQUIRE( Same(stats.energyCapacity, attributes.Get("energy capacity")) );
+	REQUIRE( Same(stats.fuelCapacity, attributes.Get("fuel capacity")) );
+	REQUIRE( Same(stats.heatDissipation, .001 * attributes.Get("heat dissipation")) );
+	REQUIRE( Same(stats.netEnergy, attributes.Get("energy generation") - attributes.Get("energy consumption")) );
+
+	const double x = attributes.Get("cooling inefficiency");
+	const double coolingEfficiency = 2. + 2. / (1. + exp(x / -2.)) - 4. / (1. + exp(x / -4.));
+	REQUIRE( Same(stats.cooling, coolingEfficiency * attributes.Get("cooling")) );
+	REQUIRE( Same(stats.activeCooling, coolingEfficiency * attributes.Get("active cooling")) );
+
+	REQUIRE( Same(stats.turning.energy, attributes.Get("turning energy")) );
+	REQUIRE( Same(stats.turning.heat, attributes.Get("turning heat")) );
+	REQUIRE( Same(stats.thrusting.energy, attributes.Get("thrusting energy")) );
+	REQUIRE( Same(stats.reverseThrusting.fuel, attributes.Get("reverse thrusting fuel")) );
+	REQUIRE( Same(stats.afterburner.heat, attributes.Get("afterburner heat")) );
+	REQUIRE( Same(stats.thrust, attributes.Get("thrust")) );
+	REQUIRE( Same(stats.reverseThrust, attributes.Get("reverse thrust")) );
+	REQUIRE( Same(stats.afterburnerThrust, attributes.Get("afterburner thrust")) );
+	REQUIRE( Same(stats.accelerationMultiplier, attributes.Get("acceleration multiplier")) );
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Calculating derived ship stats", "[ship][ShipDerivedStats]" ) {
+	GIVEN( "some attributes" ) {
+		Outfit attributes;
+		attributes.Load(AsDataNode("outfit \"Test\"\n\t\"hull repair rate\" 2\n\t\"delayed hull repair rate\" 1"
+			"\n\t\"hull repair multiplier\" 1\n\t\"hull energy\" 3\n\t\"energy generation\" 5"
+			"\n\t\"energy consumption\" 2\n\t\"thrusting energy\" .5"));
+		ShipDerivedStats stats;
+		stats.Calibrate(attributes);
+		THEN( "repairs include the delayed repairs only once the delay is over" ) {
+			CHECK( stats.hull.rate == 6. );
+			CHECK( stats.hullDuringDelay.rate == 4. );
+			CHECK( stats.hull.energy == .5 );
+			CHECK( stats.hullDuringDelay.energy == .75 );
+		}
+		THEN( "rates and costs are combined" ) {
+			CHECK( stats.netEnergy == 3. );
+			CHECK( stats.thrusting.energy == .5 );
+			CHECK( stats.reverseThrusting.energy == 0. );
+			CHECK( stats.coolingEfficiency == 1. );
+		}
+	}
+}
+
+SCENARIO( "Keeping a ship's derived stats up to date", "[ship][ShipDerivedStats]" ) {
+	GIVEN( "a ship whose outfits are changed at random" ) {
+		const std::vector<Outfit> outfits = MakeOutfits();
+		Ship ship;
+		THEN( "the cached stats always match the formulas they replaced" ) {
+			std::mt19937 rng(4141);
+			std::uniform_int_distribution<size_t> index(0, outfits.size() - 1);
+			for(int i = 0; i < 500; ++i)
+			{
+				const Outfit *outfit = &outfits[index(rng)];
+				int count = ship.OutfitCount(outfit);
+				// Remove some or all of the outfit half of the time.
+				if(count && rng() % 2)
+					ship.AddOutfit(outfit, -1 - static_cast<int>(rng() % count));
+				else
+					ship.AddOutfit(outfit, 1 + static_cast<int>(rng() % 3));
+				CheckFormulas(ship);
+			}
+		}
+	}
+}
+SCENARIO( "Finding the outfits that change derived ship stats", "[ship][ShipDerivedStats]" ) {
+	GIVEN( "outfits with a single attribute" ) {
+		THEN( "any attribute the stats are calculated from affects them" ) {
+			for(const std::string &attribute : ATTRIBUTES)
+			{
+				Outfit outfit;
+				outfit.Load(AsDataNode("outfit \"Part\"\n\t\"" + attribute + "\" 1"));
+				CAPTURE( attribute );
+				CHECK( ShipDerivedStats::IsAffectedBy(outfit) );
+			}
+		}
+		THEN( "other attributes do not" ) {
+			for(const char *attribute : {"mass", "outfit space", "cost", "gun ports", "required crew"})
+			{
+				Outfit outfit;
+				outfit.Load(AsDataNode("outfit \"Part\"\n\t\"" + std::string(attribute) + "\" 1"));
+				CAPTURE( attribute );
+				CHECK_FALSE( ShipDerivedStats::IsAffectedBy(outfit) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,100 @@
+/* test_spatialIndex.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/SpatialIndex.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Random.h"
+
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A galaxy-like scattering of points and the segments between nearby ones.
+std::vector<Rectangle> MakeBoxes(int count)
+{
+	std::vector<Rectangle> boxes;
+	std::vector<Point> points;
+	for(int i = 0; i < count; ++i)
+	{
+		points.emplace_back(Random::Real() * 4000. - 2000., Random::Real() * 3000. - 1500.);
+		boxes.emplace_back(points.back(), Point());
+		if(i)
+			boxes.push_back(Rectangle::WithCorners(points.back(), points[Random::Int(i)]));
+	}
+	return boxes;
+}
+
+std::vector<size_t> BruteForce(const std::vector<Rectangle> &boxes, const Rectangle &area)
+{
+	std::vector<size_t> result;
+	for(size_t i = 0; i < boxes.size(); ++i)
+		if(boxes[i].Overlaps(area))
+			result.push_back(i);
+	return result;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding items in an area", "[SpatialIndex]" ) {
+	GIVEN( "an empty index" ) {
+		SpatialIndex index;
+		std::vector<size_t> found = {1, 2, 3};
+		THEN( "nothing is found" ) {
+			index.Query(Rectangle(Point(), Point(100., 100.)), found);
+			CHECK( found.empty() );
+		}
+	}
+	GIVEN( "an index of points and segments" ) {
+		Random::Seed(42);
+		const std::vector<Rectangle> boxes = MakeBoxes(500);
+		SpatialIndex index;
+		index.Build(boxes, 100.);
+
+		THEN( "queries find the same items as checking every item" ) {
+			std::vector<size_t> found;
+			for(int i = 0; i < 200; ++i)
+			{
+				Point center(Random::Real() * 5000. - 2500., Random::Real() * 4000. - 2000.);
+				Point size(Random::Real() * 1000., Random::Real() * 1000.);
+				const Rectangle area(center, size);
+				index.Query(area, found);
+				REQUIRE( found == BruteForce(boxes, area) );
+			}
+		}
+		THEN( "areas covering everything find every item once" ) {
+			std::vector<size_t> found;
+			index.Query(Rectangle(Point(), Point(1e6, 1e6)), found);
+			CHECK( found.size() == boxes.size() );
+		}
+		THEN( "clearing the index removes every item" ) {
+			std::vector<size_t> found;
+			index.Clear();
+			index.Query(Rectangle(Point(), Point(1e6, 1e6)), found);
+			CHECK( found.empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
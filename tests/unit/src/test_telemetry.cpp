@@ -0,0 +1,94 @@
+/* test_telemetry.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Telemetry.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Histogram.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+namespace { // test namespace
+using Phase = Telemetry::Phase;
+
+// #region mock data
+std::string ReadAll(const std::string &path)
+{
+	std::ifstream in(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// Count how many sessions have been written to the given file.
+size_t CountSessions(const std::string &path)
+{
+	const std::string contents = ReadAll(path);
+	size_t count = 0;
+	for(size_t pos = contents.find("session"); pos != std::string::npos; pos = contents.find("session", pos + 1))
+		++count;
+	return count;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Saving telemetry from another thread", "[Telemetry]" ) {
+	GIVEN( "a session with some frames measured" ) {
+		const std::string path = (std::filesystem::temp_directory_path() / "es-test-performance.txt").string();
+		std::filesystem::remove(path);
+		// Start from a clean slate, whatever earlier tests measured.
+		Telemetry::Clear();
+		for(int i = 0; i < 10; ++i)
+		{
+			Telemetry::Add(Phase::DRAW, .005);
+			Telemetry::Add(Phase::FRAME, .016);
+		}
+		REQUIRE( Telemetry::Get(Phase::FRAME).Count() == 10 );
+
+		WHEN( "the session is saved from another thread" ) {
+			std::thread([&path]() { Telemetry::AppendSession(path, "Test Device"); }).join();
+			THEN( "the measurements are only cleared once they are next added to" ) {
+				CHECK( CountSessions(path) == 1 );
+				CHECK( Telemetry::Get(Phase::FRAME).Count() == 10 );
+				Telemetry::Add(Phase::FRAME, .016);
+				CHECK( Telemetry::Get(Phase::FRAME).Count() == 1 );
+				CHECK( Telemetry::Get(Phase::DRAW).Count() == 10 );
+				Telemetry::Add(Phase::DRAW, .005);
+				CHECK( Telemetry::Get(Phase::DRAW).Count() == 1 );
+			}
+			THEN( "saving again before any new frame does not repeat the session" ) {
+				Telemetry::AppendSession(path, "Test Device");
+				CHECK( CountSessions(path) == 1 );
+				Telemetry::Add(Phase::FRAME, .016);
+				Telemetry::AppendSession(path, "Test Device");
+				CHECK( CountSessions(path) == 2 );
+			}
+		}
+
+		std::filesystem::remove(path);
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,213 @@
+/* test_zipArchive.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ZipArchive.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Files.h"
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+void Put2(std::string &out, uint16_t value)
+{
+	out += static_cast<char>(value & 0xFF);
+	out += static_cast<char>(value >> 8);
+}
+
+void Put4(std::string &out, uint32_t value)
+{
+	Put2(out, value & 0xFFFF);
+	Put2(out, value >> 16);
+}
+
+std::string Deflate(const std::string &data)
+{
+	z_stream stream{};
+	deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	std::string out(deflateBound(&stream, data.size()), '\0');
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+	stream.avail_in = data.size();
+	stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+	stream.avail_out = out.size();
+	deflate(&stream, Z_FINISH);
+	out.resize(stream.total_out);
+	deflateEnd(&stream);
+	return out;
+}
+
+// Build a zip file holding the given (name, contents) pairs. Names ending in
+// '/' are stored as directory entries.
+std::string MakeZip(const std::vector<std::pair<std::string, std::string>> &entries, bool compress)
+{
+	std::string local;
+	std::string central;
+	for(const auto &[name, contents] : entries)
+	{
+		uint16_t method = compress && !contents.empty() ? 8 : 0;
+		std::string data = method ? Deflate(contents) : contents;
+		uint32_t crc = crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef *>(contents.data()), contents.size());
+		uint32_t offset = local.size();
+
+		Put4(local, 0x04034b50);
+		Put2(local, 20);
+		Put2(local, 0);
+		Put2(local, method);
+		Put4(local, 0);
+		Put4(local, crc);
+		Put4(local, data.size());
+		Put4(local, contents.size());
+		Put2(local, name.size());
+		Put2(local, 0);
+		local += name;
+		local += data;
+
+		Put4(central, 0x02014b50);
+		Put2(central, 20);
+		Put2(central, 20);
+		Put2(central, 0);
+		Put2(central, method);
+		Put4(central, 0);
+		Put4(central, crc);
+		Put4(central, data.size());
+		Put4(central, contents.size());
+		Put2(central, name.size());
+		Put4(central, 0);
+		Put4(central, 0);
+		Put4(central, 0);
+		Put4(central, offset);
+		central += name;
+	}
+
+	std::string zip = local + central;
+	Put4(zip, 0x06054b50);
+	Put4(zip, 0);
+	Put2(zip, entries.size());
+	Put2(zip, entries.size());
+	Put4(zip, central.size());
+	Put4(zip, local.size());
+	Put2(zip, 0);
+	return zip;
+}
+
+const std::vector<std::pair<std::string, std::string>> PLUGIN = {
+	{"plugin/", ""},
+	{"plugin/plugin.txt", "name \"Zipped Plugin\"\n"},
+	{"plugin/data/ships.txt", "ship \"Bactrian\"\n\tattributes\n\t\tcategory \"Heavy Warship\"\n"},
+	{"plugin/data/outfits/weapons.txt", std::string(10000, 'x')},
+	{"plugin/images/ship/bactrian.png", std::string("\x89PNG\r\n\x1a\n", 8) + std::string(300, '\0')},
+	{"plugin/sounds/empty.wav", ""},
+};
+
+std::string WriteZip(const std::string &name, const std::string &contents)
+{
+	std::string path = (std::filesystem::temp_directory_path() / name).string();
+	std::ofstream(path, std::ios::binary) << contents;
+	return path;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Reading a zip archive", "[ZipArchive]" ) {
+	const bool compress = GENERATE(false, true);
+	GIVEN( (compress ? "an archive with deflated entries" : "an archive with stored entries") ) {
+		const std::string path = WriteZip("es-test-zip-archive.zip", MakeZip(PLUGIN, compress));
+		ZipArchive archive(path);
+		REQUIRE( archive.IsValid() );
+
+		THEN( "every file and directory can be found" ) {
+			CHECK( archive.HasFile("plugin/plugin.txt") );
+			CHECK( archive.HasFile("plugin/sounds/empty.wav") );
+			CHECK_FALSE( archive.HasFile("plugin/missing.txt") );
+			CHECK_FALSE( archive.HasFile("plugin/data") );
+			CHECK( archive.HasDirectory("") );
+			CHECK( archive.HasDirectory("plugin/data") );
+			CHECK( archive.HasDirectory("plugin/data/") );
+			// Directories without entries of their own are still known.
+			CHECK( archive.HasDirectory("plugin/images/ship/") );
+			CHECK_FALSE( archive.HasDirectory("plugin/plugin.txt") );
+		}
+		THEN( "directories are listed like they would be on disk" ) {
+			CHECK( archive.List("plugin/data") == std::vector<std::string>{"plugin/data/ships.txt"} );
+			CHECK( archive.List("plugin/data/", true) == std::vector<std::string>{
+				"plugin/data/outfits/weapons.txt", "plugin/data/ships.txt"} );
+			CHECK( archive.ListDirectories("") == std::vector<std::string>{"plugin/"} );
+			CHECK( archive.ListDirectories("plugin") == std::vector<std::string>{
+				"plugin/data/", "plugin/images/", "plugin/sounds/"} );
+		}
+		THEN( "files are read with their original contents" ) {
+			for(const auto &[name, contents] : PLUGIN)
+				if(name.back() != '/')
+					CHECK( archive.Read(name) == contents );
+			CHECK( archive.Read("plugin/missing.txt").empty() );
+		}
+		std::filesystem::remove(path);
+	}
+	GIVEN( "a file that is not a zip archive" ) {
+		const std::string path = WriteZip("es-test-not-a-zip.zip", std::string(1000, 'z'));
+		THEN( "it is not valid" ) {
+			CHECK_FALSE( ZipArchive(path).IsValid() );
+		}
+		std::filesystem::remove(path);
+	}
+}
+
+SCENARIO( "Mounting a zip archive", "[ZipArchive][Files]" ) {
+	GIVEN( "a mounted archive" ) {
+		const std::string path = WriteZip("es-test-mounted.zip", MakeZip(PLUGIN, true));
+		REQUIRE( Files::MountArchive(path) );
+		const std::string root = path + "/plugin/";
+
+		THEN( "its contents can be found through the file system functions" ) {
+			CHECK( Files::Exists(root + "data/ships.txt") );
+			CHECK( Files::Exists(root + "images") );
+			CHECK_FALSE( Files::Exists(root + "data/missing.txt") );
+			CHECK( Files::List(root) == std::vector<std::string>{root + "plugin.txt"} );
+			CHECK( Files::ListDirectories(path) == std::vector<std::string>{root} );
+			CHECK( Files::RecursiveList(root + "data") == std::vector<std::string>{
+				root + "data/outfits/weapons.txt", root + "data/ships.txt"} );
+		}
+		THEN( "its files can be read and opened like any other" ) {
+			CHECK( Files::Read(root + "data/ships.txt") == PLUGIN[2].second );
+			SDL_RWops *file = Files::Open(root + "data/outfits/weapons.txt");
+			REQUIRE( file );
+			CHECK( Files::Read(file) == PLUGIN[3].second );
+			Files::Close(file);
+			CHECK_FALSE( Files::Open(root + "data/ships.txt", true) );
+		}
+		// The archive stays mounted, but it opens the file again for every
+		// read, so nothing will look for it once the scenario is over.
+		std::filesystem::remove(path);
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
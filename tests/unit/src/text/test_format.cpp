@@ -22,7 +22,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../../source/DataNode.h"
 
 // ... and any system includes needed for the test file.
+#include <map>
 #include <string>
+#include <vector>
 
 namespace { // test namespace
 
@@ -454,6 +456,39 @@ TEST_CASE( "Format::ExpandConditions", "[Format][ExpandConditions]") {
 	}
 }
 
+TEST_CASE( "Format::Template", "[Format][Template]") {
+	const std::map<std::string, std::string> keys = {
+		{ "<first>", "Ada" },
+		{ "<last>", "Lovelace" },
+		{ "<ship>", "Analytical <first>" },
+		{ "<b>", "B" },
+		{ "<>", "empty" },
+	};
+	const std::vector<std::string> sources = {
+		"",
+		"No keys here.",
+		"<first> <last>",
+		"Captain <first> <last> of the <ship>.",
+		"<unknown> stays, <first> does not",
+		"<a <b>",
+		"<first<last>",
+		"<<first>>",
+		"<> and <",
+		"open < without a close",
+		"> before <first>",
+		"<first><first><last>",
+	};
+	for(const std::string &source : sources)
+	{
+		const Format::Template compiled(source);
+		CHECK( compiled.Replace(keys) == Format::Replace(source, keys) );
+		CHECK( compiled.Replace({}) == source );
+	}
+	CHECK( Format::Template("<a <b>").Replace(keys) == "<a B" );
+	CHECK( Format::Template("<<first>>").Replace(keys) == "<Ada>" );
+	CHECK( Format::Template("Captain <first> of the <ship>").Replace(keys) == "Captain Ada of the Analytical <first>" );
+}
+
 // #endregion unit tests
 
 // #region benchmarks
@@ -469,6 +504,24 @@ TEST_CASE( "Benchmark Format::PlayTime", "[!benchmark][format]" ) {
 		return Format::PlayTime(std::numeric_limits<int>::max());
 	};
 }
+TEST_CASE( "Benchmark Format::Template", "[!benchmark][format]" ) {
+	const std::map<std::string, std::string> keys = {
+		{ "<cargo>", "20 tons of Food" },
+		{ "<destination>", "Earth in the Sol system" },
+		{ "<date>", "Mon, 16 Nov 3013" },
+		{ "<payment>", "41,000 credits" },
+	};
+	std::string source;
+	for(int i = 0; i < 10; ++i)
+		source += "Deliver <cargo> to <destination> by <date>. Payment is <payment>. ";
+	const Format::Template compiled(source);
+	BENCHMARK( "Format::Replace() on a long description" ) {
+		return Format::Replace(source, keys);
+	};
+	BENCHMARK( "Format::Template::Replace() on a long description" ) {
+		return compiled.Replace(keys);
+	};
+}
 TEST_CASE( "Benchmark Format::Number", "[!benchmark][format]" ) {
 	BENCHMARK( "Zero" ) {
 		return Format::Number(0.);
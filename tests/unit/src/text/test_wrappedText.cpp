@@ -0,0 +1,151 @@
+/* test_wrappedText.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/text/WrappedText.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../../source/text/alignment.hpp"
+#include "../../../../source/text/Font.h"
+
+#include <cstdint>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// An unloaded font has no glyph images, so every character is just as wide as
+// the kerning between characters (2 pixels), and spaces take no room at all.
+const int GLYPH_WIDTH = 2;
+
+// Count how many wraps hit or missed the layout cache while running the given function.
+template <class F>
+WrappedText::CacheStats CountWraps(F f)
+{
+	const WrappedText::CacheStats before = WrappedText::GetCacheStats();
+	f();
+	const WrappedText::CacheStats after = WrappedText::GetCacheStats();
+	WrappedText::CacheStats result;
+	result.hits = after.hits - before.hits;
+	result.misses = after.misses - before.misses;
+	return result;
+}
+
+// Wrap the text once and report whether the layout was already cached.
+bool IsCached(WrappedText &wrapped, const std::string &text)
+{
+	return CountWraps([&]() { wrapped.Wrap(text); }).hits == 1;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Caching the layout of wrapped text", "[text][WrappedText]" ) {
+	GIVEN( "a text that has been wrapped once" ) {
+		Font font;
+		Font otherFont;
+		const std::string text = "The layout of this text is cached.";
+
+		WrappedText wrapped(font);
+		wrapped.SetWrapWidth(200);
+		wrapped.SetLineHeight(10);
+		wrapped.SetParagraphBreak(0);
+		wrapped.SetTabWidth(8);
+		wrapped.SetAlignment(Alignment::LEFT);
+		const WrappedText::CacheStats first = CountWraps([&]() { wrapped.Wrap(text); });
+		REQUIRE( first.hits + first.misses == 1 );
+
+		WrappedText other = wrapped;
+
+		THEN( "wrapping it again with the same settings finds it in the cache" ) {
+			CHECK( IsCached(wrapped, text) );
+			CHECK( IsCached(other, text) );
+			CHECK( other.Height() == wrapped.Height() );
+			CHECK( other.LongestLineWidth() == wrapped.LongestLineWidth() );
+		}
+		THEN( "changing the font misses the cache" ) {
+			other.SetFont(otherFont);
+			other.SetLineHeight(10);
+			other.SetParagraphBreak(0);
+			other.SetTabWidth(8);
+			CHECK_FALSE( IsCached(other, text) );
+		}
+		THEN( "changing the wrap width misses the cache" ) {
+			other.SetWrapWidth(199);
+			CHECK_FALSE( IsCached(other, text) );
+		}
+		THEN( "changing the tab width misses the cache" ) {
+			other.SetTabWidth(9);
+			CHECK_FALSE( IsCached(other, text) );
+		}
+		THEN( "changing the line height misses the cache" ) {
+			other.SetLineHeight(11);
+			CHECK_FALSE( IsCached(other, text) );
+		}
+		THEN( "changing the paragraph break misses the cache" ) {
+			other.SetParagraphBreak(1);
+			CHECK_FALSE( IsCached(other, text) );
+		}
+		THEN( "changing the alignment misses the cache" ) {
+			other.SetAlignment(Alignment::RIGHT);
+			CHECK_FALSE( IsCached(other, text) );
+		}
+		THEN( "changing the text misses the cache" ) {
+			CHECK_FALSE( IsCached(other, text + " ") );
+			CHECK_FALSE( IsCached(other, "the layout of this text is cached.") );
+		}
+	}
+	GIVEN( "a text that changes every frame" ) {
+		Font font;
+		WrappedText wrapped(font);
+		wrapped.SetWrapWidth(1000);
+		wrapped.SetLineHeight(10);
+		wrapped.SetParagraphBreak(0);
+		wrapped.SetAlignment(Alignment::LEFT);
+
+		THEN( "layouts reused from evicted entries are wrapped from scratch" ) {
+			for(int i = 0; i < 500; ++i)
+			{
+				const std::string word(1 + i % 7, 'x');
+				const std::string number = std::to_string(i);
+				wrapped.Wrap("Frame " + word + " " + number);
+				CHECK( wrapped.Height() == 10 );
+				CHECK( wrapped.LongestLineWidth()
+					== GLYPH_WIDTH * static_cast<int>(5 + word.size() + number.size()) );
+			}
+		}
+		THEN( "a layout that is still in use is not reused" ) {
+			WrappedText kept = wrapped;
+			kept.SetWrapWidth(10);
+			kept.Wrap("aaaa bbbb cccc");
+			const int height = kept.Height();
+			const int width = kept.LongestLineWidth();
+			REQUIRE( height == 30 );
+			for(int i = 0; i < 500; ++i)
+				wrapped.Wrap("Frame " + std::to_string(i));
+			CHECK( kept.Height() == height );
+			CHECK( kept.LongestLineWidth() == width );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,53 @@
+#!/usr/bin/python
+# generate_manifest.py
+# Copyright (c) 2026 by Endless Sky contributors
+#
+# Endless Sky is free software: you can redistribute it and/or modify it under the
+# terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later version.
+#
+# Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+# WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+# PARTICULAR PURPOSE. See the GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License along with
+# this program. If not, see <https://www.gnu.org/licenses/>.
+
+import os
+import sys
+
+# Script that lists every file in a packaged resources directory in "manifest.txt", so that the game can read that
+# instead of scanning the directory at startup (see source/ResourceManifest.h). The manifest is trusted as is, so it
+# must be regenerated whenever the packaged files change.
+#
+# Usage: generate_manifest.py <resources directory>
+
+MANIFEST = "manifest.txt"
+
+
+def quote(token):
+	if '"' in token:
+		return "`" + token + "`"
+	return '"' + token + '"'
+
+
+def generate_manifest(resources):
+	lines = []
+	for root, dirs, files in os.walk(resources, followlinks=True):
+		# Like the game, skip anything whose name begins with a dot.
+		dirs[:] = sorted(name for name in dirs if not name.startswith("."))
+		directory = os.path.relpath(root, resources).replace(os.sep, "/")
+		directory = "" if directory == "." else directory + "/"
+		lines.append("directory " + quote(directory))
+		for name in sorted(files):
+			if not name.startswith(".") and not (directory == "" and name == MANIFEST):
+				lines.append("\t" + quote(name))
+	with open(os.path.join(resources, MANIFEST), "w", encoding="utf-8", newline="\n") as f:
+		f.write("\n".join(lines) + "\n")
+
+
+if __name__ == '__main__':
+	if len(sys.argv) != 2 or not os.path.isdir(sys.argv[1]):
+		print("Usage: " + sys.argv[0] + " <resources directory>")
+		exit(1)
+	generate_manifest(sys.argv[1])